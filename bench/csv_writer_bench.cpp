@@ -0,0 +1,190 @@
+// Rows/sec of the live CSV export: the old CsvExporter::appendReading, which
+// checked, opened, wrote, flushed and closed the file for every reading,
+// against CsvWriter's reused buffer of std::to_chars rows written once it
+// holds flushBytes.
+//
+//   g++ -O2 -std=c++17 bench/csv_writer_bench.cpp -o csv_writer_bench
+//   ./csv_writer_bench [directory for the scratch file]
+//
+// Without Qt, QFileInfo/QFile map to stat/open/write/close and QTextStream's
+// default number output to printf's %g, which is what it produces. Both
+// paths format the timestamp from local time, as QDateTime does.
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <random>
+#include <string>
+#include <vector>
+
+struct Reading {
+    long long timestampMs;
+    int partectorNumber;
+    int partectorDiam;
+    float partectorMass;
+    float grimmValue;
+    float temperature;
+    float humidity;
+    float pressure;
+    float altitude;
+    float latitude;
+    float longitude;
+    int co2;
+    int deviceId;
+};
+
+static const char HEADER[] =
+    "timestamp,partector_number,partector_diam,partector_mass,"
+    "grimm_value,temperature,humidity,pressure,"
+    "altitude,latitude,longitude,co2,device_id\n";
+
+static constexpr size_t FlushBytes = 64 * 1024;  // CsvWriter default
+
+static std::vector<Reading> randomReadings(size_t count)
+{
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> value(0.0f, 1000.0f);
+    std::vector<Reading> readings;
+    for (size_t i = 0; i < count; ++i) {
+        readings.push_back({ 1700000000000LL + (long long)i * 1000, int(rng() % 100000), int(rng() % 300),
+                             value(rng), value(rng), value(rng) / 40, value(rng) / 10, 900 + value(rng) / 10,
+                             value(rng), 47 + value(rng) / 1000, 8 + value(rng) / 1000,
+                             int(400 + rng() % 1000), 0 });
+    }
+    return readings;
+}
+
+static int isoTimestamp(char *out, size_t size, long long timestampMs)
+{
+    const time_t seconds = time_t(timestampMs / 1000);
+    struct tm local;
+    localtime_r(&seconds, &local);
+    return int(strftime(out, size, "%Y-%m-%dT%H:%M:%S", &local));
+}
+
+static void writeAll(int fd, const char *data, size_t size)
+{
+    while (size > 0) {
+        const ssize_t written = ::write(fd, data, size);
+        if (written <= 0) {
+            std::perror("write");
+            std::exit(1);
+        }
+        data += written;
+        size -= size_t(written);
+    }
+}
+
+// Baseline CsvExporter::appendReading, once per reading
+static void oldPath(const std::string &path, const std::vector<Reading> &readings)
+{
+    for (const Reading &r : readings) {
+        struct stat info;
+        const bool needsHeader = ::stat(path.c_str(), &info) != 0 || info.st_size == 0;
+
+        const int fd = ::open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+        if (fd < 0) {
+            std::perror("open");
+            std::exit(1);
+        }
+
+        char row[512];
+        int length = 0;
+        if (needsHeader) {
+            writeAll(fd, HEADER, sizeof(HEADER) - 1);
+        }
+        length += isoTimestamp(row, sizeof(row), r.timestampMs);
+        length += std::snprintf(row + length, sizeof(row) - size_t(length),
+                                ",%d,%d,%g,%g,%g,%g,%g,%g,%g,%g,%d\n",
+                                r.partectorNumber, r.partectorDiam, r.partectorMass, r.grimmValue,
+                                r.temperature, r.humidity, r.pressure, r.altitude, r.latitude,
+                                r.longitude, r.co2);
+        writeAll(fd, row, size_t(length));  // stream.flush()
+        ::close(fd);
+    }
+}
+
+template <typename Number>
+static char *writeNumber(char *out, char *end, Number value)
+{
+    return std::to_chars(out, end, value).ptr;
+}
+
+// CsvWriter: appendCsvRow into the buffer, write at FlushBytes, fsync on close
+static void newPath(const std::string &path, const std::vector<Reading> &readings)
+{
+    const int fd = ::open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+    if (fd < 0) {
+        std::perror("open");
+        std::exit(1);
+    }
+
+    std::string buffer;
+    buffer.reserve(FlushBytes + 512);
+    buffer.append(HEADER, sizeof(HEADER) - 1);
+
+    for (const Reading &r : readings) {
+        char row[512];
+        char *const end = row + sizeof(row);
+        char *p = row + isoTimestamp(row, sizeof(row), r.timestampMs);
+        *p++ = ','; p = writeNumber(p, end, r.partectorNumber);
+        *p++ = ','; p = writeNumber(p, end, r.partectorDiam);
+        *p++ = ','; p = writeNumber(p, end, r.partectorMass);
+        *p++ = ','; p = writeNumber(p, end, r.grimmValue);
+        *p++ = ','; p = writeNumber(p, end, r.temperature);
+        *p++ = ','; p = writeNumber(p, end, r.humidity);
+        *p++ = ','; p = writeNumber(p, end, r.pressure);
+        *p++ = ','; p = writeNumber(p, end, r.altitude);
+        *p++ = ','; p = writeNumber(p, end, r.latitude);
+        *p++ = ','; p = writeNumber(p, end, r.longitude);
+        *p++ = ','; p = writeNumber(p, end, r.co2);
+        *p++ = ','; p = writeNumber(p, end, r.deviceId);
+        *p++ = '\n';
+        buffer.append(row, size_t(p - row));
+
+        if (buffer.size() >= FlushBytes) {
+            writeAll(fd, buffer.data(), buffer.size());
+            buffer.clear();
+        }
+    }
+
+    writeAll(fd, buffer.data(), buffer.size());
+    ::fsync(fd);
+    ::close(fd);
+}
+
+static void run(const char *name, void (*write)(const std::string &, const std::vector<Reading> &),
+                const std::string &path, const std::vector<Reading> &readings)
+{
+    double best = 1e30;
+    for (int run = 0; run < 3; ++run) {
+        std::remove(path.c_str());
+        const auto start = std::chrono::steady_clock::now();
+        write(path, readings);
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    struct stat info;
+    ::stat(path.c_str(), &info);
+    std::printf("%-36s %8zu rows  %8.3f s  %12.0f rows/s  %7.2f us/row  %6.1f MB\n", name, readings.size(),
+                best, readings.size() / best, best / readings.size() * 1e6, info.st_size / 1e6);
+}
+
+int main(int argc, char *argv[])
+{
+    const std::string path = std::string(argc > 1 ? argv[1] : ".") + "/csv_writer_bench.csv";
+    const std::vector<Reading> readings = randomReadings(1000000);
+    const std::vector<Reading> few(readings.begin(), readings.begin() + 50000);
+
+    run("per-row open/write/close (old)", oldPath, path, few);
+    run("buffered to_chars (CsvWriter)", newPath, path, readings);
+
+    std::remove(path.c_str());
+    return 0;
+}
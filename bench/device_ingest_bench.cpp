@@ -0,0 +1,335 @@
+// Readings/sec and GUI-thread cost of reading N devices at once (N = 1, 2, 4).
+// The old DeviceManager drained every device queue on the GUI thread and
+// published each batch to the ReadingBus, whose 100 ms delivery handed it to
+// the database and CSV writers. The current one drains on its ingest thread,
+// hands each batch to the writers from there, and sends the GUI one display
+// batch per frame.
+//
+//   g++ -O2 -std=c++17 -pthread bench/device_ingest_bench.cpp -o device_ingest_bench
+//   ./device_ingest_bench
+//
+// Without Qt, every thread's event loop is a locked queue of posted calls
+// with one repeating timer, which is what a queued invokeMethod and a QTimer
+// come down to. Each device is a reader thread pushing readings into the
+// SPSC queue, 8 per serial read, and posting one wakeup per empty ->
+// non-empty transition as SerialWorker does. The writers only take the
+// batch, as DatabaseWorker::insertReadings and CsvWriter's buffer do; SQLite
+// and formatting cost the same on both paths and are left out. The display
+// side keeps the latest reading per device, for LatestReading and the chart.
+//
+// Two runs per N: paced, every device at a fixed rate, where the figure that
+// matters is GUI-thread CPU time; and saturated, readers pushing as fast as
+// the queue drains, for end-to-end readings/sec. A full reader queue makes
+// the reader wait instead of counting an overflow, so nothing is lost and
+// the rate is the consumers' rate. GUI CPU is the thread's own CPU clock,
+// so it holds on a loaded or single-core machine where wall rates do not
+// scale with N.
+
+#include <time.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct Reading {
+    long long timestampMs = 0;
+    int partectorNumber = 0;
+    int partectorDiam = 0;
+    float partectorMass = 0, grimmValue = 0, temperature = 0, humidity = 0;
+    float pressure = 0, altitude = 0, latitude = 0, longitude = 0;
+    int co2 = 0;
+    int deviceId = 0;
+};
+
+// ReadingBatch: implicitly shared, so a delivery hands over a reference
+using Batch = std::shared_ptr<const std::vector<Reading>>;
+
+template <typename T>
+class Ring
+{
+public:
+    explicit Ring(size_t capacity) : m_slots(capacity) {}
+    bool push(const T &value)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) == m_slots.size())
+            return false;
+        m_slots[head % m_slots.size()] = value;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+    bool pop(T &value)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire))
+            return false;
+        value = m_slots[tail % m_slots.size()];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::vector<T> m_slots;
+    std::atomic<size_t> m_head{ 0 };
+    std::atomic<size_t> m_tail{ 0 };
+};
+
+static double threadCpuMs()
+{
+    timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return double(now.tv_sec) * 1e3 + double(now.tv_nsec) / 1e6;
+}
+
+// A thread's event loop: posted calls in order, plus one optional repeating timer
+class Loop
+{
+public:
+    void post(std::function<void()> call)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_calls.push_back(std::move(call));
+        }
+        m_wake.notify_one();
+    }
+
+    void setTimer(int intervalMs, std::function<void()> timeout)
+    {
+        m_intervalMs = intervalMs;
+        m_timeout = std::move(timeout);
+    }
+
+    void start()
+    {
+        m_thread = std::thread([this]() { run(); });
+    }
+
+    void stop()
+    {
+        post([this]() { m_running = false; });
+        m_thread.join();
+    }
+
+    long long events() const { return m_events; }
+    double cpuMs() const { return m_cpuMs; }
+
+private:
+    void run()
+    {
+        using Clock = std::chrono::steady_clock;
+        auto due = Clock::now() + std::chrono::milliseconds(m_intervalMs);
+        while (m_running) {
+            std::function<void()> call;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                if (m_timeout)
+                    m_wake.wait_until(lock, due, [this]() { return !m_calls.empty(); });
+                else
+                    m_wake.wait(lock, [this]() { return !m_calls.empty(); });
+                if (!m_calls.empty()) {
+                    call = std::move(m_calls.front());
+                    m_calls.pop_front();
+                }
+            }
+            if (call) {
+                ++m_events;
+                call();
+            }
+            if (m_timeout && Clock::now() >= due) {
+                ++m_events;
+                m_timeout();
+                due = Clock::now() + std::chrono::milliseconds(m_intervalMs);
+            }
+        }
+        m_cpuMs = threadCpuMs();
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::deque<std::function<void()>> m_calls;
+    int m_intervalMs = 0;
+    std::function<void()> m_timeout;
+    bool m_running = true;
+    std::thread m_thread;
+    long long m_events = 0;
+    double m_cpuMs = 0;
+};
+
+static constexpr int FramesPerRead = 8;
+static constexpr size_t QueueCapacity = 4096;  // SerialWorker::ReadingQueue
+
+struct Device {
+    explicit Device(int id) : id(id), queue(QueueCapacity) {}
+    int id;
+    Ring<Reading> queue;
+    std::atomic<bool> notifyPending{ false };
+    std::thread reader;
+};
+
+// DatabaseWorker / CsvWriter thread: keeps every batch it is given
+struct Writer {
+    Loop loop;
+    std::vector<Reading> pending;
+    std::atomic<long long> received{ 0 };
+
+    void take(const Batch &batch)
+    {
+        loop.post([this, batch]() {
+            pending.insert(pending.end(), batch->begin(), batch->end());
+            if (pending.size() > 100000)
+                pending.clear();  // Stands in for the flush
+            received.fetch_add((long long)batch->size(), std::memory_order_release);
+        });
+    }
+};
+
+struct Result {
+    double readingsPerSec;
+    double guiCpuMs;
+    long long guiEvents;
+    double ingestCpuMs;
+};
+
+enum Path { OldPath, NewPath };
+
+// perDevice readings from each of n devices; perReadUs > 0 paces every reader
+static Result run(Path path, int n, long long perDevice, int perReadUs)
+{
+    Loop gui;
+    Loop ingest;
+    Writer database;
+    Writer csv;
+    std::vector<std::unique_ptr<Device>> devices;
+    for (int i = 0; i < n; ++i)
+        devices.push_back(std::make_unique<Device>(i + 1));
+
+    // Display: latest reading per device
+    std::vector<Reading> latest(size_t(n) + 1);
+    auto display = [&latest](const std::vector<Reading> &readings) {
+        for (const Reading &reading : readings)
+            latest[size_t(reading.deviceId)] = reading;
+    };
+
+    // ReadingBus: the old path has every subscriber on the 100 ms group
+    std::vector<Reading> busPending;
+    gui.setTimer(100, [&]() {
+        if (busPending.empty())
+            return;
+        auto batch = std::make_shared<const std::vector<Reading>>(std::move(busPending));
+        busPending.clear();
+        if (path == OldPath) {
+            database.take(batch);
+            csv.take(batch);
+        }
+        display(*batch);
+    });
+
+    auto drain = [](Device &device) {
+        device.notifyPending.store(false, std::memory_order_release);
+        std::vector<Reading> batch;
+        Reading reading;
+        while (device.queue.pop(reading))
+            batch.push_back(reading);
+        return batch;
+    };
+
+    // Old: wakeups go to the GUI, which drains and publishes to the bus
+    // New: wakeups go to the ingest thread, which stores and batches for display
+    std::vector<Reading> ingestDisplay;
+    if (path == NewPath) {
+        ingest.setTimer(16, [&]() {
+            if (ingestDisplay.empty())
+                return;
+            auto batch = std::make_shared<const std::vector<Reading>>(std::move(ingestDisplay));
+            ingestDisplay.clear();
+            gui.post([&busPending, batch]() {
+                busPending.insert(busPending.end(), batch->begin(), batch->end());
+            });
+        });
+    }
+    Loop &consumer = path == OldPath ? gui : ingest;
+    std::function<void(Device &)> wakeup = [&](Device &device) {
+        std::vector<Reading> readings = drain(device);
+        if (readings.empty())
+            return;
+        if (path == OldPath) {
+            busPending.insert(busPending.end(), readings.begin(), readings.end());
+        } else {
+            auto batch = std::make_shared<const std::vector<Reading>>(std::move(readings));
+            database.take(batch);
+            csv.take(batch);
+            ingestDisplay.insert(ingestDisplay.end(), batch->begin(), batch->end());
+        }
+    };
+
+    gui.start();
+    ingest.start();
+    database.loop.start();
+    csv.loop.start();
+
+    const auto start = std::chrono::steady_clock::now();
+    for (auto &devicePtr : devices) {
+        Device *device = devicePtr.get();
+        device->reader = std::thread([device, &consumer, &wakeup, perDevice, perReadUs]() {
+            auto next = std::chrono::steady_clock::now();
+            Reading reading;
+            reading.deviceId = device->id;
+            for (long long i = 0; i < perDevice; ++i) {
+                if (perReadUs > 0 && i % FramesPerRead == 0) {
+                    next += std::chrono::microseconds(perReadUs);
+                    std::this_thread::sleep_until(next);
+                }
+                reading.partectorNumber = int(i);
+                while (!device->queue.push(reading))
+                    std::this_thread::yield();
+                if (!device->notifyPending.exchange(true, std::memory_order_acq_rel))
+                    consumer.post([device, &wakeup]() { wakeup(*device); });
+            }
+        });
+    }
+    for (auto &device : devices)
+        device->reader.join();
+
+    const long long total = perDevice * n;
+    while (database.received.load(std::memory_order_acquire) < total
+           || csv.received.load(std::memory_order_acquire) < total)
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    gui.stop();
+    ingest.stop();
+    database.loop.stop();
+    csv.loop.stop();
+    return { double(total) / seconds, gui.cpuMs(), gui.events(), ingest.cpuMs() };
+}
+
+int main()
+{
+    // Paced: 2 s at 20k readings/s per device (one serial read of 8 every 400 us)
+    std::printf("paced, 20k readings/s per device for 2 s\n");
+    for (int n : { 1, 2, 4 }) {
+        const Result before = run(OldPath, n, 40000, 400);
+        const Result after = run(NewPath, n, 40000, 400);
+        std::printf("  N=%d  GUI CPU old %7.1f ms (%6lld events)   new %7.1f ms (%4lld events)"
+                    "   ingest thread %6.1f ms\n",
+                    n, before.guiCpuMs, before.guiEvents, after.guiCpuMs, after.guiEvents, after.ingestCpuMs);
+    }
+
+    std::printf("saturated, 2M readings per device\n");
+    for (int n : { 1, 2, 4 }) {
+        const Result before = run(OldPath, n, 2000000, 0);
+        const Result after = run(NewPath, n, 2000000, 0);
+        std::printf("  N=%d  old %6.2f M readings/s, GUI CPU %7.1f ms   new %6.2f M readings/s, GUI CPU %7.1f ms\n",
+                    n, before.readingsPerSec / 1e6, before.guiCpuMs, after.readingsPerSec / 1e6, after.guiCpuMs);
+    }
+    return 0;
+}
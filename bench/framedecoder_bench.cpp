@@ -0,0 +1,168 @@
+// Frames/sec of FrameDecoder on multi-megabyte synthetic captures, next to
+// the QByteArray indexOf/remove/mid loop it replaced. The real
+// framedecoder.cpp is compiled; bench/shim supplies the few Qt names it uses.
+//
+//   g++ -O2 -std=c++17 -Ibench/shim -Isrc/serial \
+//       bench/framedecoder_bench.cpp src/serial/framedecoder.cpp -o framedecoder_bench
+//
+// The old loop is transcribed with std::string in place of QByteArray: the
+// same append, front search, front erase and one allocated copy per frame.
+
+#include "framedecoder.h"
+#include "crc16.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+
+static constexpr int DataSize = int(sizeof(SensorDataRaw));
+
+static SensorDataRaw randomPayload(std::mt19937 &rng)
+{
+    std::uniform_real_distribution<float> value(0.0f, 1000.0f);
+    SensorDataRaw raw{};
+    raw.partectorNumber = int32_t(rng() % 100000);
+    raw.partectorDiam = int32_t(rng() % 300);
+    raw.partectorMass = value(rng);
+    raw.grimmValue = value(rng);
+    raw.temperature = value(rng) / 40.0f;
+    raw.humidity = value(rng) / 10.0f;
+    raw.pressure = 900.0f + value(rng) / 10.0f;
+    raw.altitude = value(rng);
+    raw.latitude = 47.0f + value(rng) / 1000.0f;
+    raw.longitude = 8.0f + value(rng) / 1000.0f;
+    raw.co2 = uint16_t(400 + rng() % 1000);
+    return raw;
+}
+
+static std::string legacyStream(int frames)
+{
+    std::mt19937 rng(1);
+    std::string stream;
+    stream.reserve(size_t(frames) * (DataSize + 2));
+    for (int i = 0; i < frames; ++i) {
+        const SensorDataRaw raw = randomPayload(rng);
+        stream += '<';
+        stream.append(reinterpret_cast<const char *>(&raw), DataSize);
+        stream += '>';
+    }
+    return stream;
+}
+
+static std::string v2Stream(int frames)
+{
+    std::mt19937 rng(2);
+    std::string stream;
+    for (int i = 0; i < frames; ++i) {
+        const SensorDataRaw raw = randomPayload(rng);
+        unsigned char frame[FrameDecoder::V2MaxFrameSize];
+        frame[0] = FrameDecoder::SyncByte1;
+        frame[1] = FrameDecoder::SyncByte2;
+        frame[2] = FrameDecoder::Version2;
+        frame[3] = uchar(DataSize);
+        frame[4] = uchar(i & 0xFF);
+        frame[5] = uchar((i >> 8) & 0xFF);
+        std::memcpy(frame + 6, &raw, DataSize);
+        const quint16 crc = Crc16::ccitt(frame + 2, size_t(4 + DataSize));
+        frame[6 + DataSize] = uchar(crc & 0xFF);
+        frame[7 + DataSize] = uchar(crc >> 8);
+        stream.append(reinterpret_cast<const char *>(frame), size_t(8 + DataSize));
+    }
+    return stream;
+}
+
+// Baseline SerialHandler::handleReadyRead, one call per read of chunk bytes
+static long long oldDecode(const std::string &stream, size_t chunk)
+{
+    std::string buffer;
+    long long frames = 0;
+    volatile float sink = 0.0f;
+
+    for (size_t offset = 0; offset < stream.size(); offset += chunk) {
+        buffer.append(stream, offset, chunk);  // readAll()
+
+        while (true) {
+            const size_t startIdx = buffer.find('<');
+            if (startIdx == std::string::npos) {
+                buffer.clear();
+                break;
+            }
+            if (startIdx > 0)
+                buffer.erase(0, startIdx);
+            if (buffer.size() < size_t(DataSize + 2))
+                break;
+            const size_t endIdx = buffer.find('>', 1);
+            if (endIdx == std::string::npos)
+                break;
+            if (endIdx - 1 == size_t(DataSize)) {
+                const std::string frame = buffer.substr(1, DataSize);  // mid()
+                SensorDataRaw raw;
+                std::memcpy(&raw, frame.data(), DataSize);
+                sink = sink + raw.temperature;
+                ++frames;
+            }
+            buffer.erase(0, endIdx + 1);
+        }
+    }
+    return frames;
+}
+
+// Current SerialHandler::handleReadyRead: reads land in the ring buffer. A
+// read returns at most chunk bytes and never more than writableSize().
+static long long newDecode(const std::string &stream, size_t chunk)
+{
+    FrameDecoder decoder;
+    long long frames = 0;
+    volatile float sink = 0.0f;
+
+    size_t offset = 0;
+    while (offset < stream.size()) {
+        const size_t bytes = std::min({ chunk, size_t(decoder.writableSize()), stream.size() - offset });
+        std::memcpy(decoder.writePointer(), stream.data() + offset, bytes);
+        decoder.commit(qsizetype(bytes));
+        offset += bytes;
+        frames += decoder.decode([&sink](const SensorDataRaw &raw) { sink = sink + raw.temperature; });
+    }
+    return frames;
+}
+
+// Best of runs, in seconds
+static double bestTime(int runs, const std::function<long long()> &body, long long &frames)
+{
+    double best = 1e30;
+    for (int run = 0; run < runs; ++run) {
+        const auto start = std::chrono::steady_clock::now();
+        frames = body();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+static void report(const char *name, const std::string &stream, size_t chunk,
+                   long long (*decode)(const std::string &, size_t))
+{
+    long long frames = 0;
+    const double seconds = bestTime(5, [&]() { return decode(stream, chunk); }, frames);
+    std::printf("%-34s %8.1f MB  chunk %8zu  %9lld frames  %12.0f frames/s  %8.1f MB/s\n",
+                name, stream.size() / 1e6, chunk, frames, frames / seconds,
+                stream.size() / 1e6 / seconds);
+}
+
+int main()
+{
+    const std::string legacy = legacyStream(200000);       // 8.8 MB
+    const std::string legacyBurst = legacyStream(25000);   // 1.1 MB arriving in one read
+    const std::string v2 = v2Stream(200000);               // 10 MB
+
+    report("old QByteArray loop, legacy", legacy, 4096, oldDecode);
+    report("FrameDecoder, legacy", legacy, 4096, newDecode);
+    report("FrameDecoder, v2 (CRC checked)", v2, 4096, newDecode);
+    report("old QByteArray loop, legacy burst", legacyBurst, legacyBurst.size(), oldDecode);
+    report("FrameDecoder, legacy burst", legacyBurst, legacyBurst.size(), newDecode);
+    return 0;
+}
@@ -0,0 +1,289 @@
+// Readings/sec of hazard evaluation: the old ThresholdManager::computeHazardLevel
+// if/else ladder, called once per reading with nine scalar arguments as the
+// models did, against ThresholdRuleSet::evaluateBatch over the columns of a
+// range load.
+//
+//   g++ -O3 -std=c++17 bench/hazard_eval_bench.cpp -o hazard_eval_bench
+//
+// -O3 matches a CMake Release build; GCC 12 does not vectorize these loops at -O2.
+//
+// thresholdrule.cpp includes the real sensorreading.h (QDateTime), so both
+// evaluators are transcribed here with std::vector in place of QList. The
+// old function is kept out of line, as it was when called through the
+// singleton from another translation unit.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <vector>
+
+using quint8 = std::uint8_t;
+
+enum Sensor {
+    PartectorNumber = 0, PartectorDiam, PartectorMass, GrimmValue,
+    Temperature, Humidity, Pressure, Altitude, Co2, SensorCount
+};
+
+// ReadingColumns' sensor columns
+struct Columns {
+    std::vector<int32_t> partectorNumber;
+    std::vector<int32_t> partectorDiam;
+    std::vector<float> partectorMass;
+    std::vector<float> grimmValue;
+    std::vector<float> temperature;
+    std::vector<float> humidity;
+    std::vector<float> pressure;
+    std::vector<float> altitude;
+    std::vector<int32_t> co2;
+
+    template <typename Visitor>
+    void visitSensor(int sensor, Visitor &&visitor) const
+    {
+        switch (sensor) {
+        case PartectorNumber: visitor(partectorNumber); break;
+        case PartectorDiam:   visitor(partectorDiam); break;
+        case PartectorMass:   visitor(partectorMass); break;
+        case GrimmValue:      visitor(grimmValue); break;
+        case Temperature:     visitor(temperature); break;
+        case Humidity:        visitor(humidity); break;
+        case Pressure:        visitor(pressure); break;
+        case Altitude:        visitor(altitude); break;
+        case Co2:             visitor(co2); break;
+        default: break;
+        }
+    }
+};
+
+struct Settings {
+    bool allEnabled;
+    int co2Warning = 1000, co2Danger = 2000;
+    float temperatureWarning = 30, temperatureDanger = 35, temperatureLowWarning = 15, temperatureLowDanger = 10;
+    float humidityWarning = 60, humidityDanger = 80, humidityLowWarning = 30, humidityLowDanger = 20;
+    float partectorMassWarning = 25, partectorMassDanger = 50;
+    float grimmValueWarning = 25, grimmValueDanger = 50;
+    int partectorNumberWarning = 10000, partectorNumberDanger = 50000;
+    int partectorDiamWarning = 100, partectorDiamDanger = 200;
+    float pressureWarning = 1030, pressureDanger = 1050;
+    float altitudeWarning = 3000, altitudeDanger = 4000;
+};
+
+// Baseline ThresholdManager members and computeHazardLevel
+struct OldManager {
+    enum { Green, Yellow, Red };
+    Settings s;
+    bool m_co2Enabled = true, m_partectorMassEnabled = true, m_grimmValueEnabled = true;
+    bool m_partectorNumberEnabled = true, m_partectorDiamEnabled = true;
+    bool m_temperatureEnabled, m_humidityEnabled, m_pressureEnabled, m_altitudeEnabled;
+
+    explicit OldManager(const Settings &settings)
+        : s(settings), m_temperatureEnabled(settings.allEnabled), m_humidityEnabled(settings.allEnabled),
+          m_pressureEnabled(settings.allEnabled), m_altitudeEnabled(settings.allEnabled) {}
+
+    __attribute__((noinline))
+    int computeHazardLevel(int partectorNumber, int partectorDiam, float partectorMass, float grimmValue,
+                           float temperature, float humidity, float pressure, float altitude, int co2)
+    {
+        int maxLevel = Green;
+        if (m_co2Enabled) {
+            if (co2 >= s.co2Danger) maxLevel = std::max(maxLevel, int(Red));
+            else if (co2 >= s.co2Warning) maxLevel = std::max(maxLevel, int(Yellow));
+        }
+        if (m_temperatureEnabled) {
+            if (temperature >= s.temperatureDanger) maxLevel = std::max(maxLevel, int(Red));
+            else if (temperature >= s.temperatureWarning) maxLevel = std::max(maxLevel, int(Yellow));
+            if (temperature <= s.temperatureLowDanger) maxLevel = std::max(maxLevel, int(Red));
+            else if (temperature <= s.temperatureLowWarning) maxLevel = std::max(maxLevel, int(Yellow));
+        }
+        if (m_humidityEnabled) {
+            if (humidity >= s.humidityDanger) maxLevel = std::max(maxLevel, int(Red));
+            else if (humidity >= s.humidityWarning) maxLevel = std::max(maxLevel, int(Yellow));
+            if (humidity <= s.humidityLowDanger) maxLevel = std::max(maxLevel, int(Red));
+            else if (humidity <= s.humidityLowWarning) maxLevel = std::max(maxLevel, int(Yellow));
+        }
+        if (m_partectorMassEnabled) {
+            if (partectorMass >= s.partectorMassDanger) maxLevel = std::max(maxLevel, int(Red));
+            else if (partectorMass >= s.partectorMassWarning) maxLevel = std::max(maxLevel, int(Yellow));
+        }
+        if (m_grimmValueEnabled) {
+            if (grimmValue >= s.grimmValueDanger) maxLevel = std::max(maxLevel, int(Red));
+            else if (grimmValue >= s.grimmValueWarning) maxLevel = std::max(maxLevel, int(Yellow));
+        }
+        if (m_partectorNumberEnabled) {
+            if (partectorNumber >= s.partectorNumberDanger) maxLevel = std::max(maxLevel, int(Red));
+            else if (partectorNumber >= s.partectorNumberWarning) maxLevel = std::max(maxLevel, int(Yellow));
+        }
+        if (m_partectorDiamEnabled) {
+            if (partectorDiam >= s.partectorDiamDanger) maxLevel = std::max(maxLevel, int(Red));
+            else if (partectorDiam >= s.partectorDiamWarning) maxLevel = std::max(maxLevel, int(Yellow));
+        }
+        if (m_pressureEnabled) {
+            if (pressure >= s.pressureDanger) maxLevel = std::max(maxLevel, int(Red));
+            else if (pressure >= s.pressureWarning) maxLevel = std::max(maxLevel, int(Yellow));
+        }
+        if (m_altitudeEnabled) {
+            if (altitude >= s.altitudeDanger) maxLevel = std::max(maxLevel, int(Red));
+            else if (altitude >= s.altitudeWarning) maxLevel = std::max(maxLevel, int(Yellow));
+        }
+        return maxLevel;
+    }
+};
+
+// ThresholdRule / ThresholdRuleSet
+struct Rule {
+    enum Direction : quint8 { Above, Below };
+    quint8 sensor;
+    Direction direction;
+    double warning;
+    double danger;
+};
+
+template <typename Value>
+static void raiseLevelsAbove(const Value *values, std::ptrdiff_t count, Value warning, Value danger, quint8 *levels)
+{
+    for (std::ptrdiff_t i = 0; i < count; ++i) {
+        // Separate int flags: with the quint8 casts inline GCC keeps a branch per
+        // element on float columns and does not vectorize the loop
+        const int isDanger = values[i] >= danger;
+        const int isWarning = values[i] >= warning;
+        const quint8 level = quint8(std::max(isDanger * 2, isWarning));
+        levels[i] = std::max(levels[i], level);
+    }
+}
+
+template <typename Value>
+static void raiseLevelsBelow(const Value *values, std::ptrdiff_t count, Value warning, Value danger, quint8 *levels)
+{
+    for (std::ptrdiff_t i = 0; i < count; ++i) {
+        const int isDanger = values[i] <= danger;
+        const int isWarning = values[i] <= warning;
+        const quint8 level = quint8(std::max(isDanger * 2, isWarning));
+        levels[i] = std::max(levels[i], level);
+    }
+}
+
+static void evaluateBatch(const std::vector<Rule> &rules, const Columns &columns, std::ptrdiff_t from,
+                          std::ptrdiff_t count, quint8 *levels)
+{
+    std::fill(levels, levels + count, quint8(0));
+    for (const Rule &rule : rules) {
+        columns.visitSensor(rule.sensor, [&](const auto &column) {
+            using Value = typename std::decay_t<decltype(column)>::value_type;
+            const Value *values = column.data() + from;
+            if (rule.direction == Rule::Above)
+                raiseLevelsAbove(values, count, Value(rule.warning), Value(rule.danger), levels);
+            else
+                raiseLevelsBelow(values, count, Value(rule.warning), Value(rule.danger), levels);
+        });
+    }
+}
+
+// ThresholdManager::compileRules
+static std::vector<Rule> compileRules(const Settings &s)
+{
+    std::vector<Rule> rules = {
+        { Co2, Rule::Above, double(s.co2Warning), double(s.co2Danger) },
+        { PartectorMass, Rule::Above, s.partectorMassWarning, s.partectorMassDanger },
+        { GrimmValue, Rule::Above, s.grimmValueWarning, s.grimmValueDanger },
+        { PartectorNumber, Rule::Above, double(s.partectorNumberWarning), double(s.partectorNumberDanger) },
+        { PartectorDiam, Rule::Above, double(s.partectorDiamWarning), double(s.partectorDiamDanger) },
+    };
+    if (s.allEnabled) {
+        rules.push_back({ Temperature, Rule::Above, s.temperatureWarning, s.temperatureDanger });
+        rules.push_back({ Temperature, Rule::Below, s.temperatureLowWarning, s.temperatureLowDanger });
+        rules.push_back({ Humidity, Rule::Above, s.humidityWarning, s.humidityDanger });
+        rules.push_back({ Humidity, Rule::Below, s.humidityLowWarning, s.humidityLowDanger });
+        rules.push_back({ Pressure, Rule::Above, s.pressureWarning, s.pressureDanger });
+        rules.push_back({ Altitude, Rule::Above, s.altitudeWarning, s.altitudeDanger });
+    }
+    return rules;
+}
+
+static Columns randomColumns(size_t rows)
+{
+    // Values straddle the default thresholds, so every branch is taken unpredictably
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    Columns c;
+    for (size_t i = 0; i < rows; ++i) {
+        c.partectorNumber.push_back(int32_t(unit(rng) * 60000));
+        c.partectorDiam.push_back(int32_t(unit(rng) * 250));
+        c.partectorMass.push_back(unit(rng) * 60);
+        c.grimmValue.push_back(unit(rng) * 60);
+        c.temperature.push_back(unit(rng) * 40);
+        c.humidity.push_back(unit(rng) * 100);
+        c.pressure.push_back(1000 + unit(rng) * 60);
+        c.altitude.push_back(unit(rng) * 5000);
+        c.co2.push_back(int32_t(400 + unit(rng) * 2000));
+    }
+    return c;
+}
+
+static double bestSeconds(const std::function<void()> &body)
+{
+    double best = 1e30;
+    for (int run = 0; run < 5; ++run) {
+        const auto start = std::chrono::steady_clock::now();
+        body();
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+int main()
+{
+    constexpr size_t Rows = 1000000;
+    constexpr size_t BlockRows = 4096;
+    const Columns c = randomColumns(Rows);
+    std::vector<quint8> oldLevels(Rows), newLevels(Rows);
+
+    for (bool allEnabled : { false, true }) {
+        Settings settings;
+        settings.allEnabled = allEnabled;
+        OldManager manager(settings);
+        const std::vector<Rule> rules = compileRules(settings);
+
+        const double oldSeconds = bestSeconds([&]() {
+            for (size_t i = 0; i < Rows; ++i) {
+                oldLevels[i] = quint8(manager.computeHazardLevel(
+                    c.partectorNumber[i], c.partectorDiam[i], c.partectorMass[i], c.grimmValue[i],
+                    c.temperature[i], c.humidity[i], c.pressure[i], c.altitude[i], c.co2[i]));
+            }
+        });
+        const double newSeconds = bestSeconds([&]() {
+            evaluateBatch(rules, c, 0, std::ptrdiff_t(Rows), newLevels.data());
+        });
+        if (oldLevels != newLevels) {
+            std::fprintf(stderr, "evaluators disagree\n");
+            return 1;
+        }
+
+        // The same rows in cache-sized blocks, as live batches and chunked loads see them
+        const double blockSeconds = bestSeconds([&]() {
+            for (size_t from = 0; from < Rows; from += BlockRows) {
+                evaluateBatch(rules, c, std::ptrdiff_t(from), std::ptrdiff_t(std::min(BlockRows, Rows - from)),
+                              newLevels.data() + from);
+            }
+        });
+        if (oldLevels != newLevels) {
+            std::fprintf(stderr, "evaluators disagree\n");
+            return 1;
+        }
+
+        std::printf("%s, %zu rules\n", allEnabled ? "all sensors enabled" : "default sensors enabled",
+                    rules.size());
+        const struct { const char *name; double seconds; } results[] = {
+            { "if/else ladder, per reading", oldSeconds },
+            { "evaluateBatch, 1M rows", newSeconds },
+            { "evaluateBatch, 4096-row blocks", blockSeconds },
+        };
+        for (const auto &result : results) {
+            std::printf("  %-32s %7.2f ns/reading %12.0f readings/s  %5.1fx\n", result.name,
+                        result.seconds / Rows * 1e9, Rows / result.seconds, oldSeconds / result.seconds);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,155 @@
+// Sustained inserts/sec into the readings table: the old per-row path
+// (statement prepared per reading, autocommit, default journal settings)
+// against DatabaseWorker's write-behind batches (one cached statement, one
+// transaction per batch). Uses the SQLite C API with the same SQL the Qt
+// code sends, so it runs without Qt.
+//
+//   g++ -O2 -std=c++17 bench/insert_batching_bench.cpp -lsqlite3 -o insert_batching_bench
+//   ./insert_batching_bench [directory for the scratch database]
+//
+// Only the readings insert is measured. flush() also upserts the rollup and
+// day summary rows a batch touches, in the same transaction.
+
+#include <sqlite3.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+static const char *const CREATE_SQL = R"(
+    CREATE TABLE IF NOT EXISTS readings (
+        id INTEGER PRIMARY KEY AUTOINCREMENT,
+        timestamp INTEGER NOT NULL,
+        partectorNumber INTEGER,
+        partectorDiam INTEGER,
+        partectorMass REAL,
+        grimmValue REAL,
+        temperature REAL,
+        humidity REAL,
+        pressure REAL,
+        altitude REAL,
+        latitude REAL,
+        longitude REAL,
+        co2 INTEGER,
+        device_id INTEGER NOT NULL DEFAULT 0
+    );
+    CREATE INDEX IF NOT EXISTS idx_timestamp ON readings(timestamp);
+)";
+
+static const char *const INSERT_SQL = R"(
+    INSERT INTO readings (
+        timestamp, partectorNumber, partectorDiam, partectorMass,
+        grimmValue, temperature, humidity, pressure,
+        altitude, latitude, longitude, co2, device_id
+    ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+)";
+
+static void check(int rc, sqlite3 *db, const char *what)
+{
+    if (rc != SQLITE_OK && rc != SQLITE_DONE && rc != SQLITE_ROW) {
+        std::fprintf(stderr, "%s: %s\n", what, sqlite3_errmsg(db));
+        std::exit(1);
+    }
+}
+
+static sqlite3 *openFresh(const std::string &path, const char *pragmas)
+{
+    std::remove(path.c_str());
+    std::remove((path + "-wal").c_str());
+    std::remove((path + "-shm").c_str());
+    sqlite3 *db = nullptr;
+    check(sqlite3_open(path.c_str(), &db), db, "open");
+    check(sqlite3_exec(db, pragmas, nullptr, nullptr, nullptr), db, "pragmas");
+    check(sqlite3_exec(db, CREATE_SQL, nullptr, nullptr, nullptr), db, "create");
+    return db;
+}
+
+static void bindReading(sqlite3_stmt *stmt, long long i, std::mt19937 &rng)
+{
+    std::uniform_real_distribution<double> value(0.0, 1000.0);
+    sqlite3_bind_int64(stmt, 1, 1700000000000LL + i * 1000);
+    sqlite3_bind_int(stmt, 2, int(rng() % 100000));
+    sqlite3_bind_int(stmt, 3, int(rng() % 300));
+    for (int column = 4; column <= 11; ++column) {
+        sqlite3_bind_double(stmt, column, value(rng));
+    }
+    sqlite3_bind_int(stmt, 12, int(400 + rng() % 1000));
+    sqlite3_bind_int(stmt, 13, 0);
+}
+
+// Baseline DatabaseManager::insertReading: a fresh QSqlQuery per reading
+static double perRow(sqlite3 *db, long long rows)
+{
+    std::mt19937 rng(1);
+    const auto start = std::chrono::steady_clock::now();
+    for (long long i = 0; i < rows; ++i) {
+        sqlite3_stmt *stmt = nullptr;
+        check(sqlite3_prepare_v2(db, INSERT_SQL, -1, &stmt, nullptr), db, "prepare");
+        bindReading(stmt, i, rng);
+        check(sqlite3_step(stmt), db, "insert");
+        sqlite3_finalize(stmt);
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return rows / elapsed.count();
+}
+
+// DatabaseWorker::flush: cached statement, one transaction per batch
+static double batched(sqlite3 *db, long long rows, int batchSize)
+{
+    std::mt19937 rng(1);
+    sqlite3_stmt *stmt = nullptr;
+    check(sqlite3_prepare_v2(db, INSERT_SQL, -1, &stmt, nullptr), db, "prepare");
+
+    const auto start = std::chrono::steady_clock::now();
+    for (long long i = 0; i < rows; i += batchSize) {
+        check(sqlite3_exec(db, "BEGIN", nullptr, nullptr, nullptr), db, "begin");
+        for (long long j = i; j < i + batchSize && j < rows; ++j) {
+            bindReading(stmt, j, rng);
+            check(sqlite3_step(stmt), db, "insert");
+            sqlite3_reset(stmt);
+        }
+        check(sqlite3_exec(db, "COMMIT", nullptr, nullptr, nullptr), db, "commit");
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    sqlite3_finalize(stmt);
+    return rows / elapsed.count();
+}
+
+int main(int argc, char *argv[])
+{
+    const std::string path = std::string(argc > 1 ? argv[1] : ".") + "/insert_batching_bench.db";
+
+    // SQLite defaults, which the old code never changed
+    const char *const defaults = "PRAGMA journal_mode=DELETE; PRAGMA synchronous=FULL;";
+    const char *const walFull = "PRAGMA journal_mode=WAL; PRAGMA synchronous=FULL;";
+    const char *const walNormal = "PRAGMA journal_mode=WAL; PRAGMA synchronous=NORMAL;";
+
+    struct Case {
+        const char *name;
+        const char *pragmas;
+        long long rows;
+        int batchSize;  // 0 = per-row path
+    };
+    const Case cases[] = {
+        { "per-row, DELETE/FULL (old)", defaults, 2000, 0 },
+        { "per-row, WAL/NORMAL", walNormal, 20000, 0 },
+        { "batch 200, DELETE/FULL", defaults, 200000, 200 },
+        { "batch 200, WAL/FULL", walFull, 200000, 200 },
+        { "batch 200, WAL/NORMAL (default)", walNormal, 200000, 200 },
+        { "batch 1000, WAL/NORMAL", walNormal, 200000, 1000 },
+    };
+
+    for (const Case &c : cases) {
+        sqlite3 *db = openFresh(path, c.pragmas);
+        const double rate = c.batchSize == 0 ? perRow(db, c.rows) : batched(db, c.rows, c.batchSize);
+        sqlite3_close(db);
+        std::printf("%-34s %8lld rows  %12.0f inserts/s\n", c.name, c.rows, rate);
+    }
+
+    std::remove(path.c_str());
+    std::remove((path + "-wal").c_str());
+    std::remove((path + "-shm").c_str());
+    return 0;
+}
@@ -0,0 +1,240 @@
+// 1M-row range load: the old QVariantMap-per-row result, unpacked again by
+// string key in the models, against the ReadingColumns fill that replaced
+// it. Rows come from a real SQLite database through the C API, the same
+// SELECT DatabaseWorker runs.
+//
+//   g++ -O2 -std=c++17 bench/range_load_bench.cpp -lsqlite3 -o range_load_bench
+//   ./range_load_bench [directory for the scratch database]
+//
+// Without Qt, QVariantMap is modelled as an ordered map from UTF-16 string
+// to a variant, like QMap<QString, QVariant>. As with QString, keys longer
+// than the small-string buffer allocate.
+
+#include <sqlite3.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <string>
+#include <variant>
+#include <vector>
+
+using Variant = std::variant<long long, int, double>;
+using VariantMap = std::map<std::u16string, Variant>;
+using VariantList = std::vector<VariantMap>;
+
+static constexpr long long ROWS = 1000000;
+
+static const char16_t *const KEYS[] = {
+    u"id", u"timestamp", u"partectorNumber", u"partectorDiam", u"partectorMass",
+    u"grimmValue", u"temperature", u"humidity", u"pressure",
+    u"altitude", u"latitude", u"longitude", u"co2"
+};
+
+// ReadingColumns, minus the QList wrapper
+struct Columns {
+    std::vector<long long> ids;
+    std::vector<long long> timestamps;
+    std::vector<int> partectorNumber;
+    std::vector<int> partectorDiam;
+    std::vector<float> partectorMass;
+    std::vector<float> grimmValue;
+    std::vector<float> temperature;
+    std::vector<float> humidity;
+    std::vector<float> pressure;
+    std::vector<float> altitude;
+    std::vector<float> latitude;
+    std::vector<float> longitude;
+    std::vector<int> co2;
+    std::vector<int> deviceIds;
+
+    void reserve(size_t rows)
+    {
+        ids.reserve(rows); timestamps.reserve(rows); partectorNumber.reserve(rows);
+        partectorDiam.reserve(rows); partectorMass.reserve(rows); grimmValue.reserve(rows);
+        temperature.reserve(rows); humidity.reserve(rows); pressure.reserve(rows);
+        altitude.reserve(rows); latitude.reserve(rows); longitude.reserve(rows);
+        co2.reserve(rows); deviceIds.reserve(rows);
+    }
+};
+
+static void check(int rc, sqlite3 *db, const char *what)
+{
+    if (rc != SQLITE_OK && rc != SQLITE_DONE && rc != SQLITE_ROW) {
+        std::fprintf(stderr, "%s: %s\n", what, sqlite3_errmsg(db));
+        std::exit(1);
+    }
+}
+
+static void populate(sqlite3 *db)
+{
+    check(sqlite3_exec(db, R"(
+        CREATE TABLE readings (
+            id INTEGER PRIMARY KEY AUTOINCREMENT, timestamp INTEGER NOT NULL,
+            partectorNumber INTEGER, partectorDiam INTEGER, partectorMass REAL,
+            grimmValue REAL, temperature REAL, humidity REAL, pressure REAL,
+            altitude REAL, latitude REAL, longitude REAL, co2 INTEGER,
+            device_id INTEGER NOT NULL DEFAULT 0);
+        CREATE INDEX idx_timestamp ON readings(timestamp);
+        BEGIN;
+    )", nullptr, nullptr, nullptr), db, "create");
+
+    sqlite3_stmt *stmt = nullptr;
+    check(sqlite3_prepare_v2(db,
+        "INSERT INTO readings (timestamp, partectorNumber, partectorDiam, partectorMass, grimmValue, "
+        "temperature, humidity, pressure, altitude, latitude, longitude, co2) "
+        "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)", -1, &stmt, nullptr), db, "prepare");
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> value(0.0, 1000.0);
+    for (long long i = 0; i < ROWS; ++i) {
+        sqlite3_bind_int64(stmt, 1, 1700000000000LL + i * 1000);
+        sqlite3_bind_int(stmt, 2, int(rng() % 100000));
+        sqlite3_bind_int(stmt, 3, int(rng() % 300));
+        for (int column = 4; column <= 11; ++column)
+            sqlite3_bind_double(stmt, column, value(rng));
+        sqlite3_bind_int(stmt, 12, int(400 + rng() % 1000));
+        check(sqlite3_step(stmt), db, "insert");
+        sqlite3_reset(stmt);
+    }
+    sqlite3_finalize(stmt);
+    check(sqlite3_exec(db, "COMMIT", nullptr, nullptr, nullptr), db, "commit");
+}
+
+static sqlite3_stmt *rangeQuery(sqlite3 *db)
+{
+    sqlite3_stmt *stmt = nullptr;
+    check(sqlite3_prepare_v2(db, R"(
+        SELECT id, timestamp, partectorNumber, partectorDiam, partectorMass,
+               grimmValue, temperature, humidity, pressure,
+               altitude, latitude, longitude, co2, device_id
+        FROM readings
+        WHERE timestamp BETWEEN ? AND ?
+        ORDER BY timestamp ASC
+    )", -1, &stmt, nullptr), db, "prepare");
+    sqlite3_bind_int64(stmt, 1, 0);
+    sqlite3_bind_int64(stmt, 2, 1LL << 62);
+    return stmt;
+}
+
+static double seconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Stepping the rows and reading every column, no result building
+static double queryOnly(sqlite3 *db)
+{
+    const auto start = std::chrono::steady_clock::now();
+    sqlite3_stmt *stmt = rangeQuery(db);
+    volatile double sink = 0;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        for (int column = 0; column < 14; ++column)
+            sink = sink + sqlite3_column_double(stmt, column);
+    }
+    sqlite3_finalize(stmt);
+    return seconds(start);
+}
+
+// Old getReadingsInRange plus the chart and map models reading every field
+// back by key
+static double variantPath(sqlite3 *db)
+{
+    const auto start = std::chrono::steady_clock::now();
+    sqlite3_stmt *stmt = rangeQuery(db);
+    VariantList list;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        VariantMap map;
+        map[KEYS[0]] = sqlite3_column_int64(stmt, 0);
+        map[KEYS[1]] = sqlite3_column_int64(stmt, 1);
+        map[KEYS[2]] = sqlite3_column_int(stmt, 2);
+        map[KEYS[3]] = sqlite3_column_int(stmt, 3);
+        for (int column = 4; column <= 11; ++column)
+            map[KEYS[column]] = sqlite3_column_double(stmt, column);
+        map[KEYS[12]] = sqlite3_column_int(stmt, 12);
+        list.push_back(std::move(map));
+    }
+    sqlite3_finalize(stmt);
+
+    volatile double sink = 0;
+    for (const VariantMap &map : list) {
+        for (const char16_t *key : KEYS) {
+            const Variant &v = map.at(key);
+            sink = sink + std::visit([](auto x) { return double(x); }, v);
+        }
+    }
+    return seconds(start);
+}
+
+// DatabaseWorker::readingColumnsInRange
+static double columnPath(sqlite3 *db)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    sqlite3_stmt *count = nullptr;
+    check(sqlite3_prepare_v2(db, "SELECT COUNT(*) FROM readings WHERE timestamp BETWEEN ? AND ?",
+                             -1, &count, nullptr), db, "prepare");
+    sqlite3_bind_int64(count, 1, 0);
+    sqlite3_bind_int64(count, 2, 1LL << 62);
+    sqlite3_step(count);
+    Columns c;
+    c.reserve(size_t(sqlite3_column_int64(count, 0)));
+    sqlite3_finalize(count);
+
+    sqlite3_stmt *stmt = rangeQuery(db);
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        c.ids.push_back(sqlite3_column_int64(stmt, 0));
+        c.timestamps.push_back(sqlite3_column_int64(stmt, 1));
+        c.partectorNumber.push_back(sqlite3_column_int(stmt, 2));
+        c.partectorDiam.push_back(sqlite3_column_int(stmt, 3));
+        c.partectorMass.push_back(float(sqlite3_column_double(stmt, 4)));
+        c.grimmValue.push_back(float(sqlite3_column_double(stmt, 5)));
+        c.temperature.push_back(float(sqlite3_column_double(stmt, 6)));
+        c.humidity.push_back(float(sqlite3_column_double(stmt, 7)));
+        c.pressure.push_back(float(sqlite3_column_double(stmt, 8)));
+        c.altitude.push_back(float(sqlite3_column_double(stmt, 9)));
+        c.latitude.push_back(float(sqlite3_column_double(stmt, 10)));
+        c.longitude.push_back(float(sqlite3_column_double(stmt, 11)));
+        c.co2.push_back(sqlite3_column_int(stmt, 12));
+        c.deviceIds.push_back(sqlite3_column_int(stmt, 13));
+    }
+    sqlite3_finalize(stmt);
+
+    // The models use the columns as they are
+    volatile double sink = c.temperature.back();
+    (void)sink;
+    return seconds(start);
+}
+
+int main(int argc, char *argv[])
+{
+    const std::string path = std::string(argc > 1 ? argv[1] : ".") + "/range_load_bench.db";
+    std::remove(path.c_str());
+
+    sqlite3 *db = nullptr;
+    check(sqlite3_open(path.c_str(), &db), db, "open");
+    populate(db);
+    queryOnly(db);  // Warm the page cache
+
+    struct Case {
+        const char *name;
+        double (*run)(sqlite3 *);
+    };
+    const Case cases[] = {
+        { "query only (lower bound)", queryOnly },
+        { "QVariantMap rows + key unpack", variantPath },
+        { "ReadingColumns", columnPath },
+    };
+    for (const Case &c : cases) {
+        double best = 1e30;
+        for (int run = 0; run < 3; ++run)
+            best = std::min(best, c.run(db));
+        std::printf("%-32s %8.3f s  %12.0f rows/s\n", c.name, best, ROWS / best);
+    }
+
+    sqlite3_close(db);
+    std::remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,268 @@
+// Per-reading cost of creating a SensorReading and carrying it from the
+// reader thread to the GUI: construction from a decoded frame, push and pop
+// through the SPSC queue, appending to a batch and copying the batch for a
+// queued signal. The old reading (a QDateTime member stamped with
+// currentDateTime() per reading) against the current trivially copyable one
+// (UTC msecs taken once per serial read).
+//
+//   g++ -O2 -std=c++17 bench/reading_copy_bench.cpp -o reading_copy_bench
+//
+// Without Qt, QDateTime is modelled on Qt 6's: one word that is either
+// inline "short" data or a pointer to shared data, with a copy constructor
+// and destructor that test which. currentDateTime() is modelled as
+// clock_gettime plus the localtime_r conversion QDateTime runs for
+// Qt::LocalTime. Readings here stay in short form, so the model favours the
+// old reading; time zone rules with transitions make the real one slower.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+#pragma pack(push, 1)
+struct SensorDataRaw {
+    int32_t partectorNumber;
+    int32_t partectorDiam;
+    float partectorMass;
+    float grimmValue;
+    float temperature;
+    float humidity;
+    float pressure;
+    float altitude;
+    float latitude;
+    float longitude;
+    uint16_t co2;
+};
+#pragma pack(pop)
+
+// Qt 6 QDateTime layout: ShortData or Data*, told apart by the low bit
+class DateTime
+{
+public:
+    struct Data {
+        std::atomic<int> ref{ 1 };
+        long long msecs;
+        int offset;
+    };
+
+    DateTime() = default;
+    DateTime(const DateTime &other) : m_word(other.m_word)
+    {
+        if (!isShort())
+            reinterpret_cast<Data *>(m_word)->ref.fetch_add(1, std::memory_order_relaxed);
+    }
+    DateTime &operator=(const DateTime &other)
+    {
+        DateTime copy(other);
+        std::swap(m_word, copy.m_word);
+        return *this;
+    }
+    ~DateTime()
+    {
+        if (!isShort() && reinterpret_cast<Data *>(m_word)->ref.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete reinterpret_cast<Data *>(m_word);
+    }
+
+    static __attribute__((noinline)) DateTime currentDateTime()
+    {
+        timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        const time_t seconds = now.tv_sec;
+        tm local;
+        localtime_r(&seconds, &local);  // Local time status and offset
+        DateTime result;
+        const long long msecs = (long long)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+        result.m_word = (uintptr_t(msecs) << 8) | uintptr_t(local.tm_isdst > 0 ? 2 : 0) | 1;
+        return result;
+    }
+
+    long long msecs() const { return (long long)(m_word >> 8); }
+
+private:
+    bool isShort() const { return m_word & 1; }
+    uintptr_t m_word = 1;
+};
+
+// Baseline SensorReading
+struct OldReading {
+    OldReading() : timestamp(DateTime::currentDateTime()) {}
+    explicit OldReading(const SensorDataRaw &raw)
+        : partectorNumber(raw.partectorNumber), partectorDiam(raw.partectorDiam),
+          partectorMass(raw.partectorMass), grimmValue(raw.grimmValue), temperature(raw.temperature),
+          humidity(raw.humidity), pressure(raw.pressure), altitude(raw.altitude),
+          latitude(raw.latitude), longitude(raw.longitude), co2(raw.co2),
+          timestamp(DateTime::currentDateTime()) {}
+
+    int partectorNumber = 0;
+    int partectorDiam = 0;
+    float partectorMass = 0, grimmValue = 0, temperature = 0, humidity = 0;
+    float pressure = 0, altitude = 0, latitude = 0, longitude = 0;
+    int co2 = 0;
+    DateTime timestamp;
+};
+
+// Current SensorReading
+struct NewReading {
+    NewReading() = default;
+    NewReading(const SensorDataRaw &raw, long long timestampMs, int deviceId = 0)
+        : timestampMs(timestampMs), partectorNumber(raw.partectorNumber), partectorDiam(raw.partectorDiam),
+          partectorMass(raw.partectorMass), grimmValue(raw.grimmValue), temperature(raw.temperature),
+          humidity(raw.humidity), pressure(raw.pressure), altitude(raw.altitude),
+          latitude(raw.latitude), longitude(raw.longitude), co2(raw.co2), deviceId(deviceId) {}
+
+    long long timestampMs = 0;
+    int partectorNumber = 0;
+    int partectorDiam = 0;
+    float partectorMass = 0, grimmValue = 0, temperature = 0, humidity = 0;
+    float pressure = 0, altitude = 0, latitude = 0, longitude = 0;
+    int co2 = 0;
+    int deviceId = 0;
+};
+
+static_assert(!std::is_trivially_copyable_v<OldReading>);
+static_assert(std::is_trivially_copyable_v<NewReading> && sizeof(NewReading) == 56);
+
+// SpscQueue: fixed ring, element copied in on push and out on pop
+template <typename T>
+class Ring
+{
+public:
+    explicit Ring(size_t capacity) : m_slots(capacity) {}
+    bool push(const T &value)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) == m_slots.size())
+            return false;
+        m_slots[head % m_slots.size()] = value;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+    bool pop(T &value)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire))
+            return false;
+        value = m_slots[tail % m_slots.size()];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::vector<T> m_slots;
+    std::atomic<size_t> m_head{ 0 };
+    std::atomic<size_t> m_tail{ 0 };
+};
+
+static constexpr int FramesPerRead = 8;  // Frames completed by one serial read
+static constexpr int BatchSize = 256;    // Readings drained per wakeup
+
+static std::vector<SensorDataRaw> frames(size_t count)
+{
+    std::vector<SensorDataRaw> raws(count);
+    for (size_t i = 0; i < count; ++i) {
+        raws[i] = SensorDataRaw{ int32_t(i), 100, 1.f, 2.f, 20.f, 50.f, 950.f, 400.f, 47.f, 8.f, 800 };
+    }
+    return raws;
+}
+
+static long long nowMs()
+{
+    timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return (long long)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+// Reader: construct and push; GUI: drain into a batch, copy it for the queued signal
+template <typename Reading, typename Make>
+static double pipeline(const std::vector<SensorDataRaw> &raws, Make make)
+{
+    Ring<Reading> queue(4096);
+    std::vector<Reading> batch;
+    batch.reserve(BatchSize);
+    volatile long long sink = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < raws.size(); i += BatchSize) {
+        const size_t end = std::min(raws.size(), i + BatchSize);
+        make(queue, raws, i, end);
+
+        Reading reading;
+        batch.clear();
+        while (queue.pop(reading))
+            batch.push_back(reading);
+        const std::vector<Reading> delivered = batch;  // ReadingBatch copy into the queued call
+        sink = sink + (long long)delivered.size();
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()
+           / double(raws.size());
+}
+
+static double best(const std::function<double()> &body)
+{
+    double result = 1e30;
+    for (int run = 0; run < 5; ++run)
+        result = std::min(result, body());
+    return result;
+}
+
+int main()
+{
+    const std::vector<SensorDataRaw> raws = frames(2000000);
+
+    const double oldNs = best([&]() {
+        return pipeline<OldReading>(raws, [](Ring<OldReading> &queue, const std::vector<SensorDataRaw> &r,
+                                              size_t from, size_t to) {
+            for (size_t i = from; i < to; ++i)
+                queue.push(OldReading(r[i]));
+        });
+    });
+    const double newNs = best([&]() {
+        return pipeline<NewReading>(raws, [](Ring<NewReading> &queue, const std::vector<SensorDataRaw> &r,
+                                              size_t from, size_t to) {
+            long long stamp = 0;
+            for (size_t i = from; i < to; ++i) {
+                if ((i - from) % FramesPerRead == 0)
+                    stamp = nowMs();  // currentMSecsSinceEpoch() once per read
+                queue.push(NewReading(r[i], stamp));
+            }
+        });
+    });
+
+    // The copies alone, construction excluded
+    const double oldCopyNs = best([&]() {
+        std::vector<OldReading> source(BatchSize);
+        volatile size_t sink = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < raws.size(); i += BatchSize) {
+            const std::vector<OldReading> copy = source;
+            sink = sink + copy.size();
+        }
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()
+               / double(raws.size());
+    });
+    const double newCopyNs = best([&]() {
+        std::vector<NewReading> source(BatchSize);
+        volatile size_t sink = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < raws.size(); i += BatchSize) {
+            const std::vector<NewReading> copy = source;
+            sink = sink + copy.size();
+        }
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()
+               / double(raws.size());
+    });
+
+    std::printf("sizeof: old %zu bytes (not trivially copyable), new %zu bytes (trivially copyable)\n",
+                sizeof(OldReading), sizeof(NewReading));
+    std::printf("%-44s old %7.1f ns/reading   new %7.1f ns/reading   %5.1fx\n",
+                "construct + queue + batch + signal copy", oldNs, newNs, oldNs / newNs);
+    std::printf("%-44s old %7.1f ns/reading   new %7.1f ns/reading   %5.1fx\n",
+                "batch copy only", oldCopyNs, newCopyNs, oldCopyNs / newCopyNs);
+    return 0;
+}
@@ -0,0 +1,26 @@
+#ifndef BENCH_SHIM_SENSORREADING_H
+#define BENCH_SHIM_SENSORREADING_H
+
+// Stands in for src/core/sensorreading.h, which needs QtCore, in benchmarks
+// that only decode frames. The wire struct must match the real header.
+#include <cstdint>
+
+#pragma pack(push, 1)
+struct SensorDataRaw {
+    int32_t partectorNumber;  // 4 bytes - particle count (parts/cm3)
+    int32_t partectorDiam;    // 4 bytes - diameter (nm)
+    float partectorMass;      // 4 bytes - mass concentration (ug/m3)
+    float grimmValue;         // 4 bytes - particles/cm3
+    float temperature;        // 4 bytes - Celsius
+    float humidity;           // 4 bytes - percent
+    float pressure;           // 4 bytes - hPa
+    float altitude;           // 4 bytes - meters
+    float latitude;           // 4 bytes - degrees
+    float longitude;          // 4 bytes - degrees
+    uint16_t co2;             // 2 bytes - ppm
+};                            // Total: 42 bytes
+#pragma pack(pop)
+
+static_assert(sizeof(SensorDataRaw) == 42, "Struct packing mismatch!");
+
+#endif // BENCH_SHIM_SENSORREADING_H
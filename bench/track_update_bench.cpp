@@ -0,0 +1,267 @@
+// Per-batch cost of keeping TrackLayer's geometry current while live
+// readings arrive, at 10k, 100k and 1M points: the old path, which
+// re-projected and reallocated the whole polyline and re-binned every visible
+// sprite on each batch, against the chunked append and incremental sprite
+// cells that replaced it.
+//
+//   g++ -O2 -std=c++17 bench/track_update_bench.cpp -o track_update_bench
+//
+// Qt Quick is not available here, so this measures the CPU work done in
+// updatePaintNode, transcribed with plain arrays in place of QSGGeometry
+// (allocate() is malloc plus free, as in Qt). Vertex upload and drawing are
+// not included; they scale with the vertices handed over, which the old path
+// also made O(n) per batch.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+static constexpr double REFERENCE_ZOOM = 16.0;
+static constexpr double TILE_SIZE = 256.0;
+static constexpr long long TrackChunkSize = 4096;
+static constexpr int BatchSize = 10;  // 1 Hz readings from a few boxes, one frame
+static constexpr int ViewWidth = 1280;
+static constexpr int ViewHeight = 800;
+static constexpr int PointSize = 8;
+
+struct Point2D {
+    float x;
+    float y;
+};
+
+// QSGGeometry: allocate() discards the old vertices
+struct Geometry {
+    Point2D *data = nullptr;
+    int count = 0;
+
+    Geometry() = default;
+    Geometry(const Geometry &) = delete;
+    Geometry &operator=(const Geometry &) = delete;
+
+    ~Geometry() { std::free(data); }
+    void allocate(int vertexCount)
+    {
+        std::free(data);
+        data = static_cast<Point2D *>(std::malloc(sizeof(Point2D) * size_t(std::max(1, vertexCount))));
+        count = vertexCount;
+    }
+};
+
+// SensorReadingModel's float columns
+struct Source {
+    std::vector<float> latitude;
+    std::vector<float> longitude;
+    std::vector<int> hazard;
+};
+
+static double mercatorX(double longitude)
+{
+    return (longitude + 180.0) / 360.0;
+}
+
+static double mercatorY(double latitude)
+{
+    const double rad = latitude * M_PI / 180.0;
+    return (1.0 - std::log(std::tan(rad) + 1.0 / std::cos(rad)) / M_PI) / 2.0;
+}
+
+static void appendReadings(Source &source, int count, std::mt19937 &rng)
+{
+    std::uniform_real_distribution<float> step(-0.0001f, 0.0001f);
+    for (int i = 0; i < count; ++i) {
+        const float lat = source.latitude.empty() ? 47.37f : source.latitude.back() + step(rng);
+        const float lon = source.longitude.empty() ? 8.54f : source.longitude.back() + step(rng);
+        source.latitude.push_back(lat);
+        source.longitude.push_back(lon);
+        source.hazard.push_back(int(rng() % 100 < 90 ? 0 : rng() % 3));
+    }
+}
+
+// Old updateTrackGeometry: every vertex, every batch
+static void oldTrack(const Source &source, Geometry &geometry, double anchorX, double anchorY)
+{
+    const int rows = int(source.latitude.size());
+    geometry.allocate(rows);
+    const double scale = TILE_SIZE * std::pow(2.0, REFERENCE_ZOOM);
+    for (int row = 0; row < rows; ++row) {
+        geometry.data[row].x = float((mercatorX(source.longitude[row]) - anchorX) * scale);
+        geometry.data[row].y = float((mercatorY(source.latitude[row]) - anchorY) * scale);
+    }
+}
+
+// TrackLayer::updateTrack/fillChunk with no pruning: keys are rows
+struct ChunkedTrack {
+    std::vector<std::unique_ptr<Geometry>> chunks;
+    long long dirtyFrom = 0;
+    double anchorX = 0.0;
+    double anchorY = 0.0;
+
+    void fill(std::unique_ptr<Geometry> &node, long long chunkStart, const Source &source)
+    {
+        const Geometry &old = *node;
+        const long long first = chunkStart;
+        const long long last = std::min(chunkStart + TrackChunkSize, (long long)source.latitude.size() - 1);
+        const int count = last > first ? int(last - first + 1) : 0;
+        const long long keepTo = std::min(last + 1, first + old.count);
+
+        auto geometry = std::make_unique<Geometry>();
+        geometry->allocate(count);
+        const double scale = TILE_SIZE * std::pow(2.0, REFERENCE_ZOOM);
+        if (keepTo > first)
+            std::memcpy(geometry->data, old.data, size_t(keepTo - first) * sizeof(Point2D));
+        for (long long key = std::max(first, keepTo); key <= last; ++key) {
+            geometry->data[key - first].x = float((mercatorX(source.longitude[key]) - anchorX) * scale);
+            geometry->data[key - first].y = float((mercatorY(source.latitude[key]) - anchorY) * scale);
+        }
+        node = std::move(geometry);  // setGeometry() deletes the old one
+    }
+
+    void update(const Source &source)
+    {
+        const long long endKey = (long long)source.latitude.size();
+        const long long span = endKey - 1;
+        const int needed = span > 0 ? int((span + TrackChunkSize - 1) / TrackChunkSize) : 0;
+        while (int(chunks.size()) < needed)
+            chunks.push_back(std::make_unique<Geometry>());
+
+        int chunk = dirtyFrom == 0 ? 0 : int((dirtyFrom - 1) / TrackChunkSize);
+        for (; chunk < int(chunks.size()); ++chunk)
+            fill(chunks[chunk], chunk * TrackChunkSize, source);
+        dirtyFrom = endKey;
+    }
+};
+
+struct View {
+    double centerX;
+    double centerY;
+    double scale;
+
+    bool toItem(float latitude, float longitude, int &x, int &y) const
+    {
+        const double px = (mercatorX(longitude) - centerX) * scale + ViewWidth / 2.0;
+        const double py = (mercatorY(latitude) - centerY) * scale + ViewHeight / 2.0;
+        if (px < 0 || py < 0 || px >= ViewWidth || py >= ViewHeight)
+            return false;
+        x = int(px);
+        y = int(py);
+        return true;
+    }
+};
+
+static constexpr int CellSize = PointSize / 2;
+static constexpr int Columns = (ViewWidth + CellSize - 1) / CellSize;
+static constexpr int CellRows = (ViewHeight + CellSize - 1) / CellSize;
+
+// Two triangles per occupied cell
+static int emitSprites(const std::vector<unsigned> &counts, std::vector<Point2D> &vertices)
+{
+    int occupied = 0;
+    for (size_t i = 0; i < counts.size(); i += 3)
+        occupied += (counts[i] | counts[i + 1] | counts[i + 2]) != 0;
+    vertices.assign(size_t(occupied) * 6, Point2D{});
+    Point2D *v = vertices.data();
+    for (size_t cell = 0; cell * 3 < counts.size(); ++cell) {
+        if (!(counts[cell * 3] | counts[cell * 3 + 1] | counts[cell * 3 + 2]))
+            continue;
+        const float cx = float(cell % Columns) * CellSize;
+        const float cy = float(cell / Columns) * CellSize;
+        for (int k = 0; k < 6; ++k)
+            v[k] = Point2D{ cx, cy };
+        v += 6;
+    }
+    return occupied;
+}
+
+static void binRows(const Source &source, const View &view, size_t first, size_t last,
+                    std::vector<unsigned> &counts)
+{
+    for (size_t row = first; row <= last; ++row) {
+        int x, y;
+        if (view.toItem(source.latitude[row], source.longitude[row], x, y))
+            ++counts[(size_t(y / CellSize) * Columns + size_t(x / CellSize)) * 3 + source.hazard[row]];
+    }
+}
+
+// Old updatePointGeometry: every visible reading, every batch. The grid
+// query is left out in the old path's favour, all readings being in view.
+static int oldSprites(const Source &source, const View &view, std::vector<Point2D> &vertices)
+{
+    std::vector<unsigned> counts(size_t(Columns) * CellRows * 3, 0);
+    binRows(source, view, 0, source.latitude.size() - 1, counts);
+    return emitSprites(counts, vertices);
+}
+
+static double millis(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void run(int points)
+{
+    std::mt19937 rng(1);
+    Source source;
+    appendReadings(source, points, rng);
+    const double anchorX = mercatorX(source.longitude[0]);
+    const double anchorY = mercatorY(source.latitude[0]);
+
+    // Zoomed so the whole track is in view
+    View view{ anchorX, anchorY, TILE_SIZE * std::pow(2.0, 14.0) };
+
+    ChunkedTrack chunked;
+    chunked.anchorX = anchorX;
+    chunked.anchorY = anchorY;
+    chunked.update(source);
+    std::vector<unsigned> counts(size_t(Columns) * CellRows * 3, 0);
+    binRows(source, view, 0, source.latitude.size() - 1, counts);
+
+    Geometry oldGeometry;
+    std::vector<Point2D> vertices;
+    const int batches = points >= 1000000 ? 20 : 200;
+    double oldTrackMs = 0, oldSpriteMs = 0, newTrackMs = 0, newSpriteMs = 0;
+    volatile float sink = 0;
+
+    for (int batch = 0; batch < batches; ++batch) {
+        const size_t first = source.latitude.size();
+        appendReadings(source, BatchSize, rng);
+
+        auto start = std::chrono::steady_clock::now();
+        oldTrack(source, oldGeometry, anchorX, anchorY);
+        oldTrackMs += millis(start);
+
+        start = std::chrono::steady_clock::now();
+        oldSprites(source, view, vertices);
+        oldSpriteMs += millis(start);
+
+        start = std::chrono::steady_clock::now();
+        chunked.update(source);
+        newTrackMs += millis(start);
+
+        start = std::chrono::steady_clock::now();
+        binRows(source, view, first, source.latitude.size() - 1, counts);
+        emitSprites(counts, vertices);
+        newSpriteMs += millis(start);
+
+        sink = sink + oldGeometry.data[0].x + chunked.chunks.back()->data[0].x;
+    }
+
+    std::printf("%8d points  track: old %9.3f ms  new %7.3f ms   sprites: old %9.3f ms  new %7.3f ms"
+                "   total per batch: old %9.3f ms  new %7.3f ms\n",
+                points, oldTrackMs / batches, newTrackMs / batches, oldSpriteMs / batches,
+                newSpriteMs / batches, (oldTrackMs + oldSpriteMs) / batches,
+                (newTrackMs + newSpriteMs) / batches);
+}
+
+int main()
+{
+    std::printf("batch of %d readings, %dx%d view, %d px sprites, %lld-segment chunks\n",
+                BatchSize, ViewWidth, ViewHeight, PointSize, TrackChunkSize);
+    for (int points : { 10000, 100000, 1000000 })
+        run(points);
+    return 0;
+}
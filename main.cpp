@@ -4,9 +4,12 @@
 #include <QDebug>
 
 #include "src/core/sensorreading.h"
+#include "src/core/readingbus.h"
 #include "src/data/databasemanager.h"
 #include "src/data/csvexporter.h"
+#include "src/data/latestreading.h"
 #include "src/serial/serialhandler.h"
+#include "src/serial/devicemanager.h"
 
 int main(int argc, char *argv[])
 {
@@ -22,6 +25,7 @@ int main(int argc, char *argv[])
 
     // Register SensorReading for use in signal/slot and QML
     qRegisterMetaType<SensorReading>("SensorReading");
+    qRegisterMetaType<ReadingBatch>("ReadingBatch");
 
     QQmlApplicationEngine engine;
     QObject::connect(
@@ -33,30 +37,66 @@ int main(int argc, char *argv[])
 
     // Connect signals after QML objects are created (singletons are now instantiated)
     QObject::connect(&engine, &QQmlApplicationEngine::objectCreated, &app,
-        [&engine](QObject *obj, const QUrl &url) {
+        [&engine, &app](QObject *obj, const QUrl &url) {
             if (!obj) return;  // Object creation failed
 
             // Get singleton instances - now they should be instantiated
             auto *serialHandler = engine.singletonInstance<SerialHandler*>("ZephyrSense", "SerialHandler");
+            auto *deviceManager = engine.singletonInstance<DeviceManager*>("ZephyrSense", "DeviceManager");
+            auto *readingBus = engine.singletonInstance<ReadingBus*>("ZephyrSense", "ReadingBus");
             auto *dbManager = engine.singletonInstance<DatabaseManager*>("ZephyrSense", "DatabaseManager");
             auto *csvExporter = engine.singletonInstance<CsvExporter*>("ZephyrSense", "CsvExporter");
+            auto *latestReading = engine.singletonInstance<LatestReading*>("ZephyrSense", "LatestReading");
 
             qDebug() << "Singletons - SerialHandler:" << serialHandler
+                     << "DeviceManager:" << deviceManager
+                     << "ReadingBus:" << readingBus
                      << "DatabaseManager:" << dbManager
-                     << "CsvExporter:" << csvExporter;
+                     << "CsvExporter:" << csvExporter
+                     << "LatestReading:" << latestReading;
 
-            // Connect SerialHandler::newReading to DatabaseManager::insertReading
-            if (serialHandler && dbManager) {
-                QObject::connect(serialHandler, &SerialHandler::newReading,
-                                 dbManager, &DatabaseManager::insertReading);
-                qDebug() << "Connected SerialHandler::newReading -> DatabaseManager::insertReading";
+            // Storage takes every batch as it is read, off the bus. Both calls only
+            // queue work for their writer threads, so they are safe from any thread.
+            auto store = [dbManager, csvExporter](const ReadingBatch &batch) {
+                if (dbManager) dbManager->insertReadings(batch);
+                if (csvExporter) csvExporter->appendReadings(batch);
+            };
+
+            if (serialHandler) {
+                QObject::connect(serialHandler, &SerialHandler::readingsReceived, &app, store);
+                qDebug() << "Connected SerialHandler::readingsReceived -> storage";
+            }
+
+            // Additional devices are stored on DeviceManager's ingest thread; stop
+            // them at quit, while the storage singletons are still alive
+            if (deviceManager) {
+                deviceManager->setReadingSink(store);
+                QObject::connect(&app, &QCoreApplication::aboutToQuit,
+                                 deviceManager, &DeviceManager::closeAll);
+                qDebug() << "Set DeviceManager reading sink -> storage";
+            }
+
+            if (!readingBus) return;
+
+            // The bus feeds display only; its producers arrive already batched
+            if (serialHandler) {
+                QObject::connect(serialHandler, &SerialHandler::readingsReceived,
+                                 readingBus, &ReadingBus::publishBatch);
+                qDebug() << "Connected SerialHandler::readingsReceived -> ReadingBus::publishBatch";
+            }
+
+            if (deviceManager) {
+                QObject::connect(deviceManager, &DeviceManager::readingsReceived,
+                                 readingBus, &ReadingBus::publishBatch);
+                qDebug() << "Connected DeviceManager::readingsReceived -> ReadingBus::publishBatch";
             }
 
-            // Connect SerialHandler::newReading to CsvExporter::appendReading
-            if (serialHandler && csvExporter) {
-                QObject::connect(serialHandler, &SerialHandler::newReading,
-                                 csvExporter, &CsvExporter::appendReading);
-                qDebug() << "Connected SerialHandler::newReading -> CsvExporter::appendReading";
+            // Throttles its own notifications to the dashboard update interval
+            if (latestReading) {
+                readingBus->subscribe(latestReading, ReadingBus::Every100Ms, [latestReading](const ReadingBatch &batch) {
+                    latestReading->addReadings(batch);
+                });
+                qDebug() << "Subscribed LatestReading::addReadings to ReadingBus";
             }
         }, Qt::QueuedConnection);
 
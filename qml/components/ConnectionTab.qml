@@ -73,10 +73,24 @@ Item {
                         }
                     }
 
+                    // Reader thread (opt-in)
+                    RowLayout {
+                        Layout.fillWidth: true
+                        Label {
+                            text: "Reader:"
+                            Layout.preferredWidth: 80
+                        }
+                        CheckBox {
+                            text: "Decode on background thread"
+                            checked: SerialHandler.threaded
+                            onToggled: SerialHandler.threaded = checked
+                        }
+                    }
+
                     // Status display
                     Rectangle {
                         Layout.fillWidth: true
-                        Layout.preferredHeight: 60
+                        Layout.preferredHeight: 80
                         color: palette.base
                         border.color: palette.mid
                         border.width: 1
@@ -95,6 +109,19 @@ Item {
                             Label {
                                 text: "Current Port: " + (SerialHandler.portName || "None")
                             }
+                            Label {
+                                text: "Dropped frames: " + SerialHandler.droppedFrameCount
+                                      + "  Queue overflows: " + SerialHandler.overflowCount
+                                color: SerialHandler.overflowCount > 0 ? "orange" : palette.text
+                            }
+                            Label {
+                                text: "Frame format: " + ["detecting", "legacy", "v2"][SerialHandler.protocolVersion]
+                                      + (SerialHandler.protocolVersion === 2
+                                         ? "  Lost: " + SerialHandler.lostFrameCount
+                                           + "  Reordered: " + SerialHandler.reorderedFrameCount
+                                         : "")
+                                color: SerialHandler.lostFrameCount > 0 ? "orange" : palette.text
+                            }
                         }
                     }
 
@@ -128,6 +155,62 @@ Item {
                 }
             }
 
+            GroupBox {
+                title: "Additional Devices"
+                Layout.fillWidth: true
+                Layout.maximumWidth: 400
+
+                ColumnLayout {
+                    width: parent.width
+                    spacing: 8
+
+                    // Each device is read on its own thread and stored with its device id
+                    RowLayout {
+                        Layout.fillWidth: true
+                        ComboBox {
+                            id: devicePortComboBox
+                            Layout.fillWidth: true
+                            model: SerialHandler.availablePorts
+                        }
+                        Button {
+                            text: "Add"
+                            enabled: devicePortComboBox.currentText !== ""
+                            onClicked: DeviceManager.openDevice(devicePortComboBox.currentText)
+                        }
+                    }
+
+                    Repeater {
+                        model: DeviceManager.devices
+
+                        delegate: RowLayout {
+                            required property var modelData
+                            Layout.fillWidth: true
+
+                            Label {
+                                Layout.fillWidth: true
+                                text: "Device " + modelData.deviceId + ": " + modelData.portName
+                                      + (modelData.connected ? "" : " (disconnected)")
+                                      + "\nDropped: " + modelData.droppedFrameCount
+                                      + "  Overflows: " + modelData.overflowCount
+                                      + (modelData.protocolVersion === 2
+                                         ? "  Lost: " + modelData.lostFrameCount : "")
+                                color: modelData.connected ? palette.text : "red"
+                            }
+                            Button {
+                                text: "Remove"
+                                onClicked: DeviceManager.closeDevice(modelData.deviceId)
+                            }
+                        }
+                    }
+
+                    Label {
+                        visible: DeviceManager.deviceCount === 0
+                        text: "None"
+                        opacity: 0.6
+                    }
+                }
+            }
+
             Item { Layout.fillHeight: true }
         }
     }
@@ -9,6 +9,7 @@ Item {
     property alias selectedDate: internal.selectedDate
     property alias selectedHour: internal.selectedHour
     property var availableDates: []  // List of "yyyy-MM-dd" strings
+    property var dayCounts: ({})     // Optional "yyyy-MM-dd" -> reading count, drawn as data density
     property string label: "Date/Time"
 
     signal dateTimeChanged(date dateTime)
@@ -20,6 +21,12 @@ Item {
         id: internal
         property date selectedDate: new Date()
         property int selectedHour: 12
+        property real maxDayCount: {
+            var max = 0
+            for (var day in root.dayCounts)
+                max = Math.max(max, root.dayCounts[day])
+            return max
+        }
     }
 
     ColumnLayout {
@@ -146,6 +153,10 @@ Item {
                         return root.availableDates.indexOf(dateStr) !== -1
                     }
                     property bool isCurrentMonth: model.month === monthGrid.month
+                    property real density: {
+                        var count = root.dayCounts[Qt.formatDate(date, "yyyy-MM-dd")]
+                        return count && internal.maxDayCount > 0 ? count / internal.maxDayCount : 0
+                    }
 
                     color: isSelected ? "#2196F3" : (hasData ? "#E3F2FD" : "transparent")
 
@@ -161,10 +172,10 @@ Item {
                         }
                     }
 
-                    // Data indicator dot
+                    // Data indicator dot, widened by the day's share of the busiest day
                     Rectangle {
                         visible: parent.hasData && !parent.isSelected
-                        width: 4
+                        width: 4 + Math.round(parent.density * 16)
                         height: 4
                         radius: 2
                         color: "#4CAF50"
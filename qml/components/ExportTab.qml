@@ -5,6 +5,15 @@ import QtQuick.Dialogs
 import ZephyrSense
 
 Item {
+    id: exportTab
+
+    property var availableDates: []
+    property date rangeStart: new Date()
+    property date rangeEnd: new Date()
+    property real exportDone: 0
+    property real exportTotal: 0
+    property string exportStatus: ""
+
     ScrollView {
         anchors.fill: parent
         anchors.margins: 16
@@ -105,12 +114,198 @@ Item {
                 }
             }
 
+            GroupBox {
+                title: "Rotation and Compression"
+                Layout.fillWidth: true
+                Layout.maximumWidth: 600
+
+                ColumnLayout {
+                    width: parent.width
+                    spacing: 12
+
+                    RowLayout {
+                        Layout.fillWidth: true
+                        Label {
+                            text: "Rotate after (MB):"
+                            Layout.preferredWidth: 150
+                        }
+                        SpinBox {
+                            from: 0
+                            to: 10000
+                            value: Math.round(CsvExporter.rotateBytes / (1024 * 1024))
+                            editable: true
+                            onValueModified: CsvExporter.rotateBytes = value * 1024 * 1024
+                        }
+                        Label {
+                            text: "0 = off"
+                            color: palette.mid
+                        }
+                    }
+
+                    RowLayout {
+                        Layout.fillWidth: true
+                        Label {
+                            text: "Rotate every (min):"
+                            Layout.preferredWidth: 150
+                        }
+                        SpinBox {
+                            from: 0
+                            to: 10080
+                            value: CsvExporter.rotateIntervalMinutes
+                            editable: true
+                            onValueModified: CsvExporter.rotateIntervalMinutes = value
+                        }
+                        Label {
+                            text: "0 = off"
+                            color: palette.mid
+                        }
+                    }
+
+                    CheckBox {
+                        text: CsvExporter.compressionAvailable ? "Compress with gzip (.gz)"
+                                                              : "Compress with gzip (not available in this build)"
+                        enabled: CsvExporter.compressionAvailable
+                        checked: CsvExporter.compressionEnabled
+                        onToggled: CsvExporter.compressionEnabled = checked
+                    }
+
+                    Label {
+                        visible: CsvExporter.currentFilePath !== ""
+                        text: "Writing: " + CsvExporter.currentFilePath
+                        elide: Text.ElideMiddle
+                        Layout.fillWidth: true
+                    }
+
+                    Label {
+                        text: "Written: " + (CsvExporter.bytesWritten / 1024).toFixed(1) + " KB"
+                              + (CsvExporter.compressionEnabled
+                                 ? "  (compression ratio " + CsvExporter.compressionRatio.toFixed(1) + ":1)" : "")
+                    }
+
+                    Label {
+                        text: "With rotation enabled, files are named <name>_<yyyyMMdd-HHmmss>_<NNN>.csv next to the selected file."
+                        wrapMode: Text.WordWrap
+                        Layout.fillWidth: true
+                        font.italic: true
+                        color: '#d9e6f1'
+                    }
+                }
+            }
+
+            GroupBox {
+                title: "Export Historical Range"
+                Layout.fillWidth: true
+                Layout.maximumWidth: 600
+
+                ColumnLayout {
+                    width: parent.width
+                    spacing: 12
+
+                    RowLayout {
+                        Layout.fillWidth: true
+                        spacing: 12
+
+                        DateTimePicker {
+                            id: rangeStartPicker
+                            label: "Start"
+                            Layout.preferredWidth: 220
+                            availableDates: exportTab.availableDates
+                            onDateTimeChanged: function (dt) {
+                                exportTab.rangeStart = dt;
+                            }
+                        }
+
+                        DateTimePicker {
+                            id: rangeEndPicker
+                            label: "End"
+                            Layout.preferredWidth: 220
+                            availableDates: exportTab.availableDates
+                            onDateTimeChanged: function (dt) {
+                                exportTab.rangeEnd = dt;
+                            }
+                        }
+                    }
+
+                    RowLayout {
+                        Layout.fillWidth: true
+                        spacing: 8
+
+                        Button {
+                            text: "Export to CSV..."
+                            enabled: !DatabaseManager.rangeExportRunning
+                            onClicked: rangeFileDialog.open()
+                        }
+
+                        Button {
+                            text: "Cancel"
+                            visible: DatabaseManager.rangeExportRunning
+                            onClicked: DatabaseManager.cancelRangeExport()
+                        }
+
+                        ProgressBar {
+                            Layout.fillWidth: true
+                            visible: DatabaseManager.rangeExportRunning
+                            from: 0
+                            to: Math.max(1, exportTab.exportTotal)
+                            value: exportTab.exportDone
+                        }
+                    }
+
+                    Label {
+                        text: exportTab.exportStatus
+                        visible: text !== ""
+                        wrapMode: Text.WordWrap
+                        Layout.fillWidth: true
+                    }
+
+                    Label {
+                        text: "Rows are streamed from the database, so exports of any size use little memory."
+                        wrapMode: Text.WordWrap
+                        Layout.fillWidth: true
+                        font.italic: true
+                        color: '#d9e6f1'
+                    }
+                }
+            }
+
             Item {
                 Layout.fillHeight: true
             }
         }
     }
 
+    Connections {
+        target: DatabaseManager
+        function onAvailableDatesReady(dates) {
+            exportTab.availableDates = dates;
+        }
+        function onRangeExportProgress(done, total) {
+            exportTab.exportDone = done;
+            exportTab.exportTotal = total;
+            exportTab.exportStatus = "Exported " + done + " of " + total + " readings...";
+        }
+        function onRangeExportCompleted(success, rows) {
+            exportTab.exportStatus = success ? "Export complete: " + rows + " readings"
+                                             : "Export failed or was canceled";
+        }
+    }
+
+    // File dialog for the range export destination
+    FileDialog {
+        id: rangeFileDialog
+        fileMode: FileDialog.SaveFile
+        nameFilters: ["CSV files (*.csv)", "All files (*)"]
+        defaultSuffix: "csv"
+        onAccepted: {
+            exportTab.exportDone = 0;
+            exportTab.exportTotal = 0;
+            exportTab.exportStatus = "Starting export...";
+            DatabaseManager.exportRangeToCsv(exportTab.rangeStart, exportTab.rangeEnd, selectedFile);
+        }
+    }
+
+    Component.onCompleted: DatabaseManager.requestAvailableDates()
+
     // File dialog for selecting export path
     FileDialog {
         id: fileDialog
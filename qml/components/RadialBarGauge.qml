@@ -25,6 +25,7 @@ Item {
     property string sensorName: ""
     property string unit: ""
     property int precision: 1
+    property string caption: ""  // Optional secondary line under the unit
 
     implicitWidth: 140
     implicitHeight: 140
@@ -230,5 +231,14 @@ Item {
             color: palette.windowText
             anchors.horizontalCenter: parent.horizontalCenter
         }
+
+        Text {
+            id: captionText
+            visible: root.caption !== ""
+            text: root.caption
+            font.pixelSize: 9
+            color: palette.windowText
+            anchors.horizontalCenter: parent.horizontalCenter
+        }
     }
 }
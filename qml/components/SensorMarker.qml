@@ -12,9 +12,13 @@ MapQuickItem {
     required property string tooltipText
     required property int readingId
     required property int hazardLevel
+    required property int clusterCount
+
+    readonly property bool isCluster: clusterCount > 1
 
     // Signal for click handling
     signal markerClicked(int id)
+    signal clusterClicked(real latitude, real longitude)
 
     coordinate: QtPositioning.coordinate(latitude, longitude)
     anchorPoint.x: markerCircle.width / 2
@@ -22,8 +26,9 @@ MapQuickItem {
 
     sourceItem: Item {
         id: markerItem
-        width: 24
-        height: 24
+        // Clusters grow with the number of readings they stand for
+        width: marker.isCluster ? Math.min(48, 24 + 6 * Math.log(marker.clusterCount)) : 24
+        height: width
 
         Rectangle {
             id: markerCircle
@@ -40,6 +45,15 @@ MapQuickItem {
             Behavior on scale {
                 NumberAnimation { duration: 100 }
             }
+
+            Text {
+                anchors.centerIn: parent
+                visible: marker.isCluster
+                text: marker.clusterCount > 999 ? Math.round(marker.clusterCount / 1000) + "k" : marker.clusterCount
+                font.pixelSize: 10
+                font.bold: true
+                color: "white"
+            }
         }
 
         HoverHandler {
@@ -48,7 +62,12 @@ MapQuickItem {
 
         TapHandler {
             acceptedButtons: Qt.LeftButton
-            onTapped: marker.markerClicked(marker.readingId)
+            onTapped: {
+                if (marker.isCluster)
+                    marker.clusterClicked(marker.latitude, marker.longitude);
+                else
+                    marker.markerClicked(marker.readingId);
+            }
         }
 
         ToolTip {
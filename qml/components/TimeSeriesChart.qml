@@ -75,6 +75,14 @@ ChartView {
         }
     }
 
+    // Decimate to a min and a max per horizontal pixel of the plot area
+    Binding {
+        target: chartModel
+        when: chartModel !== null
+        property: "pointBudget"
+        value: Math.max(200, Math.round(chartView.plotArea.width) * 2)
+    }
+
     // Update Y bounds when active column changes
     onActiveColumnChanged: {
         if (chartModel) {
@@ -17,14 +17,12 @@ Item {
     property int frozenReadingId: mainWindow.selectedReadingId
     property int lastProcessedFrozenId: -1  // Guard against duplicate processing
     property var frozenTimestamp: null
-    property var lastUpdateTime: null
-    property var lastSerialUpdateTime: null
 
     readonly property bool isLiveMode: updateIntervalMs > 0
     readonly property bool isFrozenMode: frozenReadingId >= 0 && updateIntervalMs < 0
 
-    // Current sensor values
-    property var currentReading: ({
+    // Sensor values of the frozen reading; live mode binds to LatestReading
+    property var frozenReading: ({
             partectorNumber: 0,
             partectorDiam: 0,
             partectorMass: 0,
@@ -112,48 +110,27 @@ Item {
         }
     ]
 
-    // Helper model for frozen mode
-    SensorReadingModel {
-        id: readingModel
+    // Live values are pushed by the serial port, or polled from the database
+    // while it is quiet; the update interval throttles both
+    Binding {
+        target: LatestReading
+        property: "active"
+        value: dashboardRoot.isLiveMode
     }
 
-    // Timer for live updates
-    Timer {
-        id: updateTimer
-        interval: dashboardRoot.updateIntervalMs
-        running: dashboardRoot.isLiveMode && dashboardRoot.updateIntervalMs > 0
-        repeat: true
-        onTriggered: fetchLatestReading()
+    Binding {
+        target: LatestReading
+        property: "updateIntervalMs"
+        value: dashboardRoot.updateIntervalMs
+        when: dashboardRoot.isLiveMode
     }
 
-    // Live data connection
+    // Frozen reading lookups complete asynchronously
     Connections {
-        target: SerialHandler
-        enabled: dashboardRoot.isLiveMode
-        function onNewReading(reading) {
-            // Throttle updates based on selected interval
-            var now = new Date();
-            if (dashboardRoot.lastSerialUpdateTime) {
-                var elapsed = now - dashboardRoot.lastSerialUpdateTime;
-                if (elapsed < dashboardRoot.updateIntervalMs) {
-                    // Skip update, too soon
-                    return;
-                }
-            }
-
-            dashboardRoot.currentReading = {
-                partectorNumber: reading.partectorNumber,
-                partectorDiam: reading.partectorDiam,
-                partectorMass: reading.partectorMass,
-                grimmValue: reading.grimmValue,
-                temperature: reading.temperature,
-                humidity: reading.humidity,
-                pressure: reading.pressure,
-                altitude: reading.altitude,
-                co2: reading.co2
-            };
-            dashboardRoot.lastUpdateTime = now;
-            dashboardRoot.lastSerialUpdateTime = now;
+        target: DatabaseManager
+        function onReadingByIdReady(id, reading) {
+            if (id === dashboardRoot.frozenReadingId)
+                applyFrozenReading(id, reading);
         }
     }
 
@@ -164,30 +141,11 @@ Item {
         return Qt.formatDateTime(date, "yyyy-MM-dd hh:mm:ss");
     }
 
-    // Fetch latest reading from database (fallback when no serial data)
-    function fetchLatestReading() {
-        // Load recent data from database
-        var endTime = new Date();
-        var startTime = new Date(endTime.getTime() - 3600000); // Last hour for better chance of data
-        readingModel.loadFromDatabase(startTime, endTime);
-
-        if (readingModel.count > 0) {
-            var reading = readingModel.getReading(readingModel.count - 1);
-            dashboardRoot.currentReading = {
-                partectorNumber: reading.partectorNumber || 0,
-                partectorDiam: reading.partectorDiam || 0,
-                partectorMass: reading.partectorMass || 0,
-                grimmValue: reading.grimmValue || 0,
-                temperature: reading.temperature || 0,
-                humidity: reading.humidity || 0,
-                pressure: reading.pressure || 0,
-                altitude: reading.altitude || 0,
-                co2: reading.co2 || 0
-            };
-            dashboardRoot.lastUpdateTime = reading.timestamp || new Date();
-        } else {
-            console.log("No data available in database");
-        }
+    // Rolling window summary shown under a live gauge
+    function formatStats(key, precision) {
+        return "avg " + LatestReading.means[key].toFixed(precision)
+                + "  (" + LatestReading.minimums[key].toFixed(precision)
+                + " - " + LatestReading.maximums[key].toFixed(precision) + ")";
     }
 
     // Load frozen reading from database by ID (direct query, no loop)
@@ -196,10 +154,12 @@ Item {
             return;
 
         // Direct database lookup by ID - much faster than loading all data
-        var reading = DatabaseManager.getReadingById(readingId);
+        DatabaseManager.requestReadingById(readingId);
+    }
 
+    function applyFrozenReading(readingId, reading) {
         if (reading && reading.id !== undefined) {
-            dashboardRoot.currentReading = {
+            dashboardRoot.frozenReading = {
                 partectorNumber: reading.partectorNumber || 0,
                 partectorDiam: reading.partectorDiam || 0,
                 partectorMass: reading.partectorMass || 0,
@@ -223,9 +183,7 @@ Item {
         dashboardRoot.frozenReadingId = -1;
         dashboardRoot.lastProcessedFrozenId = -1;  // Reset guard for future clicks
         dashboardRoot.updateIntervalMs = intervalMs || 1000;
-        updateTimer.stop();
-        updateTimer.start();
-        fetchLatestReading();
+        LatestReading.refresh();
     }
 
     // Monitor frozen reading ID changes
@@ -235,20 +193,10 @@ Item {
             lastProcessedFrozenId = frozenReadingId;
             // Switch to frozen mode
             dashboardRoot.updateIntervalMs = -1;
-            updateTimer.stop();
             loadFrozenReading(frozenReadingId);
         }
     }
 
-    // Initialize on load
-    Component.onCompleted: {
-        // Only fetch for live mode - frozen mode is handled by onFrozenReadingIdChanged
-        // which fires when the binding initializes
-        if (frozenReadingId < 0) {
-            fetchLatestReading();
-        }
-    }
-
     ColumnLayout {
         anchors.fill: parent
         anchors.margins: 16
@@ -280,8 +228,9 @@ Item {
                     text: {
                         if (dashboardRoot.isFrozenMode) {
                             return "Showing data from " + formatTimestamp(dashboardRoot.frozenTimestamp);
-                        } else if (dashboardRoot.lastUpdateTime) {
-                            return "Live - Last update: " + formatTimestamp(dashboardRoot.lastUpdateTime);
+                        } else if (LatestReading.hasReading) {
+                            return (LatestReading.live ? "Live - Last update: " : "Live (stored) - Last update: ")
+                                    + formatTimestamp(LatestReading.timestamp);
                         } else {
                             return "Live - No data yet";
                         }
@@ -310,7 +259,9 @@ Item {
                     Layout.minimumWidth: 140
                     Layout.minimumHeight: 140
 
-                    value: dashboardRoot.currentReading[modelData.key] || 0
+                    value: (dashboardRoot.isLiveMode ? LatestReading.values : dashboardRoot.frozenReading)[modelData.key] || 0
+                    caption: dashboardRoot.isLiveMode && LatestReading.sampleCount > 1
+                             ? formatStats(modelData.key, modelData.precision) : ""
                     minValue: modelData.min
                     maxValue: modelData.max
                     sensorKey: modelData.key
@@ -367,8 +318,6 @@ Item {
                     } else {
                         // Update interval in live mode
                         dashboardRoot.updateIntervalMs = newInterval;
-                        updateTimer.interval = newInterval;
-                        updateTimer.restart();
                     }
                 }
             }
@@ -14,19 +14,35 @@ Item {
     property date historicalStart: new Date()
     property date historicalEnd: new Date()
     property var availableDates: []
+    property var dayCounts: ({})
 
     // Chart data model
     TimeSeriesChartModel {
         id: chartModel
     }
 
-    // Live update timer
+    // Date list is fetched asynchronously
+    Connections {
+        target: DatabaseManager
+        function onAvailableDatesReady(dates) {
+            graphsViewRoot.availableDates = dates
+        }
+        function onDaySummariesReady(days) {
+            var counts = {}
+            for (var i = 0; i < days.length; i++)
+                counts[days[i].date] = days[i].count
+            graphsViewRoot.dayCounts = counts
+        }
+    }
+
+    // Live mode appends readings as they arrive; the timer only expires
+    // rows when the device goes quiet
     Timer {
         id: liveUpdateTimer
         interval: graphsViewRoot.updateIntervalMs
         running: graphsViewRoot.currentMode === GraphsView.VisualizationMode.Live
         repeat: true
-        onTriggered: loadLiveData()
+        onTriggered: chartModel.trimToWindow()
     }
 
     ColumnLayout {
@@ -146,6 +162,8 @@ Item {
 
                 Label {
                     text: chartModel.dataCount + " data points"
+                          + (chartModel.displayCount < chartModel.dataCount
+                             ? " (" + chartModel.displayCount + " plotted)" : "")
                     font.pixelSize: 12
                     color: "#757575"
                 }
@@ -191,6 +209,7 @@ Item {
                     label: "Start Date/Time"
                     Layout.fillWidth: true
                     availableDates: graphsViewRoot.availableDates
+                    dayCounts: graphsViewRoot.dayCounts
 
                     onDateTimeChanged: function(dt) {
                         graphsViewRoot.historicalStart = dt
@@ -202,6 +221,7 @@ Item {
                     label: "End Date/Time"
                     Layout.fillWidth: true
                     availableDates: graphsViewRoot.availableDates
+                    dayCounts: graphsViewRoot.dayCounts
 
                     onDateTimeChanged: function(dt) {
                         graphsViewRoot.historicalEnd = dt
@@ -244,6 +264,7 @@ Item {
     function switchToHistoricalMode() {
         currentMode = GraphsView.VisualizationMode.Historical
         liveUpdateTimer.stop()
+        chartModel.stopLiveUpdates()
         chartModel.loadData(historicalStart, historicalEnd)
     }
 
@@ -256,7 +277,9 @@ Item {
                 break
             }
         }
+        // Load the window once, then append live readings to it
         loadDataForRange(minutes)
+        chartModel.startLiveUpdates(minutes)
     }
 
     function loadDataForRange(minutes) {
@@ -275,7 +298,8 @@ Item {
     }
 
     function refreshAvailableDates() {
-        availableDates = DatabaseManager.getAvailableDates()
+        DatabaseManager.requestAvailableDates()
+        DatabaseManager.requestDaySummaries()
     }
 
     function formatTime(msecs) {
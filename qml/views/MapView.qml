@@ -21,10 +21,39 @@ Item {
     property date historicalStart: new Date()
     property date historicalEnd: new Date()
     property var availableDates: []
+    property var dayCounts: ({})
+    property bool centerPending: false  // Center the map once the pending load finishes
+    property bool trackMode: false  // Draw readings as one batched track instead of markers
 
     // Model instance for map markers
     SensorReadingModel {
         id: sensorModel
+        onLoadFinished: {
+            if (mapViewRoot.centerPending) {
+                mapViewRoot.centerPending = false;
+                centerOnData();
+            }
+        }
+    }
+
+    // Only markers inside the visible region, clustered by zoom level
+    MarkerClusterModel {
+        id: clusterModel
+        sourceModel: mapViewRoot.trackMode ? null : sensorModel
+    }
+
+    // Date list is fetched asynchronously
+    Connections {
+        target: DatabaseManager
+        function onAvailableDatesReady(dates) {
+            mapViewRoot.availableDates = dates;
+        }
+        function onDaySummariesReady(days) {
+            var counts = {};
+            for (var i = 0; i < days.length; i++)
+                counts[days[i].date] = days[i].count;
+            mapViewRoot.dayCounts = counts;
+        }
     }
 
     // Main map container
@@ -47,18 +76,47 @@ Item {
         // Marker layer using MapItemView
         MapItemView {
             id: markerView
-            model: sensorModel
+            model: clusterModel
             parent: mapView.map
 
             delegate: SensorMarker {
                 // Required properties auto-injected from model roles:
-                // latitude, longitude, tooltipText, readingId
+                // latitude, longitude, tooltipText, readingId, hazardLevel, clusterCount
 
                 onMarkerClicked: function (id) {
                     mapViewRoot.showDashboardForReading(id);
                 }
+                onClusterClicked: function (latitude, longitude) {
+                    mapView.map.center = QtPositioning.coordinate(latitude, longitude);
+                    mapView.map.zoomLevel = Math.min(mapView.map.maximumZoomLevel, mapView.map.zoomLevel + 2);
+                }
             }
         }
+
+        // Feed the visible region to the cluster model
+        Connections {
+            target: mapView.map
+            function onCenterChanged() { viewportTimer.restart(); }
+            function onZoomLevelChanged() { viewportTimer.restart(); }
+            function onWidthChanged() { viewportTimer.restart(); }
+            function onHeightChanged() { viewportTimer.restart(); }
+        }
+    }
+
+    // Batched track renderer: one scene graph node for all readings
+    TrackLayer {
+        id: trackLayer
+        anchors.fill: mapView
+        visible: mapViewRoot.trackMode
+        enabled: visible
+        sourceModel: mapViewRoot.trackMode ? sensorModel : null
+        centerLatitude: mapView.map.center.latitude
+        centerLongitude: mapView.map.center.longitude
+        zoomLevel: mapView.map.zoomLevel
+
+        onReadingClicked: function (readingId) {
+            mapViewRoot.showDashboardForReading(readingId);
+        }
     }
 
     // Mode badge overlay
@@ -85,10 +143,18 @@ Item {
             id: infoLabel
             anchors.centerIn: parent
             text: sensorModel.count + " points"
+                  + (!mapViewRoot.trackMode && clusterModel.visibleReadings < sensorModel.count
+                     ? " (" + clusterModel.visibleReadings + " in view)" : "")
             font.pixelSize: 12
         }
     }
 
+    Timer {
+        id: viewportTimer
+        interval: 50
+        onTriggered: updateViewport()
+    }
+
     // Live mode prune timer (removes old readings outside time window)
     Timer {
         id: liveUpdateTimer
@@ -176,6 +242,31 @@ Item {
                     Layout.fillWidth: true
                 }
 
+                Label {
+                    text: "Display:"
+                    font.pixelSize: 12
+                }
+
+                ButtonGroup {
+                    id: displayGroup
+                }
+
+                Button {
+                    text: "Markers"
+                    checkable: true
+                    checked: !mapViewRoot.trackMode
+                    ButtonGroup.group: displayGroup
+                    onClicked: mapViewRoot.trackMode = false
+                }
+
+                Button {
+                    text: "Track"
+                    checkable: true
+                    checked: mapViewRoot.trackMode
+                    ButtonGroup.group: displayGroup
+                    onClicked: mapViewRoot.trackMode = true
+                }
+
                 Label {
                     text: "Time Window:"
                     font.pixelSize: 12
@@ -298,6 +389,7 @@ Item {
                         label: "Start"
                         Layout.preferredWidth: 220
                         availableDates: mapViewRoot.availableDates
+                        dayCounts: mapViewRoot.dayCounts
 
                         onDateTimeChanged: function (dt) {
                             mapViewRoot.historicalStart = dt;
@@ -309,6 +401,7 @@ Item {
                         label: "End"
                         Layout.preferredWidth: 220
                         availableDates: mapViewRoot.availableDates
+                        dayCounts: mapViewRoot.dayCounts
 
                         onDateTimeChanged: function (dt) {
                             mapViewRoot.historicalEnd = dt;
@@ -401,8 +494,8 @@ Item {
         }
         // Selecting a preset triggers historical mode
         switchToHistoricalMode();
+        centerPending = true;
         sensorModel.loadFromDatabase(start, now);
-        centerOnData();
     }
 
     function centerOnData() {
@@ -412,12 +505,21 @@ Item {
         }
     }
 
+    function updateViewport() {
+        var region = mapView.map.visibleRegion.boundingGeoRectangle();
+        clusterModel.setViewport(region.topLeft.latitude, region.topLeft.longitude,
+                                 region.bottomRight.latitude, region.bottomRight.longitude,
+                                 mapView.map.zoomLevel);
+    }
+
     function refreshAvailableDates() {
-        availableDates = DatabaseManager.getAvailableDates();
+        DatabaseManager.requestAvailableDates();
+        DatabaseManager.requestDaySummaries();
     }
 
     Component.onCompleted: {
         refreshAvailableDates();
+        viewportTimer.restart();
         // Start in live mode
         currentMode = MapView.VisualizationMode.Live;
         loadLiveData();
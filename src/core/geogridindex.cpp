@@ -0,0 +1,65 @@
+#include "geogridindex.h"
+#include <QtMath>
+
+// Web Mercator stops at about +/-85.0511 degrees latitude
+static constexpr double MAX_MERCATOR_LATITUDE = 85.05112878;
+
+GeoGridIndex::GeoGridIndex(int cellsPerAxis)
+    : m_cellsPerAxis(qMax(1, cellsPerAxis))
+{
+}
+
+void GeoGridIndex::clear()
+{
+    m_cells.clear();
+    m_size = 0;
+}
+
+void GeoGridIndex::insert(qint64 key, double latitude, double longitude)
+{
+    const int cx = cellCoordinate(mercatorX(longitude));
+    const int cy = cellCoordinate(mercatorY(latitude));
+    m_cells[cellKey(cx, cy)].append(key);
+    ++m_size;
+}
+
+void GeoGridIndex::removeBelow(qint64 firstKey)
+{
+    for (auto it = m_cells.begin(); it != m_cells.end();) {
+        QList<qint64> &keys = it.value();
+        const qsizetype expired = std::lower_bound(keys.cbegin(), keys.cend(), firstKey) - keys.cbegin();
+        m_size -= expired;
+        if (expired == keys.size()) {
+            it = m_cells.erase(it);
+        } else {
+            keys.remove(0, expired);
+            ++it;
+        }
+    }
+}
+
+int GeoGridIndex::cellCoordinate(double normalized) const
+{
+    return qBound(0, int(normalized * m_cellsPerAxis), m_cellsPerAxis - 1);
+}
+
+double GeoGridIndex::mercatorX(double longitude)
+{
+    return (longitude + 180.0) / 360.0;
+}
+
+double GeoGridIndex::mercatorY(double latitude)
+{
+    const double lat = qBound(-MAX_MERCATOR_LATITUDE, latitude, MAX_MERCATOR_LATITUDE) * M_PI / 180.0;
+    return (1.0 - std::log(std::tan(lat) + 1.0 / std::cos(lat)) / M_PI) / 2.0;
+}
+
+double GeoGridIndex::longitudeFromX(double x)
+{
+    return x * 360.0 - 180.0;
+}
+
+double GeoGridIndex::latitudeFromY(double y)
+{
+    return std::atan(std::sinh(M_PI * (1.0 - 2.0 * y))) * 180.0 / M_PI;
+}
@@ -0,0 +1,87 @@
+#ifndef GEOGRIDINDEX_H
+#define GEOGRIDINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QtGlobal>
+#include <algorithm>
+#include <cmath>
+
+// Uniform grid over normalized Web Mercator coordinates (0..1 on both axes,
+// the same projection the map tiles use). Points are stored as caller-chosen
+// keys, which must be inserted in increasing order; expiring the oldest keys
+// is a per-cell prefix removal.
+class GeoGridIndex
+{
+public:
+    explicit GeoGridIndex(int cellsPerAxis = 4096);
+
+    void clear();
+    void insert(qint64 key, double latitude, double longitude);
+
+    // Remove every key below firstKey
+    void removeBelow(qint64 firstKey);
+
+    qsizetype size() const { return m_size; }
+
+    // Call visitor(key) for every key in a cell overlapping the box. Points near
+    // the box edge may lie just outside it; callers filter exactly if needed.
+    template <typename Visitor>
+    void query(double north, double west, double south, double east, Visitor &&visitor) const;
+
+    // Normalized Web Mercator projection and its inverse
+    static double mercatorX(double longitude);
+    static double mercatorY(double latitude);
+    static double longitudeFromX(double x);
+    static double latitudeFromY(double y);
+
+private:
+    int cellCoordinate(double normalized) const;
+    static quint64 cellKey(int cx, int cy) { return (quint64(quint32(cx)) << 32) | quint32(cy); }
+
+    int m_cellsPerAxis;
+    qsizetype m_size = 0;
+    QHash<quint64, QList<qint64>> m_cells;  // Keys ascending within each cell
+};
+
+template <typename Visitor>
+void GeoGridIndex::query(double north, double west, double south, double east, Visitor &&visitor) const
+{
+    // Boxes crossing the antimeridian are widened to the full longitude range
+    if (west > east) {
+        west = -180.0;
+        east = 180.0;
+    }
+
+    const int x0 = cellCoordinate(mercatorX(west));
+    const int x1 = cellCoordinate(mercatorX(east));
+    const int y0 = cellCoordinate(mercatorY(north));  // y grows southwards
+    const int y1 = cellCoordinate(mercatorY(south));
+
+    auto visitCell = [&visitor](const QList<qint64> &keys) {
+        for (const qint64 key : keys)
+            visitor(key);
+    };
+
+    // Walk whichever is smaller: the box's cells or the occupied cells
+    const qint64 boxCells = qint64(x1 - x0 + 1) * (y1 - y0 + 1);
+    if (boxCells > m_cells.size()) {
+        for (auto it = m_cells.cbegin(); it != m_cells.cend(); ++it) {
+            const int cx = int(it.key() >> 32);
+            const int cy = int(it.key() & 0xffffffffu);
+            if (cx >= x0 && cx <= x1 && cy >= y0 && cy <= y1)
+                visitCell(it.value());
+        }
+        return;
+    }
+
+    for (int cx = x0; cx <= x1; ++cx) {
+        for (int cy = y0; cy <= y1; ++cy) {
+            const auto it = m_cells.constFind(cellKey(cx, cy));
+            if (it != m_cells.cend())
+                visitCell(it.value());
+        }
+    }
+}
+
+#endif // GEOGRIDINDEX_H
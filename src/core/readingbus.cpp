@@ -0,0 +1,145 @@
+#include "readingbus.h"
+
+#include <QThread>
+
+ReadingBus::ReadingBus(QObject *parent)
+    : QObject(parent)
+{
+}
+
+int ReadingBus::subscribe(QObject *context, int intervalMs, Handler handler)
+{
+    intervalMs = qMax(0, intervalMs);
+
+    Group *group = nullptr;
+    for (const auto &candidate : m_groups) {
+        if (candidate->intervalMs == intervalMs) {
+            group = candidate.get();
+            break;
+        }
+    }
+
+    if (!group) {
+        auto created = std::make_unique<Group>();
+        created->intervalMs = intervalMs;
+        created->timer.setSingleShot(true);
+        created->timer.setInterval(intervalMs);
+        created->deliveredSeq = m_logFirstSeq + m_log.size();
+        group = created.get();
+        connect(&group->timer, &QTimer::timeout, this, [this, group]() { deliver(group); });
+        m_groups.push_back(std::move(created));
+    } else if (group->subscribers.isEmpty()) {
+        // An idle group does not replay what arrived while it had no subscribers
+        group->deliveredSeq = m_logFirstSeq + m_log.size();
+    }
+
+    const int id = m_nextSubscriptionId++;
+    Subscriber subscriber{ id, context, std::move(handler), {} };
+    subscriber.destroyedConnection = connect(context, &QObject::destroyed, this, [this, id]() {
+        unsubscribe(id);
+    });
+    group->subscribers.append(std::move(subscriber));
+    return id;
+}
+
+void ReadingBus::unsubscribe(int subscriptionId)
+{
+    for (const auto &group : m_groups) {
+        for (qsizetype i = 0; i < group->subscribers.size(); ++i) {
+            if (group->subscribers.at(i).id != subscriptionId)
+                continue;
+
+            disconnect(group->subscribers.at(i).destroyedConnection);
+            group->subscribers.removeAt(i);
+            if (group->subscribers.isEmpty()) {
+                group->timer.stop();
+                trimLog();
+            }
+            return;
+        }
+    }
+}
+
+void ReadingBus::publish(const SensorReading &reading)
+{
+    publishBatch(ReadingBatch{ reading });
+}
+
+void ReadingBus::publishBatch(const ReadingBatch &readings)
+{
+    if (readings.isEmpty())
+        return;
+
+    bool anySubscribers = false;
+    for (const auto &group : m_groups) {
+        if (group->subscribers.isEmpty())
+            continue;
+        anySubscribers = true;
+        // The first pending reading starts the interval, so latency is bounded by it
+        if (!group->timer.isActive())
+            group->timer.start();
+    }
+
+    if (anySubscribers) {
+        m_log.append(readings);
+    } else {
+        m_logFirstSeq += readings.size();  // Nobody would ever read them
+    }
+}
+
+void ReadingBus::deliver(Group *group)
+{
+    const qint64 endSeq = m_logFirstSeq + m_log.size();
+    if (group->deliveredSeq >= endSeq)
+        return;
+
+    // One copy per group; the subscribers of the group share it
+    const ReadingBatch batch = m_log.mid(group->deliveredSeq - m_logFirstSeq);
+    group->deliveredSeq = endSeq;
+    trimLog();
+
+    // Handlers may unsubscribe (themselves or others) while we iterate
+    const QList<Subscriber> subscribers = group->subscribers;
+    for (const Subscriber &subscriber : subscribers) {
+        if (!subscriber.context || !isSubscribed(group, subscriber.id))
+            continue;
+
+        if (subscriber.context->thread() == thread()) {
+            subscriber.handler(batch);
+        } else {
+            QMetaObject::invokeMethod(subscriber.context, [handler = subscriber.handler, batch]() {
+                handler(batch);
+            }, Qt::QueuedConnection);
+        }
+    }
+}
+
+void ReadingBus::trimLog()
+{
+    // Drop the prefix every active group has already delivered
+    qint64 keepFrom = m_logFirstSeq + m_log.size();
+    for (const auto &group : m_groups) {
+        if (!group->subscribers.isEmpty())
+            keepFrom = qMin(keepFrom, group->deliveredSeq);
+    }
+
+    const qint64 drop = keepFrom - m_logFirstSeq;
+    if (drop <= 0)
+        return;
+
+    if (drop >= m_log.size()) {
+        m_log.clear();
+    } else {
+        m_log.remove(0, drop);
+    }
+    m_logFirstSeq = keepFrom;
+}
+
+bool ReadingBus::isSubscribed(const Group *group, int subscriptionId) const
+{
+    for (const Subscriber &subscriber : group->subscribers) {
+        if (subscriber.id == subscriptionId)
+            return true;
+    }
+    return false;
+}
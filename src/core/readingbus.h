@@ -0,0 +1,83 @@
+#ifndef READINGBUS_H
+#define READINGBUS_H
+
+#include <QObject>
+#include <QQmlEngine>
+#include <QList>
+#include <QPointer>
+#include <QTimer>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "sensorreading.h"
+
+// Implicitly shared and never modified after delivery, so every subscriber of
+// a cadence receives the same buffer
+using ReadingBatch = QList<SensorReading>;
+
+// Fan-out of live readings to the display. Producers publish one reading or
+// one batch at a time; subscribers choose a delivery interval and receive everything
+// published since their last delivery as one batch. Subscribers with the same
+// interval share one timer and one batch. Storage does not go through the bus:
+// producers hand readings to the database and CSV export directly, off the GUI
+// thread where they can.
+class ReadingBus : public QObject
+{
+    Q_OBJECT
+    QML_ELEMENT
+    QML_SINGLETON
+
+public:
+    // Common delivery intervals in milliseconds; any other value works too
+    enum Cadence {
+        NextEventLoop = 0,
+        EveryFrame = 16,
+        Every100Ms = 100,
+        EverySecond = 1000
+    };
+
+    using Handler = std::function<void(const ReadingBatch &)>;
+
+    explicit ReadingBus(QObject *parent = nullptr);
+
+    // Call handler with new readings at most once per intervalMs. Delivery
+    // happens on context's thread and stops when context is destroyed.
+    // Returns an id for unsubscribe().
+    int subscribe(QObject *context, int intervalMs, Handler handler);
+    void unsubscribe(int subscriptionId);
+
+public slots:
+    void publish(const SensorReading &reading);
+    // For producers that already drain in batches, e.g. DeviceManager
+    void publishBatch(const ReadingBatch &readings);
+
+private:
+    struct Subscriber {
+        int id;
+        QPointer<QObject> context;
+        Handler handler;
+        QMetaObject::Connection destroyedConnection;
+    };
+
+    struct Group {
+        int intervalMs;
+        QTimer timer;
+        qint64 deliveredSeq;  // Readings below this were handed out already
+        QList<Subscriber> subscribers;
+    };
+
+    void deliver(Group *group);
+    void trimLog();
+    bool isSubscribed(const Group *group, int subscriptionId) const;
+
+    // Readings not yet delivered to every group; m_log[0] has sequence m_logFirstSeq
+    ReadingBatch m_log;
+    qint64 m_logFirstSeq = 0;
+
+    // Groups are kept once created, so a subscriber may unsubscribe while its
+    // group is delivering
+    std::vector<std::unique_ptr<Group>> m_groups;
+    int m_nextSubscriptionId = 1;
+};
+
+#endif // READINGBUS_H
@@ -0,0 +1,166 @@
+#include "readingcolumns.h"
+
+void ReadingColumns::reserve(qsizetype rows)
+{
+    ids.reserve(rows);
+    timestamps.reserve(rows);
+    partectorNumber.reserve(rows);
+    partectorDiam.reserve(rows);
+    partectorMass.reserve(rows);
+    grimmValue.reserve(rows);
+    temperature.reserve(rows);
+    humidity.reserve(rows);
+    pressure.reserve(rows);
+    altitude.reserve(rows);
+    latitude.reserve(rows);
+    longitude.reserve(rows);
+    co2.reserve(rows);
+    deviceIds.reserve(rows);
+}
+
+void ReadingColumns::clear()
+{
+    ids.clear();
+    timestamps.clear();
+    partectorNumber.clear();
+    partectorDiam.clear();
+    partectorMass.clear();
+    grimmValue.clear();
+    temperature.clear();
+    humidity.clear();
+    pressure.clear();
+    altitude.clear();
+    latitude.clear();
+    longitude.clear();
+    co2.clear();
+    deviceIds.clear();
+}
+
+void ReadingColumns::append(qint64 id, const SensorReading &reading)
+{
+    ids.append(id);
+    timestamps.append(reading.timestampMs);
+    partectorNumber.append(reading.partectorNumber);
+    partectorDiam.append(reading.partectorDiam);
+    partectorMass.append(reading.partectorMass);
+    grimmValue.append(reading.grimmValue);
+    temperature.append(reading.temperature);
+    humidity.append(reading.humidity);
+    pressure.append(reading.pressure);
+    altitude.append(reading.altitude);
+    latitude.append(reading.latitude);
+    longitude.append(reading.longitude);
+    co2.append(reading.co2);
+    deviceIds.append(reading.deviceId);
+}
+
+void ReadingColumns::appendRow(const ReadingColumns &other, qsizetype row)
+{
+    ids.append(other.ids.at(row));
+    timestamps.append(other.timestamps.at(row));
+    partectorNumber.append(other.partectorNumber.at(row));
+    partectorDiam.append(other.partectorDiam.at(row));
+    partectorMass.append(other.partectorMass.at(row));
+    grimmValue.append(other.grimmValue.at(row));
+    temperature.append(other.temperature.at(row));
+    humidity.append(other.humidity.at(row));
+    pressure.append(other.pressure.at(row));
+    altitude.append(other.altitude.at(row));
+    latitude.append(other.latitude.at(row));
+    longitude.append(other.longitude.at(row));
+    co2.append(other.co2.at(row));
+    deviceIds.append(other.deviceIds.at(row));
+}
+
+void ReadingColumns::appendSensorValues(qint64 timestampMs, const std::array<double, SensorCount> &values,
+                                        int deviceId)
+{
+    ids.append(0);
+    timestamps.append(timestampMs);
+    partectorNumber.append(qRound(values[PartectorNumber]));
+    partectorDiam.append(qRound(values[PartectorDiam]));
+    partectorMass.append(float(values[PartectorMass]));
+    grimmValue.append(float(values[GrimmValue]));
+    temperature.append(float(values[Temperature]));
+    humidity.append(float(values[Humidity]));
+    pressure.append(float(values[Pressure]));
+    altitude.append(float(values[Altitude]));
+    latitude.append(0.0f);
+    longitude.append(0.0f);
+    co2.append(qRound(values[Co2]));
+    deviceIds.append(deviceId);
+}
+
+void ReadingColumns::removeFirst(qsizetype count)
+{
+    ids.remove(0, count);
+    timestamps.remove(0, count);
+    partectorNumber.remove(0, count);
+    partectorDiam.remove(0, count);
+    partectorMass.remove(0, count);
+    grimmValue.remove(0, count);
+    temperature.remove(0, count);
+    humidity.remove(0, count);
+    pressure.remove(0, count);
+    altitude.remove(0, count);
+    latitude.remove(0, count);
+    longitude.remove(0, count);
+    co2.remove(0, count);
+    deviceIds.remove(0, count);
+}
+
+double ReadingColumns::sensorValue(int sensor, qsizetype row) const
+{
+    double value = 0.0;
+    visitSensor(sensor, [&](const auto &column) { value = column.at(row); });
+    return value;
+}
+
+SensorReading ReadingColumns::reading(qsizetype row) const
+{
+    SensorReading reading;
+    reading.partectorNumber = partectorNumber.at(row);
+    reading.partectorDiam = partectorDiam.at(row);
+    reading.partectorMass = partectorMass.at(row);
+    reading.grimmValue = grimmValue.at(row);
+    reading.temperature = temperature.at(row);
+    reading.humidity = humidity.at(row);
+    reading.pressure = pressure.at(row);
+    reading.altitude = altitude.at(row);
+    reading.latitude = latitude.at(row);
+    reading.longitude = longitude.at(row);
+    reading.co2 = co2.at(row);
+    reading.timestampMs = timestamps.at(row);
+    reading.deviceId = deviceIds.at(row);
+    return reading;
+}
+
+QVariantMap ReadingColumns::toVariantMap(qsizetype row) const
+{
+    QVariantMap map;
+    map["id"] = ids.at(row);
+    map["timestamp"] = QDateTime::fromMSecsSinceEpoch(timestamps.at(row));
+    map["partectorNumber"] = partectorNumber.at(row);
+    map["partectorDiam"] = partectorDiam.at(row);
+    map["partectorMass"] = static_cast<double>(partectorMass.at(row));
+    map["grimmValue"] = static_cast<double>(grimmValue.at(row));
+    map["temperature"] = static_cast<double>(temperature.at(row));
+    map["humidity"] = static_cast<double>(humidity.at(row));
+    map["pressure"] = static_cast<double>(pressure.at(row));
+    map["altitude"] = static_cast<double>(altitude.at(row));
+    map["latitude"] = static_cast<double>(latitude.at(row));
+    map["longitude"] = static_cast<double>(longitude.at(row));
+    map["co2"] = co2.at(row);
+    map["deviceId"] = deviceIds.at(row);
+    return map;
+}
+
+QVariantList ReadingColumns::toVariantList() const
+{
+    QVariantList list;
+    list.reserve(size());
+    for (qsizetype row = 0; row < size(); ++row) {
+        list.append(toVariantMap(row));
+    }
+    return list;
+}
@@ -0,0 +1,88 @@
+#ifndef READINGCOLUMNS_H
+#define READINGCOLUMNS_H
+
+#include <QList>
+#include <QVariantList>
+#include <QVariantMap>
+#include <array>
+#include "sensorreading.h"
+
+// Structure-of-arrays result buffer for range queries: one contiguous column
+// per field, so large loads avoid a QVariantMap (and its string keys) per row.
+struct ReadingColumns
+{
+    // Sensor indices used by visitSensor(), in chart column order (lat/lon excluded)
+    enum Sensor {
+        PartectorNumber = 0,
+        PartectorDiam,
+        PartectorMass,
+        GrimmValue,
+        Temperature,
+        Humidity,
+        Pressure,
+        Altitude,
+        Co2,
+        SensorCount
+    };
+
+    QList<qint64> ids;
+    QList<qint64> timestamps;  // msecs since epoch
+    QList<qint32> partectorNumber;
+    QList<qint32> partectorDiam;
+    QList<float> partectorMass;
+    QList<float> grimmValue;
+    QList<float> temperature;
+    QList<float> humidity;
+    QList<float> pressure;
+    QList<float> altitude;
+    QList<float> latitude;
+    QList<float> longitude;
+    QList<qint32> co2;
+    QList<qint32> deviceIds;
+
+    qsizetype size() const { return timestamps.size(); }
+    bool isEmpty() const { return timestamps.isEmpty(); }
+
+    void reserve(qsizetype rows);
+    void clear();
+    void append(qint64 id, const SensorReading &reading);
+    // Copy one row of another buffer onto the end of this one
+    void appendRow(const ReadingColumns &other, qsizetype row);
+    // Row without an id or position, e.g. an aggregate from a rollup tier
+    void appendSensorValues(qint64 timestampMs, const std::array<double, SensorCount> &values, int deviceId);
+
+    // Drop the oldest rows; Qt 6 QList erases at the front by moving its begin pointer
+    void removeFirst(qsizetype count);
+
+    // Sensor value as double, for code that handles all sensors uniformly
+    double sensorValue(int sensor, qsizetype row) const;
+
+    SensorReading reading(qsizetype row) const;
+
+    // QML compatibility - same keys the QVariant range API has always used
+    QVariantMap toVariantMap(qsizetype row) const;
+    QVariantList toVariantList() const;
+
+    // Call visitor with the column of the given sensor; used by per-column scans
+    template <typename Visitor>
+    void visitSensor(int sensor, Visitor &&visitor) const;
+};
+
+template <typename Visitor>
+void ReadingColumns::visitSensor(int sensor, Visitor &&visitor) const
+{
+    switch (sensor) {
+    case PartectorNumber: visitor(partectorNumber); break;
+    case PartectorDiam:   visitor(partectorDiam); break;
+    case PartectorMass:   visitor(partectorMass); break;
+    case GrimmValue:      visitor(grimmValue); break;
+    case Temperature:     visitor(temperature); break;
+    case Humidity:        visitor(humidity); break;
+    case Pressure:        visitor(pressure); break;
+    case Altitude:        visitor(altitude); break;
+    case Co2:             visitor(co2); break;
+    default: break;
+    }
+}
+
+#endif // READINGCOLUMNS_H
@@ -4,6 +4,7 @@
 #include <QDateTime>
 #include <QObject>
 #include <cstdint>
+#include <type_traits>
 
 // Raw binary struct matching embedded device protocol (46 bytes packed)
 #pragma pack(push, 1)
@@ -24,7 +25,12 @@ struct SensorDataRaw {
 
 static_assert(sizeof(SensorDataRaw) == 42, "Struct packing mismatch!");
 
-// Application-level sensor reading with QML integration
+// Application-level sensor reading with QML integration. Trivially copyable
+// and 56 bytes, so queues, batches and queued signals copy it with memcpy.
+// The timestamp is UTC milliseconds since the epoch; it only becomes a
+// QDateTime (and meets a time zone) through the timestamp property in QML.
+// deviceId identifies the sensor box: 0 for SerialHandler's port, the id
+// chosen in DeviceManager for the others.
 class SensorReading
 {
     Q_GADGET
@@ -39,11 +45,18 @@ class SensorReading
     Q_PROPERTY(float latitude MEMBER latitude)
     Q_PROPERTY(float longitude MEMBER longitude)
     Q_PROPERTY(int co2 MEMBER co2)
-    Q_PROPERTY(QDateTime timestamp MEMBER timestamp)
+    Q_PROPERTY(qint64 timestampMs MEMBER timestampMs)
+    Q_PROPERTY(QDateTime timestamp READ timestamp)
+    Q_PROPERTY(int deviceId MEMBER deviceId)
 
 public:
-    SensorReading();
-    explicit SensorReading(const SensorDataRaw &raw);
+    SensorReading() = default;
+    // timestampMs is the arrival time; frames decoded from one read share it
+    SensorReading(const SensorDataRaw &raw, qint64 timestampMs, int deviceId = 0);
+
+    QDateTime timestamp() const { return QDateTime::fromMSecsSinceEpoch(timestampMs); }
+
+    qint64 timestampMs = 0;  // UTC msecs since epoch
 
     // Sensor fields
     int partectorNumber = 0;
@@ -57,9 +70,13 @@ public:
     float latitude = 0.0f;
     float longitude = 0.0f;
     int co2 = 0;
-    QDateTime timestamp;
+
+    int deviceId = 0;  // Fills what was tail padding, the size is unchanged
 };
 
+static_assert(std::is_trivially_copyable_v<SensorReading>, "SensorReading must stay memcpy-able");
+static_assert(sizeof(SensorReading) == 56, "SensorReading layout changed");
+
 Q_DECLARE_METATYPE(SensorReading)
 
 #endif // SENSORREADING_H
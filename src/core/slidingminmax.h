@@ -0,0 +1,53 @@
+#ifndef SLIDINGMINMAX_H
+#define SLIDINGMINMAX_H
+
+#include <QtGlobal>
+#include <deque>
+#include <utility>
+
+// Minimum and maximum over a sliding window of values tagged with increasing
+// sequence numbers. Monotonic deques give amortized O(1) push and expiry, so
+// a live window never needs a full rescan to keep its bounds current.
+template <typename T>
+class SlidingMinMax
+{
+public:
+    // seq must be greater than that of every value pushed before
+    void push(qint64 seq, T value)
+    {
+        while (!m_min.empty() && m_min.back().second >= value)
+            m_min.pop_back();
+        m_min.emplace_back(seq, value);
+
+        while (!m_max.empty() && m_max.back().second <= value)
+            m_max.pop_back();
+        m_max.emplace_back(seq, value);
+    }
+
+    // Forget every value whose sequence number is below firstSeq
+    void expireBefore(qint64 firstSeq)
+    {
+        while (!m_min.empty() && m_min.front().first < firstSeq)
+            m_min.pop_front();
+        while (!m_max.empty() && m_max.front().first < firstSeq)
+            m_max.pop_front();
+    }
+
+    void clear()
+    {
+        m_min.clear();
+        m_max.clear();
+    }
+
+    bool isEmpty() const { return m_min.empty(); }
+
+    // Only valid when !isEmpty()
+    T min() const { return m_min.front().second; }
+    T max() const { return m_max.front().second; }
+
+private:
+    std::deque<std::pair<qint64, T>> m_min;  // Values increasing front to back
+    std::deque<std::pair<qint64, T>> m_max;  // Values decreasing front to back
+};
+
+#endif // SLIDINGMINMAX_H
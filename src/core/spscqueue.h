@@ -0,0 +1,60 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <QtGlobal>
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Bounded lock-free single-producer/single-consumer queue.
+// push() may only be called from one thread and pop() from one (other) thread.
+// One slot is kept free to tell a full queue from an empty one.
+template <typename T, std::size_t Capacity>
+class SpscQueue
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "Capacity must be a power of two");
+
+public:
+    // Producer side: returns false (and drops the value) when the queue is full
+    bool push(const T &value)
+    {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        const std::size_t next = (tail + 1) & Mask;
+        if (next == m_head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        m_slots[tail] = value;
+        m_tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: returns false when the queue is empty
+    bool pop(T &value)
+    {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = m_slots[head];
+        m_head.store((head + 1) & Mask, std::memory_order_release);
+        return true;
+    }
+
+    bool isEmpty() const
+    {
+        return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+    }
+
+    static constexpr std::size_t capacity() { return Capacity - 1; }
+
+private:
+    static constexpr std::size_t Mask = Capacity - 1;
+
+    // Keep producer and consumer indices on separate cache lines
+    alignas(64) std::atomic<std::size_t> m_head{0};
+    alignas(64) std::atomic<std::size_t> m_tail{0};
+    alignas(64) std::array<T, Capacity> m_slots{};
+};
+
+#endif // SPSCQUEUE_H
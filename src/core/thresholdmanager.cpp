@@ -5,6 +5,26 @@
 // Initialize static member
 ThresholdManager* ThresholdManager::s_instance = nullptr;
 
+// Debounce intervals for persistence and change notification
+static constexpr int SAVE_DELAY_MS = 1000;
+static constexpr int NOTIFY_DELAY_MS = 50;
+
+// Every persisted key; each one is also the name of its Q_PROPERTY
+static const char *const SETTINGS_KEYS[] = {
+    "co2Warning", "co2Danger",
+    "temperatureWarning", "temperatureDanger", "temperatureLowWarning", "temperatureLowDanger",
+    "humidityWarning", "humidityDanger", "humidityLowWarning", "humidityLowDanger",
+    "partectorMassWarning", "partectorMassDanger",
+    "grimmValueWarning", "grimmValueDanger",
+    "partectorNumberWarning", "partectorNumberDanger",
+    "partectorDiamWarning", "partectorDiamDanger",
+    "pressureWarning", "pressureDanger",
+    "altitudeWarning", "altitudeDanger",
+    "partectorMassEnabled", "partectorNumberEnabled", "partectorDiamEnabled",
+    "grimmValueEnabled", "co2Enabled", "temperatureEnabled",
+    "humidityEnabled", "pressureEnabled", "altitudeEnabled"
+};
+
 ThresholdManager::ThresholdManager(QObject *parent)
     : QObject(parent)
     , m_settings("thresholds")
@@ -57,10 +77,39 @@ ThresholdManager::ThresholdManager(QObject *parent)
 
     // Load persisted settings (overrides defaults)
     loadSettings();
+    compileRules();
+
+    // Dirty keys are written once edits pause for SAVE_DELAY_MS
+    m_saveTimer.setSingleShot(true);
+    m_saveTimer.setInterval(SAVE_DELAY_MS);
+    connect(&m_saveTimer, &QTimer::timeout, this, [this]() { saveSettings(); });
+
+    // Writing and syncing the settings file stays off the GUI thread
+    m_settingsWriter = new QObject;
+    m_settingsWriter->moveToThread(&m_settingsThread);
+    connect(&m_settingsThread, &QThread::finished, m_settingsWriter, &QObject::deleteLater);
+    m_settingsThread.setObjectName("ThresholdSettings");
+    m_settingsThread.start();
+
+    // Bursts of setter calls (a dragged spin box) produce one thresholdsChanged
+    m_notifyTimer.setSingleShot(true);
+    m_notifyTimer.setInterval(NOTIFY_DELAY_MS);
+    connect(&m_notifyTimer, &QTimer::timeout, this, &ThresholdManager::emitThresholdsChanged);
 
     qDebug() << "ThresholdManager initialized with CO2 warning:" << m_co2Warning << "danger:" << m_co2Danger;
 }
 
+ThresholdManager::~ThresholdManager()
+{
+    // Don't lose edits made within the last debounce interval
+    saveSettings(Qt::BlockingQueuedConnection);
+    m_settingsThread.quit();
+    m_settingsThread.wait();
+
+    if (s_instance == this)
+        s_instance = nullptr;
+}
+
 ThresholdManager* ThresholdManager::instance()
 {
     return s_instance;
@@ -111,51 +160,87 @@ void ThresholdManager::loadSettings()
     m_altitudeEnabled = m_settings.value("altitudeEnabled", false).toBool();
 }
 
-void ThresholdManager::saveSettings()
+// Setters only record the key; the write happens once the user pauses
+void ThresholdManager::markDirty(const char *key)
 {
-    m_settings.setValue("co2Warning", m_co2Warning);
-    m_settings.setValue("co2Danger", m_co2Danger);
+    compileRules();
+    m_dirtyKeys.insert(QString::fromLatin1(key));
+    m_saveTimer.start();
+    scheduleThresholdsChanged();
+}
 
-    m_settings.setValue("temperatureWarning", m_temperatureWarning);
-    m_settings.setValue("temperatureDanger", m_temperatureDanger);
-    m_settings.setValue("temperatureLowWarning", m_temperatureLowWarning);
-    m_settings.setValue("temperatureLowDanger", m_temperatureLowDanger);
+void ThresholdManager::saveSettings(Qt::ConnectionType type)
+{
+    if (m_dirtyKeys.isEmpty())
+        return;
 
-    m_settings.setValue("humidityWarning", m_humidityWarning);
-    m_settings.setValue("humidityDanger", m_humidityDanger);
-    m_settings.setValue("humidityLowWarning", m_humidityLowWarning);
-    m_settings.setValue("humidityLowDanger", m_humidityLowDanger);
+    m_saveTimer.stop();
 
-    m_settings.setValue("partectorMassWarning", m_partectorMassWarning);
-    m_settings.setValue("partectorMassDanger", m_partectorMassDanger);
+    // Settings keys are the property names, so the current value is one lookup away
+    QVariantMap values;
+    for (const QString &key : std::as_const(m_dirtyKeys)) {
+        values.insert(key, property(key.toLatin1().constData()));
+    }
+    m_dirtyKeys.clear();
 
-    m_settings.setValue("grimmValueWarning", m_grimmValueWarning);
-    m_settings.setValue("grimmValueDanger", m_grimmValueDanger);
+    // QSettings is reentrant, not thread-safe: the writer thread uses its own instance
+    QMetaObject::invokeMethod(m_settingsWriter, [values]() {
+        QSettings settings("thresholds");
+        for (auto it = values.cbegin(); it != values.cend(); ++it) {
+            settings.setValue(it.key(), it.value());
+        }
+        settings.sync();
+        if (settings.status() != QSettings::NoError) {
+            qWarning() << "ThresholdManager: failed to save thresholds, status" << settings.status();
+        }
+    }, type);
+}
 
-    m_settings.setValue("partectorNumberWarning", m_partectorNumberWarning);
-    m_settings.setValue("partectorNumberDanger", m_partectorNumberDanger);
+void ThresholdManager::scheduleThresholdsChanged()
+{
+    m_thresholdsPending = true;
+    if (m_updateDepth == 0 && !m_notifyTimer.isActive()) {
+        m_notifyTimer.start();
+    }
+}
 
-    m_settings.setValue("partectorDiamWarning", m_partectorDiamWarning);
-    m_settings.setValue("partectorDiamDanger", m_partectorDiamDanger);
+void ThresholdManager::emitThresholdsChanged()
+{
+    m_notifyTimer.stop();
+    if (m_thresholdsPending) {
+        m_thresholdsPending = false;
+        emit thresholdsChanged();
+    }
+}
 
-    m_settings.setValue("pressureWarning", m_pressureWarning);
-    m_settings.setValue("pressureDanger", m_pressureDanger);
+void ThresholdManager::beginUpdate()
+{
+    ++m_updateDepth;
+    m_notifyTimer.stop();
+}
 
-    m_settings.setValue("altitudeWarning", m_altitudeWarning);
-    m_settings.setValue("altitudeDanger", m_altitudeDanger);
+void ThresholdManager::commitUpdate()
+{
+    if (m_updateDepth == 0) {
+        qWarning() << "ThresholdManager: commitUpdate() without beginUpdate()";
+        return;
+    }
 
-    // Save enabled states
-    m_settings.setValue("partectorMassEnabled", m_partectorMassEnabled);
-    m_settings.setValue("partectorNumberEnabled", m_partectorNumberEnabled);
-    m_settings.setValue("partectorDiamEnabled", m_partectorDiamEnabled);
-    m_settings.setValue("grimmValueEnabled", m_grimmValueEnabled);
-    m_settings.setValue("co2Enabled", m_co2Enabled);
-    m_settings.setValue("temperatureEnabled", m_temperatureEnabled);
-    m_settings.setValue("humidityEnabled", m_humidityEnabled);
-    m_settings.setValue("pressureEnabled", m_pressureEnabled);
-    m_settings.setValue("altitudeEnabled", m_altitudeEnabled);
+    // The outermost commit notifies once for the whole batch
+    if (--m_updateDepth == 0) {
+        emitThresholdsChanged();
+    }
+}
 
-    m_settings.sync();
+void ThresholdManager::setThresholds(const QVariantMap &values)
+{
+    beginUpdate();
+    for (auto it = values.cbegin(); it != values.cend(); ++it) {
+        if (!setProperty(it.key().toLatin1().constData(), it.value())) {
+            qWarning() << "ThresholdManager: Unknown threshold" << it.key();
+        }
+    }
+    commitUpdate();
 }
 
 // CO2 setters
@@ -163,9 +248,8 @@ void ThresholdManager::setCo2Warning(int value)
 {
     if (m_co2Warning != value) {
         m_co2Warning = value;
-        saveSettings();
+        markDirty("co2Warning");
         emit co2WarningChanged();
-        emit thresholdsChanged();
     }
 }
 
@@ -173,9 +257,8 @@ void ThresholdManager::setCo2Danger(int value)
 {
     if (m_co2Danger != value) {
         m_co2Danger = value;
-        saveSettings();
+        markDirty("co2Danger");
         emit co2DangerChanged();
-        emit thresholdsChanged();
     }
 }
 
@@ -184,9 +267,8 @@ void ThresholdManager::setTemperatureWarning(float value)
 {
     if (!qFuzzyCompare(m_temperatureWarning, value)) {
         m_temperatureWarning = value;
-        saveSettings();
+        markDirty("temperatureWarning");
         emit temperatureWarningChanged();
-        emit thresholdsChanged();
     }
 }
 
@@ -194,9 +276,8 @@ void ThresholdManager::setTemperatureDanger(float value)
 {
     if (!qFuzzyCompare(m_temperatureDanger, value)) {
         m_temperatureDanger = value;
-        saveSettings();
+        markDirty("temperatureDanger");
         emit temperatureDangerChanged();
-        emit thresholdsChanged();
     }
 }
 
@@ -204,9 +285,8 @@ void ThresholdManager::setTemperatureLowWarning(float value)
 {
     if (!qFuzzyCompare(m_temperatureLowWarning, value)) {
         m_temperatureLowWarning = value;
-        saveSettings();
+        markDirty("temperatureLowWarning");
         emit temperatureLowWarningChanged();
-        emit thresholdsChanged();
     }
 }
 
@@ -214,9 +294,8 @@ void ThresholdManager::setTemperatureLowDanger(float value)
 {
     if (!qFuzzyCompare(m_temperatureLowDanger, value)) {
         m_temperatureLowDanger = value;
-        saveSettings();
+        markDirty("temperatureLowDanger");
         emit temperatureLowDangerChanged();
-        emit thresholdsChanged();
     }
 }
 
@@ -225,9 +304,8 @@ void ThresholdManager::setHumidityWarning(float value)
 {
     if (!qFuzzyCompare(m_humidityWarning, value)) {
         m_humidityWarning = value;
-        saveSettings();
+        markDirty("humidityWarning");
         emit humidityWarningChanged();
-        emit thresholdsChanged();
     }
 }
 
@@ -235,9 +313,8 @@ void ThresholdManager::setHumidityDanger(float value)
 {
     if (!qFuzzyCompare(m_humidityDanger, value)) {
         m_humidityDanger = value;
-        saveSettings();
+        markDirty("humidityDanger");
         emit humidityDangerChanged();
-        emit thresholdsChanged();
     }
 }
 
@@ -245,9 +322,8 @@ void ThresholdManager::setHumidityLowWarning(float value)
 {
     if (!qFuzzyCompare(m_humidityLowWarning, value)) {
         m_humidityLowWarning = value;
-        saveSettings();
+        markDirty("humidityLowWarning");
         emit humidityLowWarningChanged();
-        emit thresholdsChanged();
     }
 }
 
@@ -255,9 +331,8 @@ void ThresholdManager::setHumidityLowDanger(float value)
 {
     if (!qFuzzyCompare(m_humidityLowDanger, value)) {
         m_humidityLowDanger = value;
-        saveSettings();
+        markDirty("humidityLowDanger");
         emit humidityLowDangerChanged();
-        emit thresholdsChanged();
     }
 }
 
@@ -266,9 +341,8 @@ void ThresholdManager::setPartectorMassWarning(float value)
 {
     if (!qFuzzyCompare(m_partectorMassWarning, value)) {
         m_partectorMassWarning = value;
-        saveSettings();
+        markDirty("partectorMassWarning");
         emit partectorMassWarningChanged();
-        emit thresholdsChanged();
     }
 }
 
@@ -276,9 +350,8 @@ void ThresholdManager::setPartectorMassDanger(float value)
 {
     if (!qFuzzyCompare(m_partectorMassDanger, value)) {
         m_partectorMassDanger = value;
-        saveSettings();
+        markDirty("partectorMassDanger");
         emit partectorMassDangerChanged();
-        emit thresholdsChanged();
     }
 }
 
@@ -287,9 +360,8 @@ void ThresholdManager::setGrimmValueWarning(float value)
 {
     if (!qFuzzyCompare(m_grimmValueWarning, value)) {
         m_grimmValueWarning = value;
-        saveSettings();
+        markDirty("grimmValueWarning");
         emit grimmValueWarningChanged();
-        emit thresholdsChanged();
     }
 }
 
@@ -297,9 +369,8 @@ void ThresholdManager::setGrimmValueDanger(float value)
 {
     if (!qFuzzyCompare(m_grimmValueDanger, value)) {
         m_grimmValueDanger = value;
-        saveSettings();
+        markDirty("grimmValueDanger");
         emit grimmValueDangerChanged();
-        emit thresholdsChanged();
     }
 }
 
@@ -308,9 +379,8 @@ void ThresholdManager::setPartectorNumberWarning(int value)
 {
     if (m_partectorNumberWarning != value) {
         m_partectorNumberWarning = value;
-        saveSettings();
+        markDirty("partectorNumberWarning");
         emit partectorNumberWarningChanged();
-        emit thresholdsChanged();
     }
 }
 
@@ -318,9 +388,8 @@ void ThresholdManager::setPartectorNumberDanger(int value)
 {
     if (m_partectorNumberDanger != value) {
         m_partectorNumberDanger = value;
-        saveSettings();
+        markDirty("partectorNumberDanger");
         emit partectorNumberDangerChanged();
-        emit thresholdsChanged();
     }
 }
 
@@ -329,9 +398,8 @@ void ThresholdManager::setPartectorDiamWarning(int value)
 {
     if (m_partectorDiamWarning != value) {
         m_partectorDiamWarning = value;
-        saveSettings();
+        markDirty("partectorDiamWarning");
         emit partectorDiamWarningChanged();
-        emit thresholdsChanged();
     }
 }
 
@@ -339,9 +407,8 @@ void ThresholdManager::setPartectorDiamDanger(int value)
 {
     if (m_partectorDiamDanger != value) {
         m_partectorDiamDanger = value;
-        saveSettings();
+        markDirty("partectorDiamDanger");
         emit partectorDiamDangerChanged();
-        emit thresholdsChanged();
     }
 }
 
@@ -350,9 +417,8 @@ void ThresholdManager::setPressureWarning(float value)
 {
     if (!qFuzzyCompare(m_pressureWarning, value)) {
         m_pressureWarning = value;
-        saveSettings();
+        markDirty("pressureWarning");
         emit pressureWarningChanged();
-        emit thresholdsChanged();
     }
 }
 
@@ -360,9 +426,8 @@ void ThresholdManager::setPressureDanger(float value)
 {
     if (!qFuzzyCompare(m_pressureDanger, value)) {
         m_pressureDanger = value;
-        saveSettings();
+        markDirty("pressureDanger");
         emit pressureDangerChanged();
-        emit thresholdsChanged();
     }
 }
 
@@ -371,9 +436,8 @@ void ThresholdManager::setAltitudeWarning(float value)
 {
     if (!qFuzzyCompare(m_altitudeWarning, value)) {
         m_altitudeWarning = value;
-        saveSettings();
+        markDirty("altitudeWarning");
         emit altitudeWarningChanged();
-        emit thresholdsChanged();
     }
 }
 
@@ -381,9 +445,8 @@ void ThresholdManager::setAltitudeDanger(float value)
 {
     if (!qFuzzyCompare(m_altitudeDanger, value)) {
         m_altitudeDanger = value;
-        saveSettings();
+        markDirty("altitudeDanger");
         emit altitudeDangerChanged();
-        emit thresholdsChanged();
     }
 }
 
@@ -392,9 +455,8 @@ void ThresholdManager::setPartectorMassEnabled(bool value)
 {
     if (m_partectorMassEnabled != value) {
         m_partectorMassEnabled = value;
-        saveSettings();
+        markDirty("partectorMassEnabled");
         emit partectorMassEnabledChanged();
-        emit thresholdsChanged();
     }
 }
 
@@ -402,9 +464,8 @@ void ThresholdManager::setPartectorNumberEnabled(bool value)
 {
     if (m_partectorNumberEnabled != value) {
         m_partectorNumberEnabled = value;
-        saveSettings();
+        markDirty("partectorNumberEnabled");
         emit partectorNumberEnabledChanged();
-        emit thresholdsChanged();
     }
 }
 
@@ -412,9 +473,8 @@ void ThresholdManager::setPartectorDiamEnabled(bool value)
 {
     if (m_partectorDiamEnabled != value) {
         m_partectorDiamEnabled = value;
-        saveSettings();
+        markDirty("partectorDiamEnabled");
         emit partectorDiamEnabledChanged();
-        emit thresholdsChanged();
     }
 }
 
@@ -422,9 +482,8 @@ void ThresholdManager::setGrimmValueEnabled(bool value)
 {
     if (m_grimmValueEnabled != value) {
         m_grimmValueEnabled = value;
-        saveSettings();
+        markDirty("grimmValueEnabled");
         emit grimmValueEnabledChanged();
-        emit thresholdsChanged();
     }
 }
 
@@ -432,9 +491,8 @@ void ThresholdManager::setCo2Enabled(bool value)
 {
     if (m_co2Enabled != value) {
         m_co2Enabled = value;
-        saveSettings();
+        markDirty("co2Enabled");
         emit co2EnabledChanged();
-        emit thresholdsChanged();
     }
 }
 
@@ -442,9 +500,8 @@ void ThresholdManager::setTemperatureEnabled(bool value)
 {
     if (m_temperatureEnabled != value) {
         m_temperatureEnabled = value;
-        saveSettings();
+        markDirty("temperatureEnabled");
         emit temperatureEnabledChanged();
-        emit thresholdsChanged();
     }
 }
 
@@ -452,9 +509,8 @@ void ThresholdManager::setHumidityEnabled(bool value)
 {
     if (m_humidityEnabled != value) {
         m_humidityEnabled = value;
-        saveSettings();
+        markDirty("humidityEnabled");
         emit humidityEnabledChanged();
-        emit thresholdsChanged();
     }
 }
 
@@ -462,9 +518,8 @@ void ThresholdManager::setPressureEnabled(bool value)
 {
     if (m_pressureEnabled != value) {
         m_pressureEnabled = value;
-        saveSettings();
+        markDirty("pressureEnabled");
         emit pressureEnabledChanged();
-        emit thresholdsChanged();
     }
 }
 
@@ -472,12 +527,49 @@ void ThresholdManager::setAltitudeEnabled(bool value)
 {
     if (m_altitudeEnabled != value) {
         m_altitudeEnabled = value;
-        saveSettings();
+        markDirty("altitudeEnabled");
         emit altitudeEnabledChanged();
-        emit thresholdsChanged();
     }
 }
 
+// Compile the threshold properties into the flat rule table
+void ThresholdManager::compileRules()
+{
+    auto rule = [](ReadingColumns::Sensor sensor, ThresholdRule::Direction direction,
+                   bool enabled, double warning, double danger) {
+        ThresholdRule r;
+        r.sensor = quint8(sensor);
+        r.direction = direction;
+        r.enabled = enabled;
+        r.warning = warning;
+        r.danger = danger;
+        return r;
+    };
+
+    m_rules.clear();
+    m_rules.add(rule(ReadingColumns::Co2, ThresholdRule::Above, m_co2Enabled, m_co2Warning, m_co2Danger));
+    m_rules.add(rule(ReadingColumns::Temperature, ThresholdRule::Above, m_temperatureEnabled,
+                     m_temperatureWarning, m_temperatureDanger));
+    m_rules.add(rule(ReadingColumns::Temperature, ThresholdRule::Below, m_temperatureEnabled,
+                     m_temperatureLowWarning, m_temperatureLowDanger));
+    m_rules.add(rule(ReadingColumns::Humidity, ThresholdRule::Above, m_humidityEnabled,
+                     m_humidityWarning, m_humidityDanger));
+    m_rules.add(rule(ReadingColumns::Humidity, ThresholdRule::Below, m_humidityEnabled,
+                     m_humidityLowWarning, m_humidityLowDanger));
+    m_rules.add(rule(ReadingColumns::PartectorMass, ThresholdRule::Above, m_partectorMassEnabled,
+                     m_partectorMassWarning, m_partectorMassDanger));
+    m_rules.add(rule(ReadingColumns::GrimmValue, ThresholdRule::Above, m_grimmValueEnabled,
+                     m_grimmValueWarning, m_grimmValueDanger));
+    m_rules.add(rule(ReadingColumns::PartectorNumber, ThresholdRule::Above, m_partectorNumberEnabled,
+                     m_partectorNumberWarning, m_partectorNumberDanger));
+    m_rules.add(rule(ReadingColumns::PartectorDiam, ThresholdRule::Above, m_partectorDiamEnabled,
+                     m_partectorDiamWarning, m_partectorDiamDanger));
+    m_rules.add(rule(ReadingColumns::Pressure, ThresholdRule::Above, m_pressureEnabled,
+                     m_pressureWarning, m_pressureDanger));
+    m_rules.add(rule(ReadingColumns::Altitude, ThresholdRule::Above, m_altitudeEnabled,
+                     m_altitudeWarning, m_altitudeDanger));
+}
+
 // Compute hazard level based on all sensor values
 // Disabled sensors are skipped and do not contribute to hazard level
 int ThresholdManager::computeHazardLevel(int partectorNumber, int partectorDiam,
@@ -485,102 +577,23 @@ int ThresholdManager::computeHazardLevel(int partectorNumber, int partectorDiam,
                                           float temperature, float humidity,
                                           float pressure, float altitude, int co2)
 {
-    int maxLevel = Green;
-
-    // Check CO2 (only if enabled)
-    if (m_co2Enabled) {
-        if (co2 >= m_co2Danger) {
-            maxLevel = qMax(maxLevel, static_cast<int>(Red));
-        } else if (co2 >= m_co2Warning) {
-            maxLevel = qMax(maxLevel, static_cast<int>(Yellow));
-        }
-    }
-
-    // Check Temperature (both high and low, only if enabled)
-    if (m_temperatureEnabled) {
-        if (temperature >= m_temperatureDanger) {
-            maxLevel = qMax(maxLevel, static_cast<int>(Red));
-        } else if (temperature >= m_temperatureWarning) {
-            maxLevel = qMax(maxLevel, static_cast<int>(Yellow));
-        }
-        // Temperature LOW thresholds (inverted - lower is worse)
-        if (temperature <= m_temperatureLowDanger) {
-            maxLevel = qMax(maxLevel, static_cast<int>(Red));
-        } else if (temperature <= m_temperatureLowWarning) {
-            maxLevel = qMax(maxLevel, static_cast<int>(Yellow));
-        }
-    }
-
-    // Check Humidity (both high and low, only if enabled)
-    if (m_humidityEnabled) {
-        if (humidity >= m_humidityDanger) {
-            maxLevel = qMax(maxLevel, static_cast<int>(Red));
-        } else if (humidity >= m_humidityWarning) {
-            maxLevel = qMax(maxLevel, static_cast<int>(Yellow));
-        }
-        // Humidity LOW thresholds (inverted - lower is worse)
-        if (humidity <= m_humidityLowDanger) {
-            maxLevel = qMax(maxLevel, static_cast<int>(Red));
-        } else if (humidity <= m_humidityLowWarning) {
-            maxLevel = qMax(maxLevel, static_cast<int>(Yellow));
-        }
-    }
-
-    // Check PartectorMass (only if enabled)
-    if (m_partectorMassEnabled) {
-        if (partectorMass >= m_partectorMassDanger) {
-            maxLevel = qMax(maxLevel, static_cast<int>(Red));
-        } else if (partectorMass >= m_partectorMassWarning) {
-            maxLevel = qMax(maxLevel, static_cast<int>(Yellow));
-        }
-    }
-
-    // Check GrimmValue (only if enabled)
-    if (m_grimmValueEnabled) {
-        if (grimmValue >= m_grimmValueDanger) {
-            maxLevel = qMax(maxLevel, static_cast<int>(Red));
-        } else if (grimmValue >= m_grimmValueWarning) {
-            maxLevel = qMax(maxLevel, static_cast<int>(Yellow));
-        }
-    }
-
-    // Check PartectorNumber (only if enabled)
-    if (m_partectorNumberEnabled) {
-        if (partectorNumber >= m_partectorNumberDanger) {
-            maxLevel = qMax(maxLevel, static_cast<int>(Red));
-        } else if (partectorNumber >= m_partectorNumberWarning) {
-            maxLevel = qMax(maxLevel, static_cast<int>(Yellow));
-        }
-    }
-
-    // Check PartectorDiam (only if enabled)
-    if (m_partectorDiamEnabled) {
-        if (partectorDiam >= m_partectorDiamDanger) {
-            maxLevel = qMax(maxLevel, static_cast<int>(Red));
-        } else if (partectorDiam >= m_partectorDiamWarning) {
-            maxLevel = qMax(maxLevel, static_cast<int>(Yellow));
-        }
-    }
-
-    // Check Pressure (only if enabled)
-    if (m_pressureEnabled) {
-        if (pressure >= m_pressureDanger) {
-            maxLevel = qMax(maxLevel, static_cast<int>(Red));
-        } else if (pressure >= m_pressureWarning) {
-            maxLevel = qMax(maxLevel, static_cast<int>(Yellow));
-        }
-    }
-
-    // Check Altitude (only if enabled)
-    if (m_altitudeEnabled) {
-        if (altitude >= m_altitudeDanger) {
-            maxLevel = qMax(maxLevel, static_cast<int>(Red));
-        } else if (altitude >= m_altitudeWarning) {
-            maxLevel = qMax(maxLevel, static_cast<int>(Yellow));
-        }
-    }
+    std::array<double, ReadingColumns::SensorCount> values;
+    values[ReadingColumns::PartectorNumber] = partectorNumber;
+    values[ReadingColumns::PartectorDiam] = partectorDiam;
+    values[ReadingColumns::PartectorMass] = partectorMass;
+    values[ReadingColumns::GrimmValue] = grimmValue;
+    values[ReadingColumns::Temperature] = temperature;
+    values[ReadingColumns::Humidity] = humidity;
+    values[ReadingColumns::Pressure] = pressure;
+    values[ReadingColumns::Altitude] = altitude;
+    values[ReadingColumns::Co2] = co2;
+    return m_rules.evaluate(values);
+}
 
-    return maxLevel;
+void ThresholdManager::computeHazardLevels(const ReadingColumns &columns, qsizetype from, qsizetype count,
+                                           quint8 *levels) const
+{
+    m_rules.evaluateBatch(columns, from, count, levels);
 }
 
 // Reset all thresholds and enabled states to defaults (from CONTEXT.md)
@@ -623,8 +636,13 @@ void ThresholdManager::resetToDefaults()
     m_pressureEnabled = false;
     m_altitudeEnabled = false;
 
-    // Save and notify
-    saveSettings();
+    compileRules();
+
+    // Persist everything on the next save and notify once below
+    for (const char *key : SETTINGS_KEYS) {
+        m_dirtyKeys.insert(QString::fromLatin1(key));
+    }
+    m_saveTimer.start();
 
     // Emit all changed signals
     emit partectorMassWarningChanged();
@@ -658,7 +676,7 @@ void ThresholdManager::resetToDefaults()
     emit humidityEnabledChanged();
     emit pressureEnabledChanged();
     emit altitudeEnabledChanged();
-    emit thresholdsChanged();
+    scheduleThresholdsChanged();
 
     qDebug() << "ThresholdManager: Reset to defaults complete";
 }
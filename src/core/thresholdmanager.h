@@ -4,6 +4,12 @@
 #include <QObject>
 #include <QQmlEngine>
 #include <QSettings>
+#include <QSet>
+#include <QThread>
+#include <QTimer>
+#include <QVariantMap>
+#include "readingcolumns.h"
+#include "thresholdrule.h"
 
 class ThresholdManager : public QObject
 {
@@ -63,6 +69,7 @@ public:
     Q_ENUM(HazardLevel)
 
     explicit ThresholdManager(QObject *parent = nullptr);
+    ~ThresholdManager() override;
 
     // Static instance access for C++
     static ThresholdManager* instance();
@@ -155,9 +162,24 @@ public:
                                        float temperature, float humidity,
                                        float pressure, float altitude, int co2);
 
+    // Bulk variant: levels[i] = hazard level of columns row (from + i), for count rows.
+    // Evaluates the compiled rule table column by column (see ThresholdRuleSet).
+    void computeHazardLevels(const ReadingColumns &columns, qsizetype from, qsizetype count,
+                             quint8 *levels) const;
+
     // Reset all thresholds and enabled states to defaults
     Q_INVOKABLE void resetToDefaults();
 
+    // Batched updates: setters between beginUpdate() and the matching
+    // commitUpdate() emit their own property signals, but thresholdsChanged
+    // is emitted once, on the outermost commit. Calls may nest.
+    Q_INVOKABLE void beginUpdate();
+    Q_INVOKABLE void commitUpdate();
+
+    // Apply several thresholds at once, keyed by property name
+    // (e.g. { co2Warning: 900, co2Danger: 1800 })
+    Q_INVOKABLE void setThresholds(const QVariantMap &values);
+
 signals:
     void co2WarningChanged();
     void co2DangerChanged();
@@ -196,11 +218,26 @@ signals:
 
 private:
     void loadSettings();
-    void saveSettings();
+    // Snapshots only the dirty keys; QSettings writes them on m_settingsThread
+    void saveSettings(Qt::ConnectionType type = Qt::QueuedConnection);
+    void markDirty(const char *key);
+    void scheduleThresholdsChanged();
+    void emitThresholdsChanged();
+    void compileRules();  // Call after any threshold or enabled flag changes
 
     static ThresholdManager* s_instance;
 
-    QSettings m_settings;
+    QSettings m_settings;  // Loading only
+    QSet<QString> m_dirtyKeys;
+    QThread m_settingsThread;
+    QObject *m_settingsWriter = nullptr;  // Lives on m_settingsThread
+    QTimer m_saveTimer;
+    QTimer m_notifyTimer;
+    int m_updateDepth = 0;
+    bool m_thresholdsPending = false;
+
+    // Enabled thresholds as a flat table; rebuilt on every change
+    ThresholdRuleSet m_rules;
 
     // Member variables for all thresholds
     int m_co2Warning;
@@ -0,0 +1,72 @@
+#include "thresholdrule.h"
+#include <algorithm>
+#include <type_traits>
+
+// Raise levels to Yellow/Red where values reach warning/danger (danger wins)
+template <typename Value>
+static void raiseLevelsAbove(const Value *values, qsizetype count,
+                             Value warning, Value danger, quint8 *levels)
+{
+    for (qsizetype i = 0; i < count; ++i) {
+        // Separate int flags: with the quint8 casts inline GCC keeps a branch per
+        // element on float columns and does not vectorize the loop
+        const int isDanger = values[i] >= danger;
+        const int isWarning = values[i] >= warning;
+        const quint8 level = quint8(qMax(isDanger * 2, isWarning));
+        levels[i] = qMax(levels[i], level);
+    }
+}
+
+// Inverted variant for the LOW thresholds (lower is worse)
+template <typename Value>
+static void raiseLevelsBelow(const Value *values, qsizetype count,
+                             Value warning, Value danger, quint8 *levels)
+{
+    for (qsizetype i = 0; i < count; ++i) {
+        const int isDanger = values[i] <= danger;
+        const int isWarning = values[i] <= warning;
+        const quint8 level = quint8(qMax(isDanger * 2, isWarning));
+        levels[i] = qMax(levels[i], level);
+    }
+}
+
+void ThresholdRuleSet::add(const ThresholdRule &rule)
+{
+    if (rule.enabled && rule.sensor < ReadingColumns::SensorCount) {
+        m_rules.append(rule);
+    }
+}
+
+void ThresholdRuleSet::evaluateBatch(const ReadingColumns &columns, qsizetype from, qsizetype count,
+                                     quint8 *levels) const
+{
+    std::fill(levels, levels + count, quint8(0));
+
+    for (const ThresholdRule &rule : m_rules) {
+        columns.visitSensor(rule.sensor, [&](const auto &column) {
+            // Compare in the column's own type: thresholds were set from that type,
+            // and float columns keep their full SIMD width
+            using Value = typename std::decay_t<decltype(column)>::value_type;
+            const Value *values = column.constData() + from;
+            if (rule.direction == ThresholdRule::Above) {
+                raiseLevelsAbove(values, count, Value(rule.warning), Value(rule.danger), levels);
+            } else {
+                raiseLevelsBelow(values, count, Value(rule.warning), Value(rule.danger), levels);
+            }
+        });
+    }
+}
+
+int ThresholdRuleSet::evaluate(const std::array<double, ReadingColumns::SensorCount> &values) const
+{
+    int level = 0;
+    for (const ThresholdRule &rule : m_rules) {
+        const double value = values[rule.sensor];
+        if (rule.direction == ThresholdRule::Above) {
+            level = qMax(level, value >= rule.danger ? 2 : value >= rule.warning ? 1 : 0);
+        } else {
+            level = qMax(level, value <= rule.danger ? 2 : value <= rule.warning ? 1 : 0);
+        }
+    }
+    return level;
+}
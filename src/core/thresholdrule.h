@@ -0,0 +1,50 @@
+#ifndef THRESHOLDRULE_H
+#define THRESHOLDRULE_H
+
+#include <QList>
+#include <QtGlobal>
+#include <array>
+#include "readingcolumns.h"
+
+// One hazard rule: a sensor column, a comparison direction and the two
+// thresholds. A reading is Yellow when it reaches warning and Red when it
+// reaches danger; the level of a reading is the maximum over all rules.
+struct ThresholdRule
+{
+    enum Direction : quint8 {
+        Above,  // value >= threshold is worse
+        Below   // value <= threshold is worse
+    };
+
+    quint8 sensor = ReadingColumns::PartectorNumber;  // ReadingColumns::Sensor
+    Direction direction = Above;
+    bool enabled = true;
+    double warning = 0.0;
+    double danger = 0.0;
+};
+
+// Flat table of enabled rules, evaluated rule by rule over contiguous columns.
+// Adding a sensor or a second band for an existing one is a table entry, not
+// another branch in the evaluator.
+class ThresholdRuleSet
+{
+public:
+    void clear() { m_rules.clear(); }
+    // Disabled rules are dropped here, so evaluation never tests the flag
+    void add(const ThresholdRule &rule);
+
+    const QList<ThresholdRule> &rules() const { return m_rules; }
+
+    // levels[i] = hazard level of columns row (from + i), for count rows.
+    // Comparisons are branch-free, so the per-rule loops auto-vectorize.
+    void evaluateBatch(const ReadingColumns &columns, qsizetype from, qsizetype count,
+                       quint8 *levels) const;
+
+    // Single reading, values indexed by ReadingColumns::Sensor
+    int evaluate(const std::array<double, ReadingColumns::SensorCount> &values) const;
+
+private:
+    QList<ThresholdRule> m_rules;
+};
+
+#endif // THRESHOLDRULE_H
@@ -1,19 +1,49 @@
 #include "csvexporter.h"
 
-#include <QFile>
-#include <QFileInfo>
-#include <QTextStream>
+#include <QCoreApplication>
 #include <QDebug>
 
 CsvExporter::CsvExporter(QObject *parent)
     : QObject(parent)
 {
+    // File I/O runs on the writer thread
+    m_writer = new CsvWriter;
+    m_writer->moveToThread(&m_writerThread);
+    connect(&m_writerThread, &QThread::finished, m_writer, &QObject::deleteLater);
+    connect(m_writer, &CsvWriter::exportError, this, &CsvExporter::exportError);
+    connect(m_writer, &CsvWriter::segmentOpened, this, [this](const QString &path) {
+        m_currentFilePath = path;
+        emit currentFilePathChanged();
+    });
+    connect(m_writer, &CsvWriter::statsChanged, this, [this](qint64 bytesWritten, qint64 bytesOnDisk) {
+        m_bytesWritten = bytesWritten;
+        m_bytesOnDisk = bytesOnDisk;
+        emit statsChanged();
+    });
+    m_writerThread.setObjectName("CsvWriter");
+    m_writerThread.start();
+
+    // Never lose buffered rows on shutdown
+    connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, [this]() {
+        post([](CsvWriter *writer) { writer->close(); });
+    });
+}
+
+CsvExporter::~CsvExporter()
+{
+    // Flush, fsync and close the file on its own thread
+    QMetaObject::invokeMethod(m_writer, [writer = m_writer]() {
+        writer->close();
+    }, Qt::BlockingQueuedConnection);
+    m_writerThread.quit();
+    m_writerThread.wait();
 }
 
 void CsvExporter::setEnabled(bool enabled)
 {
     if (m_enabled != enabled) {
         m_enabled = enabled;
+        updateWriter();
         emit enabledChanged();
         qDebug() << "CsvExporter: enabled =" << m_enabled;
     }
@@ -23,57 +53,115 @@ void CsvExporter::setFilePath(const QString &path)
 {
     if (m_filePath != path) {
         m_filePath = path;
+        updateWriter();
         emit filePathChanged();
         qDebug() << "CsvExporter: filePath =" << m_filePath;
     }
 }
 
-void CsvExporter::setFilePathFromUrl(const QUrl &url)
+void CsvExporter::setFlushBytes(int bytes)
 {
-    setFilePath(url.toLocalFile());
+    bytes = qMax(0, bytes);
+    if (m_flushBytes != bytes) {
+        m_flushBytes = bytes;
+        post([bytes](CsvWriter *writer) { writer->setFlushBytes(bytes); });
+        emit flushBytesChanged();
+    }
 }
 
-void CsvExporter::appendReading(const SensorReading &reading)
+void CsvExporter::setFlushIntervalMs(int ms)
 {
-    if (!m_enabled || m_filePath.isEmpty()) {
+    ms = qMax(0, ms);
+    if (m_flushIntervalMs != ms) {
+        m_flushIntervalMs = ms;
+        post([ms](CsvWriter *writer) { writer->setFlushIntervalMs(ms); });
+        emit flushIntervalMsChanged();
+    }
+}
+
+void CsvExporter::setRotateBytes(qint64 bytes)
+{
+    bytes = qMax<qint64>(0, bytes);
+    if (m_rotateBytes != bytes) {
+        m_rotateBytes = bytes;
+        updateRotation();
+    }
+}
+
+void CsvExporter::setRotateIntervalMinutes(int minutes)
+{
+    minutes = qMax(0, minutes);
+    if (m_rotateIntervalMinutes != minutes) {
+        m_rotateIntervalMinutes = minutes;
+        updateRotation();
+    }
+}
+
+void CsvExporter::updateRotation()
+{
+    post([bytes = m_rotateBytes, ms = qint64(m_rotateIntervalMinutes) * 60 * 1000](CsvWriter *writer) {
+        writer->setRotation(bytes, ms);
+    });
+    // Turning rotation on or off changes the file name, so restart the export
+    updateWriter();
+    emit rotationChanged();
+}
+
+void CsvExporter::setCompressionEnabled(bool enabled)
+{
+    if (enabled && !CsvWriter::compressionAvailable()) {
+        qWarning() << "CsvExporter: Compression requested but this build has no zlib";
         return;
     }
+    if (m_compressionEnabled != enabled) {
+        m_compressionEnabled = enabled;
+        post([enabled](CsvWriter *writer) { writer->setCompressionEnabled(enabled); });
+        updateWriter();
+        emit compressionEnabledChanged();
+    }
+}
+
+double CsvExporter::compressionRatio() const
+{
+    return m_bytesOnDisk > 0 ? double(m_bytesWritten) / double(m_bytesOnDisk) : 1.0;
+}
+
+void CsvExporter::setFilePathFromUrl(const QUrl &url)
+{
+    setFilePath(url.toLocalFile());
+}
 
-    // Check if file exists and has content before opening
-    QFileInfo fileInfo(m_filePath);
-    bool needsHeader = !fileInfo.exists() || fileInfo.size() == 0;
+void CsvExporter::updateWriter()
+{
+    m_accepting = m_enabled && !m_filePath.isEmpty();
+    if (m_accepting) {
+        post([path = m_filePath](CsvWriter *writer) { writer->open(path); });
+    } else {
+        post([](CsvWriter *writer) { writer->close(); });
+        m_currentFilePath.clear();
+        emit currentFilePathChanged();
+    }
+}
 
-    QFile file(m_filePath);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
-        QString error = QString("Failed to open CSV file: %1").arg(file.errorString());
-        qWarning() << "CsvExporter:" << error;
-        emit exportError(error);
+void CsvExporter::appendReading(const SensorReading &reading)
+{
+    if (!m_accepting) {
         return;
     }
 
-    QTextStream stream(&file);
+    post([reading](CsvWriter *writer) { writer->append(reading); });
+}
 
-    // Write header if this is a new/empty file
-    if (needsHeader) {
-        stream << "timestamp,partector_number,partector_diam,partector_mass,"
-               << "grimm_value,temperature,humidity,pressure,"
-               << "altitude,latitude,longitude,co2\n";
+void CsvExporter::appendReadings(const QList<SensorReading> &readings)
+{
+    if (!m_accepting || readings.isEmpty()) {
+        return;
     }
 
-    // Write data row
-    stream << reading.timestamp.toString(Qt::ISODate) << ","
-           << reading.partectorNumber << ","
-           << reading.partectorDiam << ","
-           << reading.partectorMass << ","
-           << reading.grimmValue << ","
-           << reading.temperature << ","
-           << reading.humidity << ","
-           << reading.pressure << ","
-           << reading.altitude << ","
-           << reading.latitude << ","
-           << reading.longitude << ","
-           << reading.co2 << "\n";
-
-    stream.flush();
-    file.close();
+    // One queued call for the whole batch; the list is shared, not copied
+    post([readings](CsvWriter *writer) {
+        for (const SensorReading &reading : readings) {
+            writer->append(reading);
+        }
+    });
 }
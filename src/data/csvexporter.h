@@ -3,9 +3,14 @@
 
 #include <QObject>
 #include <QQmlEngine>
+#include <QThread>
 #include <QUrl>
+#include <atomic>
 #include "sensorreading.h"
+#include "csvwriter.h"
 
+// GUI-thread facade for live CSV export. The file is owned by a CsvWriter on
+// its own thread; this class only forwards readings and settings to it.
 class CsvExporter : public QObject
 {
     Q_OBJECT
@@ -15,8 +20,25 @@ class CsvExporter : public QObject
     Q_PROPERTY(bool enabled READ isEnabled WRITE setEnabled NOTIFY enabledChanged)
     Q_PROPERTY(QString filePath READ filePath WRITE setFilePath NOTIFY filePathChanged)
 
+    // Buffered rows are written after flushBytes bytes or flushIntervalMs, whichever comes first
+    Q_PROPERTY(int flushBytes READ flushBytes WRITE setFlushBytes NOTIFY flushBytesChanged)
+    Q_PROPERTY(int flushIntervalMs READ flushIntervalMs WRITE setFlushIntervalMs NOTIFY flushIntervalMsChanged)
+
+    // Rotation into timestamped segments next to filePath; 0 disables a limit
+    Q_PROPERTY(qint64 rotateBytes READ rotateBytes WRITE setRotateBytes NOTIFY rotationChanged)
+    Q_PROPERTY(int rotateIntervalMinutes READ rotateIntervalMinutes WRITE setRotateIntervalMinutes NOTIFY rotationChanged)
+    // Streaming gzip; only available when the build found zlib
+    Q_PROPERTY(bool compressionEnabled READ compressionEnabled WRITE setCompressionEnabled NOTIFY compressionEnabledChanged)
+    Q_PROPERTY(bool compressionAvailable READ compressionAvailable CONSTANT)
+
+    // Monitoring, since export was (re)started
+    Q_PROPERTY(QString currentFilePath READ currentFilePath NOTIFY currentFilePathChanged)
+    Q_PROPERTY(qint64 bytesWritten READ bytesWritten NOTIFY statsChanged)
+    Q_PROPERTY(double compressionRatio READ compressionRatio NOTIFY statsChanged)
+
 public:
     explicit CsvExporter(QObject *parent = nullptr);
+    ~CsvExporter();
 
     bool isEnabled() const { return m_enabled; }
     void setEnabled(bool enabled);
@@ -24,19 +46,75 @@ public:
     QString filePath() const { return m_filePath; }
     void setFilePath(const QString &path);
 
+    int flushBytes() const { return m_flushBytes; }
+    void setFlushBytes(int bytes);
+    int flushIntervalMs() const { return m_flushIntervalMs; }
+    void setFlushIntervalMs(int ms);
+
+    qint64 rotateBytes() const { return m_rotateBytes; }
+    void setRotateBytes(qint64 bytes);
+    int rotateIntervalMinutes() const { return m_rotateIntervalMinutes; }
+    void setRotateIntervalMinutes(int minutes);
+    bool compressionEnabled() const { return m_compressionEnabled; }
+    void setCompressionEnabled(bool enabled);
+    bool compressionAvailable() const { return CsvWriter::compressionAvailable(); }
+
+    QString currentFilePath() const { return m_currentFilePath; }
+    qint64 bytesWritten() const { return m_bytesWritten; }
+    // CSV bytes per byte on disk; 1.0 without compression
+    double compressionRatio() const;
+
     Q_INVOKABLE void setFilePathFromUrl(const QUrl &url);
 
 public slots:
+    // Safe to call from any thread; ignored while export is off
     void appendReading(const SensorReading &reading);
+    void appendReadings(const QList<SensorReading> &readings);
 
 signals:
     void enabledChanged();
     void filePathChanged();
+    void flushBytesChanged();
+    void flushIntervalMsChanged();
+    void rotationChanged();
+    void compressionEnabledChanged();
+    void currentFilePathChanged();
+    void statsChanged();
     void exportError(const QString &message);
 
 private:
+    // Open or close the writer's file to match enabled/filePath
+    void updateWriter();
+    void updateRotation();
+
+    // Fire-and-forget call on the writer thread
+    template <typename Function>
+    void post(Function function);
+
+    QThread m_writerThread;
+    CsvWriter *m_writer;
+
     bool m_enabled = false;
     QString m_filePath;
+    // enabled with a file path; read by appendReading(s) from other threads
+    std::atomic<bool> m_accepting = false;
+    int m_flushBytes = 64 * 1024;
+    int m_flushIntervalMs = 1000;
+    qint64 m_rotateBytes = 0;
+    int m_rotateIntervalMinutes = 0;
+    bool m_compressionEnabled = false;
+
+    QString m_currentFilePath;
+    qint64 m_bytesWritten = 0;
+    qint64 m_bytesOnDisk = 0;
 };
 
+template <typename Function>
+void CsvExporter::post(Function function)
+{
+    QMetaObject::invokeMethod(m_writer, [writer = m_writer, function]() {
+        function(writer);
+    }, Qt::QueuedConnection);
+}
+
 #endif // CSVEXPORTER_H
@@ -0,0 +1,89 @@
+#include "csvformat.h"
+
+#include <charconv>
+
+static const char CSV_HEADER[] =
+    "timestamp,partector_number,partector_diam,partector_mass,"
+    "grimm_value,temperature,humidity,pressure,"
+    "altitude,latitude,longitude,co2,device_id\n";
+
+// Longest possible row: ISO timestamp, 4 ints and 8 floats plus separators
+static constexpr int MAX_ROW_LENGTH = 512;
+
+// Zero-padded unsigned field of fixed width
+static char *writePadded(char *out, int value, int width)
+{
+    for (int i = width - 1; i >= 0; --i) {
+        out[i] = char('0' + value % 10);
+        value /= 10;
+    }
+    return out + width;
+}
+
+template <typename Number>
+static char *writeNumber(char *out, char *end, Number value)
+{
+    // Shortest representation that reads back to the same value
+    return std::to_chars(out, end, value).ptr;
+}
+
+void appendCsvHeader(QByteArray &buffer)
+{
+    buffer.append(CSV_HEADER, sizeof(CSV_HEADER) - 1);
+}
+
+bool isCsvHeader(const QByteArray &line)
+{
+    return line.trimmed() == QByteArray::fromRawData(CSV_HEADER, sizeof(CSV_HEADER) - 2);
+}
+
+void appendCsvRow(QByteArray &buffer, const SensorReading &reading)
+{
+    char row[MAX_ROW_LENGTH];
+    char *const end = row + MAX_ROW_LENGTH;
+    char *p = row;
+
+    // Same layout as QDateTime::toString(Qt::ISODate) for local time
+    const QDateTime timestamp = reading.timestamp();
+    const QDate date = timestamp.date();
+    const QTime time = timestamp.time();
+    p = writePadded(p, date.year(), 4);
+    *p++ = '-';
+    p = writePadded(p, date.month(), 2);
+    *p++ = '-';
+    p = writePadded(p, date.day(), 2);
+    *p++ = 'T';
+    p = writePadded(p, time.hour(), 2);
+    *p++ = ':';
+    p = writePadded(p, time.minute(), 2);
+    *p++ = ':';
+    p = writePadded(p, time.second(), 2);
+
+    *p++ = ',';
+    p = writeNumber(p, end, reading.partectorNumber);
+    *p++ = ',';
+    p = writeNumber(p, end, reading.partectorDiam);
+    *p++ = ',';
+    p = writeNumber(p, end, reading.partectorMass);
+    *p++ = ',';
+    p = writeNumber(p, end, reading.grimmValue);
+    *p++ = ',';
+    p = writeNumber(p, end, reading.temperature);
+    *p++ = ',';
+    p = writeNumber(p, end, reading.humidity);
+    *p++ = ',';
+    p = writeNumber(p, end, reading.pressure);
+    *p++ = ',';
+    p = writeNumber(p, end, reading.altitude);
+    *p++ = ',';
+    p = writeNumber(p, end, reading.latitude);
+    *p++ = ',';
+    p = writeNumber(p, end, reading.longitude);
+    *p++ = ',';
+    p = writeNumber(p, end, reading.co2);
+    *p++ = ',';
+    p = writeNumber(p, end, reading.deviceId);
+    *p++ = '\n';
+
+    buffer.append(row, p - row);
+}
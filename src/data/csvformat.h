@@ -0,0 +1,14 @@
+#ifndef CSVFORMAT_H
+#define CSVFORMAT_H
+
+#include <QByteArray>
+#include "sensorreading.h"
+
+// CSV layout shared by the live exporter and range exports. Rows are
+// formatted with std::to_chars straight into the caller's buffer.
+void appendCsvHeader(QByteArray &buffer);
+// Whether line, with or without its line ending, is the header written above
+bool isCsvHeader(const QByteArray &line);
+void appendCsvRow(QByteArray &buffer, const SensorReading &reading);
+
+#endif // CSVFORMAT_H
@@ -0,0 +1,330 @@
+#include "csvwriter.h"
+#include "csvformat.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QDebug>
+
+#ifdef ZEPHYRSENSE_HAVE_ZLIB
+#include <zlib.h>
+#else
+struct z_stream_s {};  // Keeps std::unique_ptr<z_stream_s> complete without zlib
+#endif
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+CsvWriter::CsvWriter(QObject *parent)
+    : QObject(parent)
+    , m_flushTimer(new QTimer(this))  // Child, so it follows the writer to its thread
+{
+    // Latency bound for buffered rows
+    m_flushTimer->setSingleShot(true);
+    connect(m_flushTimer, &QTimer::timeout, this, &CsvWriter::flush);
+}
+
+CsvWriter::~CsvWriter()
+{
+    close();
+}
+
+bool CsvWriter::compressionAvailable()
+{
+#ifdef ZEPHYRSENSE_HAVE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool CsvWriter::open(const QString &basePath)
+{
+    close();
+
+    m_basePath = basePath;
+    m_segmentIndex = 0;
+    m_bytesWritten = 0;
+    m_bytesOnDisk = 0;
+    emit statsChanged(m_bytesWritten, m_bytesOnDisk);
+
+    if (!openSegment()) {
+        m_basePath.clear();
+        return false;
+    }
+    return true;
+}
+
+void CsvWriter::close()
+{
+    closeSegment();
+    m_basePath.clear();
+}
+
+void CsvWriter::setFlushBytes(int bytes)
+{
+    m_flushBytes = bytes;
+    if (m_buffer.size() >= m_flushBytes) {
+        flush();
+    }
+}
+
+void CsvWriter::setFlushIntervalMs(int ms)
+{
+    m_flushIntervalMs = ms;
+}
+
+void CsvWriter::setRotation(qint64 maxBytes, qint64 maxIntervalMs)
+{
+    m_rotateBytes = maxBytes;
+    m_rotateIntervalMs = maxIntervalMs;
+}
+
+void CsvWriter::setCompressionEnabled(bool enabled)
+{
+    if (enabled && !compressionAvailable()) {
+        qWarning() << "CsvWriter: Built without zlib, writing uncompressed CSV";
+        enabled = false;
+    }
+    m_compressionEnabled = enabled;
+}
+
+QString CsvWriter::segmentPath() const
+{
+    QString path = m_basePath;
+
+    if (m_rotateBytes > 0 || m_rotateIntervalMs > 0) {
+        const QFileInfo base(m_basePath);
+        const QString suffix = base.suffix().isEmpty() ? QStringLiteral("csv") : base.suffix();
+        path = base.dir().filePath(QString("%1_%2_%3.%4")
+                                       .arg(base.completeBaseName(),
+                                            QDateTime::fromMSecsSinceEpoch(m_segmentOpenedMs)
+                                                .toString("yyyyMMdd-HHmmss"))
+                                       .arg(m_segmentIndex, 3, 10, QChar('0'))
+                                       .arg(suffix));
+    }
+
+    if (m_compressing && !path.endsWith(".gz")) {
+        path += ".gz";
+    }
+    return path;
+}
+
+// First line of an existing file, decompressed for .gz segments
+static QByteArray readFirstLine(const QString &path, bool compressed)
+{
+    QByteArray line;
+    if (compressed) {
+#ifdef ZEPHYRSENSE_HAVE_ZLIB
+        if (gzFile gz = gzopen(QFile::encodeName(path).constData(), "rb")) {
+            char buffer[512];
+            if (gzgets(gz, buffer, sizeof(buffer))) {
+                line = buffer;
+            }
+            gzclose(gz);
+        }
+#endif
+    } else {
+        QFile file(path);
+        if (file.open(QIODevice::ReadOnly)) {
+            line = file.readLine(512);
+        }
+    }
+    return line;
+}
+
+// data.csv -> data-2.csv, data.csv.gz -> data-2.csv.gz
+static QString numberedPath(const QString &path, int number)
+{
+    QString plain = path;
+    QString gz;
+    if (plain.endsWith(".gz")) {
+        plain.chop(3);
+        gz = QStringLiteral(".gz");
+    }
+    const QFileInfo info(plain);
+    const QString suffix = info.suffix().isEmpty() ? QString() : "." + info.suffix();
+    return info.dir().filePath(QString("%1-%2%3%4").arg(info.completeBaseName()).arg(number).arg(suffix, gz));
+}
+
+bool CsvWriter::openSegment()
+{
+    m_compressing = m_compressionEnabled;
+    m_segmentOpenedMs = QDateTime::currentMSecsSinceEpoch();
+
+    // Rows are only appended under the header they match; a file written with
+    // another column layout (e.g. before device_id) is left alone
+    const QString requestedPath = segmentPath();
+    QString path = requestedPath;
+    for (int number = 2; QFileInfo(path).size() > 0 && !isCsvHeader(readFirstLine(path, m_compressing)); ++number) {
+        path = numberedPath(requestedPath, number);
+    }
+    if (path != requestedPath) {
+        qWarning() << "CsvWriter:" << requestedPath << "has a different header, writing to" << path;
+    }
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        QString error = QString("Failed to open CSV file: %1").arg(m_file.errorString());
+        qWarning() << "CsvWriter:" << error;
+        emit exportError(error);
+        return false;
+    }
+    m_segmentBytes = m_file.size();
+
+#ifdef ZEPHYRSENSE_HAVE_ZLIB
+    if (m_compressing) {
+        // windowBits 15 + 16 selects the gzip wrapper. Appending to an existing
+        // .gz adds a new member, which gzip readers concatenate.
+        m_deflate = std::make_unique<z_stream_s>();
+        if (deflateInit2(m_deflate.get(), Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8,
+                         Z_DEFAULT_STRATEGY) != Z_OK) {
+            qWarning() << "CsvWriter: deflateInit2 failed, writing uncompressed CSV";
+            m_deflate.reset();
+            m_compressing = false;
+        }
+    }
+#endif
+
+    // Header only for a new/empty file
+    if (m_segmentBytes == 0) {
+        appendCsvHeader(m_buffer);
+    }
+
+    qDebug() << "CsvWriter: Opened" << m_file.fileName();
+    emit segmentOpened(m_file.fileName());
+    return true;
+}
+
+void CsvWriter::closeSegment()
+{
+    if (!m_file.isOpen())
+        return;
+
+    flush();
+
+#ifdef ZEPHYRSENSE_HAVE_ZLIB
+    if (m_deflate) {
+        deflateToFile(QByteArray(), Z_FINISH);
+        deflateEnd(m_deflate.get());
+        m_deflate.reset();
+        emit statsChanged(m_bytesWritten, m_bytesOnDisk);
+    }
+#endif
+
+    // The only point where rows are forced to disk
+#ifdef Q_OS_WIN
+    _commit(m_file.handle());
+#else
+    ::fsync(m_file.handle());
+#endif
+    m_file.close();
+    qDebug() << "CsvWriter: Closed" << m_file.fileName();
+}
+
+bool CsvWriter::shouldRotate() const
+{
+    if (m_rotateIntervalMs > 0
+        && QDateTime::currentMSecsSinceEpoch() - m_segmentOpenedMs >= m_rotateIntervalMs) {
+        return true;
+    }
+    if (m_rotateBytes > 0) {
+        // Pending rows count at their uncompressed size only for plain files
+        const qint64 pending = m_compressing ? 0 : m_buffer.size();
+        return m_segmentBytes + pending >= m_rotateBytes;
+    }
+    return false;
+}
+
+void CsvWriter::rotate()
+{
+    closeSegment();
+    ++m_segmentIndex;
+    openSegment();
+}
+
+void CsvWriter::append(const SensorReading &reading)
+{
+    if (!m_file.isOpen())
+        return;
+
+    appendCsvRow(m_buffer, reading);
+
+    if (shouldRotate()) {
+        rotate();  // Flushes the row into the closing segment
+    } else if (m_buffer.size() >= m_flushBytes) {
+        flush();
+    } else if (!m_flushTimer->isActive()) {
+        m_flushTimer->start(m_flushIntervalMs);
+    }
+}
+
+void CsvWriter::flush()
+{
+    m_flushTimer->stop();
+    if (m_buffer.isEmpty() || !m_file.isOpen())
+        return;
+
+    bool ok;
+#ifdef ZEPHYRSENSE_HAVE_ZLIB
+    // Sync flush: everything handed over so far is decodable from the file
+    ok = m_deflate ? deflateToFile(m_buffer, Z_SYNC_FLUSH)
+                   : writeToFile(m_buffer.constData(), m_buffer.size());
+#else
+    ok = writeToFile(m_buffer.constData(), m_buffer.size());
+#endif
+    if (ok && !m_file.flush()) {
+        ok = false;
+    }
+    if (!ok) {
+        QString error = QString("Failed to write CSV file: %1").arg(m_file.errorString());
+        qWarning() << "CsvWriter:" << error;
+        emit exportError(error);
+    }
+
+    m_bytesWritten += m_buffer.size();
+    emit statsChanged(m_bytesWritten, m_bytesOnDisk);
+
+    // resize() keeps the allocation, so the buffer is reused for the next batch
+    m_buffer.resize(0);
+}
+
+bool CsvWriter::writeToFile(const char *data, qint64 size)
+{
+    const qint64 written = m_file.write(data, size);
+    if (written > 0) {
+        m_segmentBytes += written;
+        m_bytesOnDisk += written;
+    }
+    return written == size;
+}
+
+bool CsvWriter::deflateToFile(const QByteArray &data, int mode)
+{
+#ifdef ZEPHYRSENSE_HAVE_ZLIB
+    char out[16 * 1024];
+    m_deflate->next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.constData()));
+    m_deflate->avail_in = uInt(data.size());
+
+    // Drain until zlib has consumed the input and has no more output pending
+    do {
+        m_deflate->next_out = reinterpret_cast<Bytef *>(out);
+        m_deflate->avail_out = sizeof(out);
+        const int status = deflate(m_deflate.get(), mode);
+        if (status == Z_STREAM_ERROR) {
+            return false;
+        }
+        if (!writeToFile(out, qint64(sizeof(out) - m_deflate->avail_out))) {
+            return false;
+        }
+    } while (m_deflate->avail_out == 0);
+    return true;
+#else
+    Q_UNUSED(data)
+    Q_UNUSED(mode)
+    return false;
+#endif
+}
@@ -0,0 +1,89 @@
+#ifndef CSVWRITER_H
+#define CSVWRITER_H
+
+#include <QObject>
+#include <QFile>
+#include <QTimer>
+#include <QByteArray>
+#include <memory>
+#include "sensorreading.h"
+
+struct z_stream_s;
+
+// Appends readings to a CSV file that stays open. Rows are formatted into a
+// reused buffer and written once it holds flushBytes or flushIntervalMs has
+// passed; the file is fsynced only when a segment is closed. CsvExporter
+// moves it to a dedicated thread and only calls into it through queued
+// invocations.
+//
+// With rotation enabled the output is split into segments named
+// <stem>_<yyyyMMdd-HHmmss>_<NNN>.<suffix> next to the base path, where the
+// time is when the segment was opened and NNN counts segments since open().
+// With compression enabled every segment is a gzip stream (".gz" appended),
+// deflated batch by batch, so no more than one batch is held in memory.
+// An existing file is only appended to when its first line is the current
+// header; otherwise the rows go to <name>-2, <name>-3, ... instead.
+class CsvWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CsvWriter(QObject *parent = nullptr);
+    ~CsvWriter();
+
+    // Whether this build can write gzip (zlib found at configure time)
+    static bool compressionAvailable();
+
+    // Everything below must be called on the writer thread
+    bool open(const QString &basePath);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+
+    void setFlushBytes(int bytes);
+    void setFlushIntervalMs(int ms);
+    // 0 disables the respective limit; changes apply from the next segment on
+    void setRotation(qint64 maxBytes, qint64 maxIntervalMs);
+    void setCompressionEnabled(bool enabled);
+
+    void append(const SensorReading &reading);
+    // Hand buffered rows to the OS (no fsync)
+    void flush();
+
+signals:
+    void exportError(const QString &message);
+    void segmentOpened(const QString &path);
+    // Totals since open(): CSV bytes produced and bytes that reached the file
+    void statsChanged(qint64 bytesWritten, qint64 bytesOnDisk);
+
+private:
+    bool openSegment();
+    void closeSegment();
+    void rotate();
+    bool shouldRotate() const;
+    QString segmentPath() const;
+    bool writeToFile(const char *data, qint64 size);
+    bool deflateToFile(const QByteArray &data, int mode);
+
+    QFile m_file;
+    QByteArray m_buffer;
+    QTimer *m_flushTimer;
+    int m_flushBytes = 64 * 1024;
+    int m_flushIntervalMs = 1000;
+
+    QString m_basePath;
+    qint64 m_rotateBytes = 0;
+    qint64 m_rotateIntervalMs = 0;
+    bool m_compressionEnabled = false;
+
+    // Current segment
+    bool m_compressing = false;
+    std::unique_ptr<z_stream_s> m_deflate;
+    int m_segmentIndex = 0;
+    qint64 m_segmentOpenedMs = 0;
+    qint64 m_segmentBytes = 0;  // On disk, including what the file held before
+
+    qint64 m_bytesWritten = 0;
+    qint64 m_bytesOnDisk = 0;
+};
+
+#endif // CSVWRITER_H
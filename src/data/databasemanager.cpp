@@ -1,11 +1,10 @@
 #include "databasemanager.h"
 
-#include <QSqlDatabase>
-#include <QSqlQuery>
-#include <QSqlError>
 #include <QStandardPaths>
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
+#include <QCoreApplication>
 #include <QDebug>
 
 DatabaseManager::DatabaseManager(QObject *parent)
@@ -15,222 +14,195 @@ DatabaseManager::DatabaseManager(QObject *parent)
     QString dataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
     QDir().mkpath(dataPath);
     m_databasePath = dataPath + "/zephyrsense.db";
+
+    // All SQL runs on the worker thread with its own connection
+    m_worker = new DatabaseWorker(m_databasePath);
+    m_worker->moveToThread(&m_workerThread);
+    connect(&m_workerThread, &QThread::finished, m_worker, &QObject::deleteLater);
+    connect(m_worker, &DatabaseWorker::databaseError, this, &DatabaseManager::databaseError);
+    m_workerThread.setObjectName("DatabaseWorker");
+    m_workerThread.start();
+
+    // Polls the size of a running database export
+    m_exportProgressTimer.setInterval(200);
+    connect(&m_exportProgressTimer, &QTimer::timeout, this, [this]() {
+        const qint64 written = QFileInfo(m_exportPath).size();
+        emit exportProgress(qMin(written, m_exportTotalBytes), m_exportTotalBytes);
+    });
+
+    // Never lose buffered readings on shutdown
+    connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit,
+            this, &DatabaseManager::flush);
 }
 
 DatabaseManager::~DatabaseManager()
 {
-    // Close the connection if it exists
-    if (QSqlDatabase::contains(CONNECTION_NAME)) {
-        QSqlDatabase::database(CONNECTION_NAME).close();
-        QSqlDatabase::removeDatabase(CONNECTION_NAME);
-    }
+    // Write out anything still buffered and close the connection on its own thread
+    runBlocking([](DatabaseWorker *worker) {
+        worker->close();
+        return true;
+    });
+    m_workerThread.quit();
+    m_workerThread.wait();
 }
 
-bool DatabaseManager::initialize()
+void DatabaseManager::setBatchSize(int size)
 {
-    // Check if already connected
-    if (QSqlDatabase::contains(CONNECTION_NAME)) {
-        QSqlDatabase db = QSqlDatabase::database(CONNECTION_NAME);
-        if (db.isOpen()) {
-            return true;
-        }
+    size = qMax(1, size);
+    if (m_batchSize != size) {
+        m_batchSize = size;
+        post([size](DatabaseWorker *worker) { worker->setBatchSize(size); });
+        emit batchSizeChanged();
     }
+}
 
-    // Create new connection
-    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", CONNECTION_NAME);
-    db.setDatabaseName(m_databasePath);
-
-    if (!db.open()) {
-        QString error = QString("Failed to open database: %1").arg(db.lastError().text());
-        qWarning() << error;
-        emit databaseError(error);
-        return false;
+void DatabaseManager::setFlushIntervalMs(int ms)
+{
+    ms = qMax(0, ms);
+    if (m_flushIntervalMs != ms) {
+        m_flushIntervalMs = ms;
+        post([ms](DatabaseWorker *worker) { worker->setFlushIntervalMs(ms); });
+        emit flushIntervalMsChanged();
     }
-
-    qDebug() << "Database opened at:" << m_databasePath;
-    createTables();
-    return true;
 }
 
-void DatabaseManager::createTables()
+void DatabaseManager::setWalEnabled(bool enabled)
 {
-    QSqlDatabase db = QSqlDatabase::database(CONNECTION_NAME);
-    QSqlQuery query(db);
-
-    // Create readings table with all sensor fields
-    const QString createTableSql = R"(
-        CREATE TABLE IF NOT EXISTS readings (
-            id INTEGER PRIMARY KEY AUTOINCREMENT,
-            timestamp INTEGER NOT NULL,
-            partectorNumber INTEGER,
-            partectorDiam INTEGER,
-            partectorMass REAL,
-            grimmValue REAL,
-            temperature REAL,
-            humidity REAL,
-            pressure REAL,
-            altitude REAL,
-            latitude REAL,
-            longitude REAL,
-            co2 INTEGER
-        )
-    )";
-
-    if (!query.exec(createTableSql)) {
-        QString error = QString("Failed to create readings table: %1").arg(query.lastError().text());
-        qWarning() << error;
-        emit databaseError(error);
-        return;
+    if (m_walEnabled != enabled) {
+        m_walEnabled = enabled;
+        post([enabled, sync = m_synchronousNormal](DatabaseWorker *worker) {
+            worker->setPragmas(enabled, sync);
+        });
+        emit walEnabledChanged();
     }
+}
 
-    // Create index on timestamp for efficient range queries
-    const QString createIndexSql = R"(
-        CREATE INDEX IF NOT EXISTS idx_timestamp ON readings(timestamp)
-    )";
-
-    if (!query.exec(createIndexSql)) {
-        QString error = QString("Failed to create timestamp index: %1").arg(query.lastError().text());
-        qWarning() << error;
-        emit databaseError(error);
+void DatabaseManager::setSynchronousNormal(bool enabled)
+{
+    if (m_synchronousNormal != enabled) {
+        m_synchronousNormal = enabled;
+        post([wal = m_walEnabled, enabled](DatabaseWorker *worker) {
+            worker->setPragmas(wal, enabled);
+        });
+        emit synchronousNormalChanged();
     }
+}
 
-    qDebug() << "Database tables and indexes created successfully";
+bool DatabaseManager::initialize()
+{
+    // Startup only: wait for the worker so QML knows whether the database is usable
+    return runBlocking([](DatabaseWorker *worker) {
+        return worker->open();
+    });
 }
 
 void DatabaseManager::insertReading(const SensorReading &reading)
 {
-    QSqlDatabase db = QSqlDatabase::database(CONNECTION_NAME);
-    if (!db.isOpen()) {
-        emit databaseError("Database not open");
-        return;
-    }
+    post([reading](DatabaseWorker *worker) { worker->insertReading(reading); });
+}
 
-    QSqlQuery query(db);
-    query.prepare(R"(
-        INSERT INTO readings (
-            timestamp, partectorNumber, partectorDiam, partectorMass,
-            grimmValue, temperature, humidity, pressure,
-            altitude, latitude, longitude, co2
-        ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
-    )");
-
-    // Store timestamp as milliseconds since epoch (INTEGER)
-    query.addBindValue(reading.timestamp.toMSecsSinceEpoch());
-    query.addBindValue(reading.partectorNumber);
-    query.addBindValue(reading.partectorDiam);
-    query.addBindValue(static_cast<double>(reading.partectorMass));
-    query.addBindValue(static_cast<double>(reading.grimmValue));
-    query.addBindValue(static_cast<double>(reading.temperature));
-    query.addBindValue(static_cast<double>(reading.humidity));
-    query.addBindValue(static_cast<double>(reading.pressure));
-    query.addBindValue(static_cast<double>(reading.altitude));
-    query.addBindValue(static_cast<double>(reading.latitude));
-    query.addBindValue(static_cast<double>(reading.longitude));
-    query.addBindValue(reading.co2);
-
-    if (!query.exec()) {
-        QString error = QString("Failed to insert reading: %1").arg(query.lastError().text());
-        qWarning() << error;
-        emit databaseError(error);
+void DatabaseManager::insertReadings(const QList<SensorReading> &readings)
+{
+    if (!readings.isEmpty()) {
+        post([readings](DatabaseWorker *worker) { worker->insertReadings(readings); });
     }
 }
 
-QVariantList DatabaseManager::getReadingsInRange(const QDateTime &start, const QDateTime &end)
+void DatabaseManager::flush()
 {
-    QVariantList results;
+    post([](DatabaseWorker *worker) { worker->flush(); });
+}
 
-    QSqlDatabase db = QSqlDatabase::database(CONNECTION_NAME);
-    if (!db.isOpen()) {
-        emit databaseError("Database not open");
-        return results;
-    }
+QFuture<ReadingColumns> DatabaseManager::queryReadingsInRange(const QDateTime &start, const QDateTime &end,
+                                                              int deviceId)
+{
+    const qint64 startMs = start.toMSecsSinceEpoch();
+    const qint64 endMs = end.toMSecsSinceEpoch();
+    return runAsync<ReadingColumns>([startMs, endMs, deviceId](DatabaseWorker *worker,
+                                                               const DatabaseWorker::CancelCheck &isCanceled) {
+        return worker->readingColumnsInRange(startMs, endMs, deviceId, isCanceled);
+    });
+}
 
-    QSqlQuery query(db);
-    query.setForwardOnly(true);  // Memory efficient for large result sets
-
-    query.prepare(R"(
-        SELECT id, timestamp, partectorNumber, partectorDiam, partectorMass,
-               grimmValue, temperature, humidity, pressure,
-               altitude, latitude, longitude, co2
-        FROM readings
-        WHERE timestamp BETWEEN ? AND ?
-        ORDER BY timestamp ASC
-    )");
-
-    query.addBindValue(start.toMSecsSinceEpoch());
-    query.addBindValue(end.toMSecsSinceEpoch());
-
-    if (!query.exec()) {
-        QString error = QString("Failed to query readings: %1").arg(query.lastError().text());
-        qWarning() << error;
-        emit databaseError(error);
-        return results;
-    }
+QFuture<ReadingColumns> DatabaseManager::queryChartRange(const QDateTime &start, const QDateTime &end, int pointBudget,
+                                                         int deviceId)
+{
+    const qint64 startMs = start.toMSecsSinceEpoch();
+    const qint64 endMs = end.toMSecsSinceEpoch();
+    return runAsync<ReadingColumns>([startMs, endMs, pointBudget, deviceId](
+                                        DatabaseWorker *worker, const DatabaseWorker::CancelCheck &isCanceled) {
+        return worker->chartColumnsInRange(startMs, endMs, pointBudget, deviceId, isCanceled);
+    });
+}
 
-    while (query.next()) {
-        QVariantMap reading;
-        reading["id"] = query.value(0).toInt();  // Database ID
-        reading["timestamp"] = QDateTime::fromMSecsSinceEpoch(query.value(1).toLongLong());
-        reading["partectorNumber"] = query.value(2).toInt();
-        reading["partectorDiam"] = query.value(3).toInt();
-        reading["partectorMass"] = query.value(4).toDouble();
-        reading["grimmValue"] = query.value(5).toDouble();
-        reading["temperature"] = query.value(6).toDouble();
-        reading["humidity"] = query.value(7).toDouble();
-        reading["pressure"] = query.value(8).toDouble();
-        reading["altitude"] = query.value(9).toDouble();
-        reading["latitude"] = query.value(10).toDouble();
-        reading["longitude"] = query.value(11).toDouble();
-        reading["co2"] = query.value(12).toInt();
-        results.append(reading);
-    }
+QFuture<ReadingColumns> DatabaseManager::queryLatestReading(int deviceId)
+{
+    return runAsync<ReadingColumns>([deviceId](DatabaseWorker *worker, const DatabaseWorker::CancelCheck &) {
+        return worker->latestReading(deviceId);
+    });
+}
 
-    return results;
+QVariantList DatabaseManager::getReadingsInRange(const QDateTime &start, const QDateTime &end)
+{
+    const qint64 startMs = start.toMSecsSinceEpoch();
+    const qint64 endMs = end.toMSecsSinceEpoch();
+    return runBlocking([startMs, endMs](DatabaseWorker *worker) {
+        return worker->readingColumnsInRange(startMs, endMs, DatabaseWorker::ALL_DEVICES,
+                                             DatabaseWorker::CancelCheck()).toVariantList();
+    });
 }
 
 QVariantMap DatabaseManager::getReadingById(int id)
 {
-    QVariantMap result;
+    return runBlocking([id](DatabaseWorker *worker) {
+        return worker->readingById(id);
+    });
+}
 
-    QSqlDatabase db = QSqlDatabase::database(CONNECTION_NAME);
-    if (!db.isOpen()) {
-        qWarning() << "Database not open";
-        return result;
-    }
+QVariantList DatabaseManager::getAvailableDates()
+{
+    return runBlocking([](DatabaseWorker *worker) {
+        return worker->availableDates();
+    });
+}
 
-    QSqlQuery query(db);
-    query.prepare(R"(
-        SELECT id, timestamp, partectorNumber, partectorDiam, partectorMass,
-               grimmValue, temperature, humidity, pressure,
-               altitude, latitude, longitude, co2
-        FROM readings
-        WHERE id = ?
-    )");
+QVariantList DatabaseManager::getDaySummaries()
+{
+    return runBlocking([](DatabaseWorker *worker) {
+        return worker->daySummaries();
+    });
+}
 
-    query.addBindValue(id);
+void DatabaseManager::requestReadingById(int id)
+{
+    runAsync<QVariantMap>([id](DatabaseWorker *worker, const DatabaseWorker::CancelCheck &) {
+        return worker->readingById(id);
+    }).then(this, [this, id](const QVariantMap &reading) {
+        emit readingByIdReady(id, reading);
+    });
+}
 
-    if (!query.exec()) {
-        qWarning() << "Failed to get reading by ID:" << query.lastError().text();
-        return result;
-    }
+void DatabaseManager::requestAvailableDates()
+{
+    runAsync<QVariantList>([](DatabaseWorker *worker, const DatabaseWorker::CancelCheck &) {
+        return worker->availableDates();
+    }).then(this, [this](const QVariantList &dates) {
+        emit availableDatesReady(dates);
+    });
+}
 
-    if (query.next()) {
-        result["id"] = query.value(0).toInt();
-        result["timestamp"] = QDateTime::fromMSecsSinceEpoch(query.value(1).toLongLong());
-        result["partectorNumber"] = query.value(2).toInt();
-        result["partectorDiam"] = query.value(3).toInt();
-        result["partectorMass"] = query.value(4).toDouble();
-        result["grimmValue"] = query.value(5).toDouble();
-        result["temperature"] = query.value(6).toDouble();
-        result["humidity"] = query.value(7).toDouble();
-        result["pressure"] = query.value(8).toDouble();
-        result["altitude"] = query.value(9).toDouble();
-        result["latitude"] = query.value(10).toDouble();
-        result["longitude"] = query.value(11).toDouble();
-        result["co2"] = query.value(12).toInt();
-    }
+void DatabaseManager::requestDaySummaries()
+{
+    runAsync<QVariantList>([](DatabaseWorker *worker, const DatabaseWorker::CancelCheck &) {
+        return worker->daySummaries();
+    }).then(this, [this](const QVariantList &days) {
+        emit daySummariesReady(days);
+    });
+}
 
-    return result;
+void DatabaseManager::backfillRollups()
+{
+    post([](DatabaseWorker *worker) { worker->backfillRollups(); });
 }
 
 bool DatabaseManager::exportDatabase(const QUrl &destination)
@@ -242,130 +214,139 @@ bool DatabaseManager::exportDatabase(const QUrl &destination)
         return false;
     }
 
-    // Close the connection before copying
-    {
-        QSqlDatabase db = QSqlDatabase::database(CONNECTION_NAME);
-        if (db.isOpen()) {
-            db.close();
+    // The worker is busy inside a single VACUUM INTO statement, so progress is
+    // measured from here by watching the destination file grow
+    DatabaseWorker::ProgressCallback started = [this, destPath](qint64, qint64 total) {
+        QMetaObject::invokeMethod(this, [this, destPath, total]() {
+            m_exportPath = destPath;
+            m_exportTotalBytes = total;
+            emit exportProgress(0, total);
+            m_exportProgressTimer.start();
+        }, Qt::QueuedConnection);
+    };
+
+    runAsync<bool>([destPath, started](DatabaseWorker *worker, const DatabaseWorker::CancelCheck &) {
+        return worker->exportTo(destPath, started);
+    }).then(this, [this](bool success) {
+        m_exportProgressTimer.stop();
+        if (success) {
+            emit exportProgress(m_exportTotalBytes, m_exportTotalBytes);
         }
-    }
-    QSqlDatabase::removeDatabase(CONNECTION_NAME);
-
-    // Copy the database file
-    bool success = QFile::copy(m_databasePath, destPath);
-
-    // Reopen the connection
-    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", CONNECTION_NAME);
-    db.setDatabaseName(m_databasePath);
-    if (!db.open()) {
-        qWarning() << "Failed to reopen database after export";
-    }
-
-    if (!success) {
-        QString error = QString("Failed to export database to: %1").arg(destPath);
-        qWarning() << error;
-        emit databaseError(error);
-    }
-
-    emit exportCompleted(success);
-    return success;
+        emit exportCompleted(success);
+    });
+    return true;
 }
 
-bool DatabaseManager::importDatabase(const QUrl &source)
+bool DatabaseManager::mergeDatabase(const QUrl &source)
 {
     QString sourcePath = source.toLocalFile();
-    if (sourcePath.isEmpty()) {
-        emit databaseError("Invalid import source");
-        emit importCompleted(false);
+    if (sourcePath.isEmpty() || !QFile::exists(sourcePath)) {
+        emit databaseError("Merge source does not exist");
+        emit mergeCompleted(false, 0);
         return false;
     }
 
-    if (!QFile::exists(sourcePath)) {
-        emit databaseError("Import file does not exist");
-        emit importCompleted(false);
+    if (m_merge.isRunning()) {
+        emit databaseError("A merge is already running");
         return false;
     }
 
-    // Close the connection before importing
-    {
-        QSqlDatabase db = QSqlDatabase::database(CONNECTION_NAME);
-        if (db.isOpen()) {
-            db.close();
-        }
-    }
-    QSqlDatabase::removeDatabase(CONNECTION_NAME);
-
-    // Backup current database
-    QString backupPath = m_databasePath + ".backup";
-    bool hadExisting = QFile::exists(m_databasePath);
-    if (hadExisting) {
-        QFile::remove(backupPath);  // Remove old backup if exists
-        if (!QFile::rename(m_databasePath, backupPath)) {
-            emit databaseError("Failed to backup current database");
-            // Try to reopen original
-            QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", CONNECTION_NAME);
-            db.setDatabaseName(m_databasePath);
-            db.open();
-            emit importCompleted(false);
-            return false;
-        }
-    }
+    // Progress is reported from the worker thread; hop back before emitting
+    DatabaseWorker::ProgressCallback progress = [this](qint64 done, qint64 total) {
+        QMetaObject::invokeMethod(this, [this, done, total]() {
+            emit mergeProgress(done, total);
+        }, Qt::QueuedConnection);
+    };
+
+    m_merge = runAsync<qint64>([sourcePath, progress](DatabaseWorker *worker,
+                                                      const DatabaseWorker::CancelCheck &isCanceled) {
+        return worker->mergeFrom(sourcePath, progress, isCanceled);
+    });
+
+    m_merge.then(this, [this](qint64 rows) {
+        emit mergeCompleted(rows >= 0, qMax<qint64>(0, rows));
+        emit mergeRunningChanged();
+    }).onCanceled(this, [this]() {
+        emit mergeCompleted(false, 0);
+        emit mergeRunningChanged();
+    });
+
+    emit mergeRunningChanged();
+    return true;
+}
 
-    // Copy import file to database location
-    bool success = QFile::copy(sourcePath, m_databasePath);
+void DatabaseManager::cancelMerge()
+{
+    // Checked by the worker between chunks; committed chunks are kept
+    m_merge.cancel();
+}
 
-    if (success) {
-        // Remove backup on success
-        if (hadExisting) {
-            QFile::remove(backupPath);
-        }
-    } else {
-        // Restore backup on failure
-        if (hadExisting) {
-            QFile::rename(backupPath, m_databasePath);
-        }
-        emit databaseError("Failed to import database");
+bool DatabaseManager::exportRangeToCsv(const QDateTime &start, const QDateTime &end, const QUrl &destination)
+{
+    QString destPath = destination.toLocalFile();
+    if (destPath.isEmpty()) {
+        emit databaseError("Invalid export destination");
+        emit rangeExportCompleted(false, 0);
+        return false;
     }
 
-    // Reopen the connection
-    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", CONNECTION_NAME);
-    db.setDatabaseName(m_databasePath);
-    if (!db.open()) {
-        qWarning() << "Failed to reopen database after import";
-        emit databaseError("Failed to reopen database after import");
-        success = false;
+    if (m_rangeExport.isRunning()) {
+        emit databaseError("A range export is already running");
+        return false;
     }
 
-    emit importCompleted(success);
-    return success;
+    const qint64 startMs = start.toMSecsSinceEpoch();
+    const qint64 endMs = end.toMSecsSinceEpoch();
+
+    // Progress is reported from the worker thread; hop back before emitting
+    DatabaseWorker::ProgressCallback progress = [this](qint64 done, qint64 total) {
+        QMetaObject::invokeMethod(this, [this, done, total]() {
+            emit rangeExportProgress(done, total);
+        }, Qt::QueuedConnection);
+    };
+
+    m_rangeExport = runAsync<qint64>([startMs, endMs, destPath, progress](DatabaseWorker *worker,
+                                                                        const DatabaseWorker::CancelCheck &isCanceled) {
+        return worker->exportRangeToCsv(startMs, endMs, destPath, progress, isCanceled);
+    });
+
+    m_rangeExport.then(this, [this](qint64 rows) {
+        emit rangeExportCompleted(rows >= 0, qMax<qint64>(0, rows));
+        emit rangeExportRunningChanged();
+    }).onCanceled(this, [this]() {
+        emit rangeExportCompleted(false, 0);
+        emit rangeExportRunningChanged();
+    });
+
+    emit rangeExportRunningChanged();
+    return true;
 }
 
-QVariantList DatabaseManager::getAvailableDates()
+void DatabaseManager::cancelRangeExport()
 {
-    QVariantList dates;
-    QSqlDatabase db = QSqlDatabase::database(CONNECTION_NAME);
-    if (!db.isOpen()) {
-        qWarning() << "Database not open for getAvailableDates";
-        return dates;
-    }
+    // Polled by the worker between chunks
+    m_rangeExport.cancel();
+}
 
-    QSqlQuery query(db);
-    query.setForwardOnly(true);
-
-    // Query distinct dates (day precision) from readings table
-    // timestamp is stored as milliseconds since epoch
-    if (!query.exec(R"(
-        SELECT DISTINCT date(timestamp / 1000, 'unixepoch', 'localtime') as date
-        FROM readings
-        ORDER BY date DESC
-    )")) {
-        qWarning() << "Failed to query available dates:" << query.lastError().text();
-        return dates;
+bool DatabaseManager::importDatabase(const QUrl &source)
+{
+    QString sourcePath = source.toLocalFile();
+    if (sourcePath.isEmpty()) {
+        emit databaseError("Invalid import source");
+        emit importCompleted(false);
+        return false;
     }
 
-    while (query.next()) {
-        dates.append(query.value(0).toString());  // Format: "2026-01-25"
+    if (!QFile::exists(sourcePath)) {
+        emit databaseError("Import file does not exist");
+        emit importCompleted(false);
+        return false;
     }
 
-    return dates;
+    runAsync<bool>([sourcePath](DatabaseWorker *worker, const DatabaseWorker::CancelCheck &) {
+        return worker->importFrom(sourcePath);
+    }).then(this, [this](bool success) {
+        emit importCompleted(success);
+    });
+    return true;
 }
@@ -6,8 +6,17 @@
 #include <QUrl>
 #include <QDateTime>
 #include <QVariantList>
+#include <QThread>
+#include <QTimer>
+#include <QFuture>
+#include <QPromise>
+#include <memory>
 #include "sensorreading.h"
+#include "databaseworker.h"
 
+// GUI-thread facade for the database. All SQL runs on a DatabaseWorker that
+// lives on its own thread with its own connection; this class only posts work
+// to it and hands results back through QFuture or signals.
 class DatabaseManager : public QObject
 {
     Q_OBJECT
@@ -16,32 +25,172 @@ class DatabaseManager : public QObject
 
     Q_PROPERTY(QString databasePath READ databasePath CONSTANT)
 
+    // Write-behind batching: flush after batchSize readings or flushIntervalMs, whichever comes first
+    Q_PROPERTY(int batchSize READ batchSize WRITE setBatchSize NOTIFY batchSizeChanged)
+    Q_PROPERTY(int flushIntervalMs READ flushIntervalMs WRITE setFlushIntervalMs NOTIFY flushIntervalMsChanged)
+
+    // SQLite durability/throughput trade-offs (PRAGMA journal_mode / synchronous)
+    Q_PROPERTY(bool walEnabled READ walEnabled WRITE setWalEnabled NOTIFY walEnabledChanged)
+    Q_PROPERTY(bool synchronousNormal READ synchronousNormal WRITE setSynchronousNormal NOTIFY synchronousNormalChanged)
+
+    // True while exportRangeToCsv is running
+    Q_PROPERTY(bool rangeExportRunning READ rangeExportRunning NOTIFY rangeExportRunningChanged)
+    // True while mergeDatabase is running
+    Q_PROPERTY(bool mergeRunning READ mergeRunning NOTIFY mergeRunningChanged)
+
 public:
     explicit DatabaseManager(QObject *parent = nullptr);
     ~DatabaseManager();
 
-    static constexpr const char* CONNECTION_NAME = "ZephyrSense";
+    static constexpr const char* CONNECTION_NAME = DatabaseWorker::CONNECTION_NAME;
 
     QString databasePath() const { return m_databasePath; }
 
+    int batchSize() const { return m_batchSize; }
+    void setBatchSize(int size);
+    int flushIntervalMs() const { return m_flushIntervalMs; }
+    void setFlushIntervalMs(int ms);
+    bool walEnabled() const { return m_walEnabled; }
+    void setWalEnabled(bool enabled);
+    bool synchronousNormal() const { return m_synchronousNormal; }
+    void setSynchronousNormal(bool enabled);
+    bool rangeExportRunning() const { return m_rangeExport.isRunning(); }
+    bool mergeRunning() const { return m_merge.isRunning(); }
+
+    // Asynchronous C++ API - cancel the returned future to abandon a superseded query
+    // Readings of one device in the range
+    QFuture<ReadingColumns> queryReadingsInRange(const QDateTime &start, const QDateTime &end, int deviceId);
+    // Chart loads: served from the coarsest rollup tier that still fills pointBudget
+    QFuture<ReadingColumns> queryChartRange(const QDateTime &start, const QDateTime &end, int pointBudget,
+                                            int deviceId);
+    // Newest stored reading of one device as zero or one row
+    QFuture<ReadingColumns> queryLatestReading(int deviceId);
+
     Q_INVOKABLE bool initialize();
+    // Export/import run on the worker; completion is reported by exportCompleted/importCompleted.
+    // Export is an online, compacted copy: ingestion continues while it runs and
+    // exportProgress reports bytes written against the expected size.
     Q_INVOKABLE bool exportDatabase(const QUrl &destination);
     Q_INVOKABLE bool importDatabase(const QUrl &source);
+    // Add another database's readings to this one instead of replacing it;
+    // readings whose (timestamp, device_id) pair is already present are skipped.
+    // Progress arrives through mergeProgress, the result through mergeCompleted.
+    Q_INVOKABLE bool mergeDatabase(const QUrl &source);
+    Q_INVOKABLE void cancelMerge();
+    // Stream a time range to CSV on the worker without loading it into memory.
+    // Progress arrives through rangeExportProgress, the result through
+    // rangeExportCompleted; cancelRangeExport() abandons the export.
+    Q_INVOKABLE bool exportRangeToCsv(const QDateTime &start, const QDateTime &end, const QUrl &destination);
+    Q_INVOKABLE void cancelRangeExport();
+    // Rebuild the 1s/1min/1h rollup tables from raw readings (runs on the worker)
+    Q_INVOKABLE void backfillRollups();
+
+    // Blocking variants kept for QML compatibility - prefer the request* methods.
+    // getReadingsInRange wraps the columnar query in one QVariantMap per row.
     Q_INVOKABLE QVariantList getReadingsInRange(const QDateTime &start, const QDateTime &end);
     Q_INVOKABLE QVariantMap getReadingById(int id);
     Q_INVOKABLE QVariantList getAvailableDates();
+    Q_INVOKABLE QVariantList getDaySummaries();
+
+    // Asynchronous QML API - results arrive through the matching *Ready signal
+    Q_INVOKABLE void requestReadingById(int id);
+    Q_INVOKABLE void requestAvailableDates();
+    // Per-day row counts, first/last timestamps and sensor extrema, newest first
+    Q_INVOKABLE void requestDaySummaries();
 
 public slots:
+    // Both safe to call from any thread: they only queue work for the worker
     void insertReading(const SensorReading &reading);
+    // One queued call for the whole batch; the list is shared, not copied
+    void insertReadings(const QList<SensorReading> &readings);
+    void flush();
 
 signals:
     void databaseError(const QString &message);
     void exportCompleted(bool success);
+    void exportProgress(qint64 bytesWritten, qint64 totalBytes);
     void importCompleted(bool success);
+    void rangeExportProgress(qint64 done, qint64 total);
+    void rangeExportCompleted(bool success, qint64 rows);
+    void rangeExportRunningChanged();
+    void mergeProgress(qint64 done, qint64 total);
+    void mergeCompleted(bool success, qint64 rowsAdded);
+    void mergeRunningChanged();
+    void readingByIdReady(int id, const QVariantMap &reading);
+    void availableDatesReady(const QVariantList &dates);
+    void daySummariesReady(const QVariantList &days);
+    void batchSizeChanged();
+    void flushIntervalMsChanged();
+    void walEnabledChanged();
+    void synchronousNormalChanged();
 
 private:
-    void createTables();
+    // Run function(worker) on the worker thread and deliver its result through a future
+    template <typename Result, typename Function>
+    QFuture<Result> runAsync(Function function);
+
+    // Run function(worker) on the worker thread and wait for it
+    template <typename Function>
+    auto runBlocking(Function function) -> decltype(function(static_cast<DatabaseWorker *>(nullptr)));
+
+    // Fire-and-forget call on the worker thread
+    template <typename Function>
+    void post(Function function);
+
     QString m_databasePath;
+    QThread m_workerThread;
+    DatabaseWorker *m_worker;
+    QFuture<qint64> m_rangeExport;
+    QFuture<qint64> m_merge;
+
+    QTimer m_exportProgressTimer;
+    QString m_exportPath;
+    qint64 m_exportTotalBytes = 0;
+
+    int m_batchSize = 200;
+    int m_flushIntervalMs = 1000;
+    bool m_walEnabled = true;
+    bool m_synchronousNormal = true;
 };
 
+template <typename Result, typename Function>
+QFuture<Result> DatabaseManager::runAsync(Function function)
+{
+    auto promise = std::make_shared<QPromise<Result>>();
+    QFuture<Result> future = promise->future();
+    promise->start();
+
+    QMetaObject::invokeMethod(m_worker, [worker = m_worker, promise, function]() {
+        // Superseded before the worker got to it
+        if (promise->isCanceled()) {
+            promise->finish();
+            return;
+        }
+        DatabaseWorker::CancelCheck isCanceled = [promise]() { return promise->isCanceled(); };
+        promise->addResult(function(worker, isCanceled));
+        promise->finish();
+    }, Qt::QueuedConnection);
+
+    return future;
+}
+
+template <typename Function>
+auto DatabaseManager::runBlocking(Function function) -> decltype(function(static_cast<DatabaseWorker *>(nullptr)))
+{
+    using Result = decltype(function(static_cast<DatabaseWorker *>(nullptr)));
+    Result result{};
+    QMetaObject::invokeMethod(m_worker, [worker = m_worker, &function, &result]() {
+        result = function(worker);
+    }, Qt::BlockingQueuedConnection);
+    return result;
+}
+
+template <typename Function>
+void DatabaseManager::post(Function function)
+{
+    QMetaObject::invokeMethod(m_worker, [worker = m_worker, function]() {
+        function(worker);
+    }, Qt::QueuedConnection);
+}
+
 #endif // DATABASEMANAGER_H
@@ -0,0 +1,1420 @@
+#include "databaseworker.h"
+#include "csvformat.h"
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QFile>
+#include <QDebug>
+#include <array>
+#include <map>
+#include <limits>
+
+// Rollup tiers, finest first; each row aggregates one bucket of widthMs
+struct RollupTier {
+    const char *table;
+    qint64 widthMs;
+};
+
+static const RollupTier ROLLUP_TIERS[] = {
+    { "readings_1s", 1000 },
+    { "readings_1m", 60 * 1000 },
+    { "readings_1h", 60 * 60 * 1000 },
+};
+static constexpr int ROLLUP_TIER_COUNT = 3;
+
+// Readings kept for the next flush while commits fail; beyond this the oldest are dropped
+static constexpr qsizetype MAX_PENDING_READINGS = 100000;
+
+// Aggregated sensors, in ReadingColumns::Sensor order
+static const char *const SENSOR_COLUMNS[ReadingColumns::SensorCount] = {
+    "partectorNumber", "partectorDiam", "partectorMass", "grimmValue",
+    "temperature", "humidity", "pressure", "altitude", "co2"
+};
+
+using SensorValues = std::array<double, ReadingColumns::SensorCount>;
+
+static SensorValues sensorValues(const SensorReading &reading)
+{
+    return {
+        double(reading.partectorNumber), double(reading.partectorDiam),
+        reading.partectorMass, reading.grimmValue,
+        reading.temperature, reading.humidity,
+        reading.pressure, reading.altitude, double(reading.co2)
+    };
+}
+
+static qint64 bucketStart(qint64 timestampMs, qint64 widthMs)
+{
+    return (timestampMs / widthMs) * widthMs;
+}
+
+// Whether a table has a column; schema is "main" or an attached database
+static bool hasColumn(const QSqlDatabase &db, const QString &schema, const QString &table, const QString &column)
+{
+    QSqlQuery query(db);
+    query.prepare("SELECT COUNT(*) FROM pragma_table_info(?, ?) WHERE name = ?");
+    query.addBindValue(table);
+    query.addBindValue(schema);
+    query.addBindValue(column);
+    return query.exec() && query.next() && query.value(0).toInt() > 0;
+}
+
+// Leading "device_id = ? AND " term of a WHERE clause, or nothing for ALL_DEVICES.
+// An equality the planner can match to idx_device_timestamp, unlike "? < 0 OR ...".
+static QString deviceCondition(int deviceId)
+{
+    return deviceId == DatabaseWorker::ALL_DEVICES ? QString() : QString("device_id = ? AND ");
+}
+
+// Append the current row of a query selecting id, timestamp, every reading
+// column in table order and device_id
+static void appendReadingRow(const QSqlQuery &query, ReadingColumns &columns)
+{
+    columns.ids.append(query.value(0).toLongLong());
+    columns.timestamps.append(query.value(1).toLongLong());
+    columns.partectorNumber.append(query.value(2).toInt());
+    columns.partectorDiam.append(query.value(3).toInt());
+    columns.partectorMass.append(query.value(4).toFloat());
+    columns.grimmValue.append(query.value(5).toFloat());
+    columns.temperature.append(query.value(6).toFloat());
+    columns.humidity.append(query.value(7).toFloat());
+    columns.pressure.append(query.value(8).toFloat());
+    columns.altitude.append(query.value(9).toFloat());
+    columns.latitude.append(query.value(10).toFloat());
+    columns.longitude.append(query.value(11).toFloat());
+    columns.co2.append(query.value(12).toInt());
+    columns.deviceIds.append(query.value(13).toInt());
+}
+
+DatabaseWorker::DatabaseWorker(const QString &databasePath, QObject *parent)
+    : QObject(parent)
+    , m_databasePath(databasePath)
+    , m_flushTimer(new QTimer(this))  // Child, so it follows the worker to its thread
+{
+    // Latency bound for buffered readings
+    m_flushTimer->setSingleShot(true);
+    connect(m_flushTimer, &QTimer::timeout, this, &DatabaseWorker::flush);
+}
+
+DatabaseWorker::~DatabaseWorker()
+{
+    closeConnection();
+}
+
+void DatabaseWorker::close()
+{
+    // Write out anything still buffered, then close the connection if it exists
+    flush();
+    closeConnection();
+}
+
+void DatabaseWorker::setBatchSize(int size)
+{
+    m_batchSize = size;
+    if (m_pendingReadings.size() >= m_batchSize) {
+        flush();
+    }
+}
+
+void DatabaseWorker::setFlushIntervalMs(int ms)
+{
+    m_flushIntervalMs = ms;
+}
+
+void DatabaseWorker::setPragmas(bool walEnabled, bool synchronousNormal)
+{
+    m_walEnabled = walEnabled;
+    m_synchronousNormal = synchronousNormal;
+    flush();  // The journal mode cannot change inside a transaction
+    applyPragmas();
+}
+
+bool DatabaseWorker::openConnection()
+{
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", CONNECTION_NAME);
+    db.setDatabaseName(m_databasePath);
+    if (!db.open()) {
+        return false;
+    }
+    applyPragmas();
+    return true;
+}
+
+void DatabaseWorker::closeConnection()
+{
+    // Cached statements must go before the connection is removed
+    m_insertQuery.reset();
+    for (auto &query : m_rollupQueries) {
+        query.reset();
+    }
+    m_daySummaryQuery.reset();
+
+    if (QSqlDatabase::contains(CONNECTION_NAME)) {
+        {
+            QSqlDatabase db = QSqlDatabase::database(CONNECTION_NAME, false);
+            if (db.isOpen()) {
+                db.close();
+            }
+        }
+        QSqlDatabase::removeDatabase(CONNECTION_NAME);
+    }
+}
+
+void DatabaseWorker::applyPragmas()
+{
+    QSqlDatabase db = QSqlDatabase::database(CONNECTION_NAME, false);
+    if (!db.isOpen()) {
+        return;
+    }
+
+    QSqlQuery query(db);
+    if (!query.exec(m_walEnabled ? "PRAGMA journal_mode=WAL" : "PRAGMA journal_mode=DELETE")) {
+        qWarning() << "Failed to set journal mode:" << query.lastError().text();
+    }
+    if (!query.exec(m_synchronousNormal ? "PRAGMA synchronous=NORMAL" : "PRAGMA synchronous=FULL")) {
+        qWarning() << "Failed to set synchronous mode:" << query.lastError().text();
+    }
+
+    qDebug() << "Database pragmas - WAL:" << m_walEnabled << "synchronous=NORMAL:" << m_synchronousNormal;
+}
+
+bool DatabaseWorker::open()
+{
+    // Check if already connected
+    if (QSqlDatabase::contains(CONNECTION_NAME)) {
+        QSqlDatabase db = QSqlDatabase::database(CONNECTION_NAME);
+        if (db.isOpen()) {
+            return true;
+        }
+    }
+
+    // Create new connection
+    if (!openConnection()) {
+        QSqlDatabase db = QSqlDatabase::database(CONNECTION_NAME, false);
+        QString error = QString("Failed to open database: %1").arg(db.lastError().text());
+        qWarning() << error;
+        emit databaseError(error);
+        return false;
+    }
+
+    qDebug() << "Database opened at:" << m_databasePath;
+    createTables();
+
+    // Databases from before the rollup and day summary tables existed
+    if (rollupsNeedBackfill()) {
+        backfillRollups();
+    }
+    if (daySummaryNeedsBackfill()) {
+        backfillDaySummary();
+    }
+    return true;
+}
+
+void DatabaseWorker::createTables()
+{
+    QSqlDatabase db = QSqlDatabase::database(CONNECTION_NAME);
+    QSqlQuery query(db);
+
+    // Create readings table with all sensor fields
+    const QString createTableSql = R"(
+        CREATE TABLE IF NOT EXISTS readings (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            timestamp INTEGER NOT NULL,
+            partectorNumber INTEGER,
+            partectorDiam INTEGER,
+            partectorMass REAL,
+            grimmValue REAL,
+            temperature REAL,
+            humidity REAL,
+            pressure REAL,
+            altitude REAL,
+            latitude REAL,
+            longitude REAL,
+            co2 INTEGER,
+            device_id INTEGER NOT NULL DEFAULT 0
+        )
+    )";
+
+    if (!query.exec(createTableSql)) {
+        QString error = QString("Failed to create readings table: %1").arg(query.lastError().text());
+        qWarning() << error;
+        emit databaseError(error);
+        return;
+    }
+
+    // Databases from before multi-device ingestion: every existing row came
+    // from the single serial port, which is device 0
+    if (!hasColumn(db, "main", "readings", "device_id")
+        && !query.exec("ALTER TABLE readings ADD COLUMN device_id INTEGER NOT NULL DEFAULT 0")) {
+        QString error = QString("Failed to add device_id column: %1").arg(query.lastError().text());
+        qWarning() << error;
+        emit databaseError(error);
+    }
+
+    // Create index on timestamp for efficient range queries
+    const QString createIndexSql = R"(
+        CREATE INDEX IF NOT EXISTS idx_timestamp ON readings(timestamp)
+    )";
+
+    if (!query.exec(createIndexSql)) {
+        QString error = QString("Failed to create timestamp index: %1").arg(query.lastError().text());
+        qWarning() << error;
+        emit databaseError(error);
+    }
+
+    // Per-device range and latest-reading queries seek straight to their device's rows
+    if (!query.exec("CREATE INDEX IF NOT EXISTS idx_device_timestamp ON readings(device_id, timestamp)")) {
+        QString error = QString("Failed to create device index: %1").arg(query.lastError().text());
+        qWarning() << error;
+        emit databaseError(error);
+    }
+
+    // Rollup tiers: count plus min/max/sum of every sensor per device and bucket (mean = sum / count)
+    QStringList aggregateColumns;
+    for (const char *sensor : SENSOR_COLUMNS) {
+        aggregateColumns << QString("%1_min REAL, %1_max REAL, %1_sum REAL").arg(sensor);
+    }
+    for (const RollupTier &tier : ROLLUP_TIERS) {
+        // Tiers from before multi-device ingestion mixed every device into one bucket;
+        // dropped here and rebuilt by the backfill that follows an empty tier
+        if (!hasColumn(db, "main", tier.table, "device_id")
+            && !query.exec(QString("DROP TABLE IF EXISTS %1").arg(tier.table))) {
+            QString error = QString("Failed to drop %1 table: %2").arg(tier.table, query.lastError().text());
+            qWarning() << error;
+            emit databaseError(error);
+        }
+
+        const QString createRollupSql = QString(
+            "CREATE TABLE IF NOT EXISTS %1 (device_id INTEGER NOT NULL, bucket INTEGER NOT NULL, "
+            "count INTEGER NOT NULL, %2, PRIMARY KEY (device_id, bucket))"
+        ).arg(tier.table, aggregateColumns.join(", "));
+
+        if (!query.exec(createRollupSql)) {
+            QString error = QString("Failed to create %1 table: %2").arg(tier.table, query.lastError().text());
+            qWarning() << error;
+            emit databaseError(error);
+        }
+    }
+
+    // One row per local calendar day, so the date picker never scans readings
+    QStringList extremaColumns;
+    for (const char *sensor : SENSOR_COLUMNS) {
+        extremaColumns << QString("%1_min REAL, %1_max REAL").arg(sensor);
+    }
+    const QString createDaySummarySql = QString(
+        "CREATE TABLE IF NOT EXISTS day_summary (day TEXT PRIMARY KEY, count INTEGER NOT NULL, "
+        "first_timestamp INTEGER NOT NULL, last_timestamp INTEGER NOT NULL, %1)"
+    ).arg(extremaColumns.join(", "));
+
+    if (!query.exec(createDaySummarySql)) {
+        QString error = QString("Failed to create day_summary table: %1").arg(query.lastError().text());
+        qWarning() << error;
+        emit databaseError(error);
+    }
+
+    qDebug() << "Database tables and indexes created successfully";
+}
+
+void DatabaseWorker::insertReading(const SensorReading &reading)
+{
+    insertReadings(QList<SensorReading>{ reading });
+}
+
+void DatabaseWorker::insertReadings(const QList<SensorReading> &readings)
+{
+    m_pendingReadings.append(readings);
+
+    // A database that keeps failing must not grow the buffer without bound
+    if (m_pendingReadings.size() > MAX_PENDING_READINGS) {
+        const qsizetype lost = m_pendingReadings.size() - MAX_PENDING_READINGS;
+        m_pendingReadings.remove(0, lost);
+        QString error = QString("Dropped %1 unsaved readings: the database keeps rejecting writes").arg(lost);
+        qWarning() << error;
+        emit databaseError(error);
+    }
+
+    if (m_pendingReadings.size() >= m_batchSize) {
+        flush();
+    } else if (!m_flushTimer->isActive()) {
+        m_flushTimer->start(m_flushIntervalMs);
+    }
+}
+
+void DatabaseWorker::flush()
+{
+    m_flushTimer->stop();
+    if (m_pendingReadings.isEmpty()) {
+        return;
+    }
+
+    QSqlDatabase db = QSqlDatabase::database(CONNECTION_NAME, false);
+    if (!db.isOpen()) {
+        // Keep the readings buffered until the connection is available again
+        emit databaseError("Database not open");
+        return;
+    }
+
+    if (!m_insertQuery) {
+        m_insertQuery = std::make_unique<QSqlQuery>(db);
+        if (!m_insertQuery->prepare(R"(
+            INSERT INTO readings (
+                timestamp, partectorNumber, partectorDiam, partectorMass,
+                grimmValue, temperature, humidity, pressure,
+                altitude, latitude, longitude, co2, device_id
+            ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+        )")) {
+            QString error = QString("Failed to prepare insert: %1").arg(m_insertQuery->lastError().text());
+            qWarning() << error;
+            emit databaseError(error);
+            m_insertQuery.reset();
+            return;
+        }
+    }
+
+    // One transaction (and one journal sync) per batch instead of per reading. Without
+    // one the rows would autocommit, and a retry after a failure would insert them twice.
+    if (!db.transaction()) {
+        qWarning() << "Failed to begin transaction:" << db.lastError().text();
+        m_flushTimer->start(m_flushIntervalMs);
+        return;
+    }
+
+    QSqlQuery &query = *m_insertQuery;
+    for (const SensorReading &reading : std::as_const(m_pendingReadings)) {
+        // Store timestamp as milliseconds since epoch (INTEGER)
+        query.bindValue(0, reading.timestampMs);
+        query.bindValue(1, reading.partectorNumber);
+        query.bindValue(2, reading.partectorDiam);
+        query.bindValue(3, static_cast<double>(reading.partectorMass));
+        query.bindValue(4, static_cast<double>(reading.grimmValue));
+        query.bindValue(5, static_cast<double>(reading.temperature));
+        query.bindValue(6, static_cast<double>(reading.humidity));
+        query.bindValue(7, static_cast<double>(reading.pressure));
+        query.bindValue(8, static_cast<double>(reading.altitude));
+        query.bindValue(9, static_cast<double>(reading.latitude));
+        query.bindValue(10, static_cast<double>(reading.longitude));
+        query.bindValue(11, reading.co2);
+        query.bindValue(12, reading.deviceId);
+
+        if (!query.exec()) {
+            QString error = QString("Failed to insert reading: %1").arg(query.lastError().text());
+            qWarning() << error;
+            emit databaseError(error);
+        }
+    }
+
+    // Rollups and the day summary are updated in the same transaction, so they
+    // never disagree with readings
+    updateRollups(m_pendingReadings);
+    updateDaySummary(m_pendingReadings);
+
+    if (!db.commit()) {
+        QString error = QString("Failed to commit readings: %1").arg(db.lastError().text());
+        qWarning() << error;
+        emit databaseError(error);
+        db.rollback();
+
+        // The rollback undid the rollups and day summary too; retry the whole batch later
+        m_flushTimer->start(m_flushIntervalMs);
+        return;
+    }
+
+    m_pendingReadings.clear();
+}
+
+ReadingColumns DatabaseWorker::readingColumnsInRange(qint64 startMs, qint64 endMs, int deviceId,
+                                                     const CancelCheck &isCanceled)
+{
+    ReadingColumns columns;
+
+    // Make buffered readings visible to the query
+    flush();
+
+    QSqlDatabase db = QSqlDatabase::database(CONNECTION_NAME);
+    if (!db.isOpen()) {
+        emit databaseError("Database not open");
+        return columns;
+    }
+
+    QSqlQuery query(db);
+    query.setForwardOnly(true);  // Memory efficient for large result sets
+
+    // Size the columns up front
+    columns.reserve(countReadings(startMs, endMs, deviceId));
+
+    // A single device is matched by equality so idx_device_timestamp serves it
+    query.prepare(QString(R"(
+        SELECT id, timestamp, partectorNumber, partectorDiam, partectorMass,
+               grimmValue, temperature, humidity, pressure,
+               altitude, latitude, longitude, co2, device_id
+        FROM readings
+        WHERE %1timestamp BETWEEN ? AND ?
+        ORDER BY timestamp ASC
+    )").arg(deviceCondition(deviceId)));
+
+    if (deviceId != ALL_DEVICES) {
+        query.addBindValue(deviceId);
+    }
+    query.addBindValue(startMs);
+    query.addBindValue(endMs);
+
+    if (!query.exec()) {
+        QString error = QString("Failed to query readings: %1").arg(query.lastError().text());
+        qWarning() << error;
+        emit databaseError(error);
+        return columns;
+    }
+
+    int rowCount = 0;
+    while (query.next()) {
+        // A newer request superseded this one - stop early
+        if ((++rowCount & 1023) == 0 && isCanceled && isCanceled()) {
+            qDebug() << "Range query canceled after" << rowCount << "rows";
+            return ReadingColumns();
+        }
+
+        appendReadingRow(query, columns);
+    }
+
+    return columns;
+}
+
+ReadingColumns DatabaseWorker::latestReading(int deviceId)
+{
+    ReadingColumns columns;
+
+    // Make buffered readings visible to the query
+    flush();
+
+    QSqlDatabase db = QSqlDatabase::database(CONNECTION_NAME);
+    if (!db.isOpen()) {
+        emit databaseError("Database not open");
+        return columns;
+    }
+
+    // A single step backwards through idx_device_timestamp, or idx_timestamp for all devices
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    query.prepare(QString(R"(
+        SELECT id, timestamp, partectorNumber, partectorDiam, partectorMass,
+               grimmValue, temperature, humidity, pressure,
+               altitude, latitude, longitude, co2, device_id
+        FROM readings
+        %1ORDER BY timestamp DESC
+        LIMIT 1
+    )").arg(deviceId == ALL_DEVICES ? QString() : QString("WHERE device_id = ? ")));
+    if (deviceId != ALL_DEVICES) {
+        query.addBindValue(deviceId);
+    }
+    if (!query.exec()) {
+        qWarning() << "Failed to query latest reading:" << query.lastError().text();
+        return columns;
+    }
+
+    if (query.next()) {
+        appendReadingRow(query, columns);
+    }
+
+    return columns;
+}
+
+qint64 DatabaseWorker::countReadings(qint64 startMs, qint64 endMs, int deviceId)
+{
+    // Answered from the timestamp or device index without touching the rows
+    QSqlQuery query(QSqlDatabase::database(CONNECTION_NAME));
+    query.prepare(QString("SELECT COUNT(*) FROM readings WHERE %1timestamp BETWEEN ? AND ?")
+                      .arg(deviceCondition(deviceId)));
+    if (deviceId != ALL_DEVICES) {
+        query.addBindValue(deviceId);
+    }
+    query.addBindValue(startMs);
+    query.addBindValue(endMs);
+    if (query.exec() && query.next()) {
+        return query.value(0).toLongLong();
+    }
+    return 0;
+}
+
+ReadingColumns DatabaseWorker::chartColumnsInRange(qint64 startMs, qint64 endMs, int pointBudget, int deviceId,
+                                                   const CancelCheck &isCanceled)
+{
+    // Make buffered readings visible to the query
+    flush();
+
+    if (pointBudget > 0) {
+        const qint64 rawCount = countReadings(startMs, endMs, deviceId);
+        const qint64 pixelColumns = qMax(1, pointBudget / 2);
+        const qint64 span = endMs - startMs;
+
+        for (int tier = ROLLUP_TIER_COUNT - 1; tier >= 0; --tier) {
+            // Each bucket yields a min and a max row; only worth it if that beats the raw rows
+            const qint64 buckets = span / ROLLUP_TIERS[tier].widthMs;
+            if (buckets >= pixelColumns && 2 * buckets < rawCount) {
+                qDebug() << "Serving chart range from" << ROLLUP_TIERS[tier].table
+                         << "instead of" << rawCount << "raw rows";
+                return rollupColumnsInRange(tier, startMs, endMs, deviceId, isCanceled);
+            }
+        }
+    }
+
+    return readingColumnsInRange(startMs, endMs, deviceId, isCanceled);
+}
+
+ReadingColumns DatabaseWorker::rollupColumnsInRange(int tier, qint64 startMs, qint64 endMs, int deviceId,
+                                                    const CancelCheck &isCanceled)
+{
+    ReadingColumns columns;
+    const RollupTier &rollup = ROLLUP_TIERS[tier];
+
+    QStringList selectColumns;
+    for (const char *sensor : SENSOR_COLUMNS) {
+        selectColumns << QString("%1_min").arg(sensor);
+    }
+    for (const char *sensor : SENSOR_COLUMNS) {
+        selectColumns << QString("%1_max").arg(sensor);
+    }
+
+    QSqlQuery query(QSqlDatabase::database(CONNECTION_NAME));
+    query.setForwardOnly(true);
+    query.prepare(QString("SELECT bucket, %1 FROM %2 WHERE device_id = ? AND bucket BETWEEN ? AND ? "
+                          "ORDER BY bucket ASC")
+                      .arg(selectColumns.join(", "), rollup.table));
+    query.addBindValue(deviceId);
+    query.addBindValue(bucketStart(startMs, rollup.widthMs));
+    query.addBindValue(endMs);
+
+    if (!query.exec()) {
+        QString error = QString("Failed to query %1: %2").arg(rollup.table, query.lastError().text());
+        qWarning() << error;
+        emit databaseError(error);
+        return columns;
+    }
+
+    columns.reserve(2 * ((endMs - startMs) / rollup.widthMs + 1));
+
+    int rowCount = 0;
+    SensorValues minValues;
+    SensorValues maxValues;
+    while (query.next()) {
+        // A newer request superseded this one - stop early
+        if ((++rowCount & 1023) == 0 && isCanceled && isCanceled()) {
+            qDebug() << "Rollup query canceled after" << rowCount << "rows";
+            return ReadingColumns();
+        }
+
+        for (int sensor = 0; sensor < ReadingColumns::SensorCount; ++sensor) {
+            minValues[sensor] = query.value(1 + sensor).toDouble();
+            maxValues[sensor] = query.value(1 + ReadingColumns::SensorCount + sensor).toDouble();
+        }
+
+        // Two rows per bucket keep the envelope, so spikes survive the coarser tier
+        const qint64 bucket = query.value(0).toLongLong();
+        columns.appendSensorValues(bucket, minValues, deviceId);
+        columns.appendSensorValues(bucket + rollup.widthMs / 2, maxValues, deviceId);
+    }
+
+    return columns;
+}
+
+bool DatabaseWorker::updateRollups(const QList<SensorReading> &readings)
+{
+    QSqlDatabase db = QSqlDatabase::database(CONNECTION_NAME, false);
+
+    struct Bucket {
+        qint64 count = 0;
+        SensorValues min;
+        SensorValues max;
+        SensorValues sum;
+    };
+
+    bool ok = true;
+    for (int tier = 0; tier < ROLLUP_TIER_COUNT; ++tier) {
+        const RollupTier &rollup = ROLLUP_TIERS[tier];
+
+        // Aggregate the batch in memory first: one upsert per touched device and bucket
+        std::map<std::pair<int, qint64>, Bucket> buckets;
+        for (const SensorReading &reading : readings) {
+            const SensorValues values = sensorValues(reading);
+            Bucket &bucket = buckets[{ reading.deviceId, bucketStart(reading.timestampMs, rollup.widthMs) }];
+            if (bucket.count == 0) {
+                bucket.min = values;
+                bucket.max = values;
+                bucket.sum = values;
+            } else {
+                for (int sensor = 0; sensor < ReadingColumns::SensorCount; ++sensor) {
+                    bucket.min[sensor] = qMin(bucket.min[sensor], values[sensor]);
+                    bucket.max[sensor] = qMax(bucket.max[sensor], values[sensor]);
+                    bucket.sum[sensor] += values[sensor];
+                }
+            }
+            ++bucket.count;
+        }
+
+        std::unique_ptr<QSqlQuery> &upsert = m_rollupQueries[tier];
+        if (!upsert) {
+            QStringList columns;
+            QStringList placeholders;
+            QStringList updates;
+            for (const char *sensor : SENSOR_COLUMNS) {
+                columns << QString("%1_min, %1_max, %1_sum").arg(sensor);
+                placeholders << "?, ?, ?";
+                updates << QString("%1_min = MIN(%1_min, excluded.%1_min), "
+                                   "%1_max = MAX(%1_max, excluded.%1_max), "
+                                   "%1_sum = %1_sum + excluded.%1_sum").arg(sensor);
+            }
+
+            upsert = std::make_unique<QSqlQuery>(db);
+            if (!upsert->prepare(QString(
+                    "INSERT INTO %1 (device_id, bucket, count, %2) VALUES (?, ?, ?, %3) "
+                    "ON CONFLICT(device_id, bucket) DO UPDATE SET count = count + excluded.count, %4")
+                    .arg(rollup.table, columns.join(", "), placeholders.join(", "), updates.join(", ")))) {
+                QString error = QString("Failed to prepare %1 upsert: %2").arg(rollup.table, upsert->lastError().text());
+                qWarning() << error;
+                emit databaseError(error);
+                upsert.reset();
+                ok = false;
+                continue;
+            }
+        }
+
+        QSqlQuery &query = *upsert;
+        for (const auto &[key, bucket] : buckets) {
+            query.bindValue(0, key.first);
+            query.bindValue(1, key.second);
+            query.bindValue(2, bucket.count);
+            for (int sensor = 0; sensor < ReadingColumns::SensorCount; ++sensor) {
+                query.bindValue(3 + sensor * 3, bucket.min[sensor]);
+                query.bindValue(4 + sensor * 3, bucket.max[sensor]);
+                query.bindValue(5 + sensor * 3, bucket.sum[sensor]);
+            }
+
+            if (!query.exec()) {
+                QString error = QString("Failed to update %1: %2").arg(rollup.table, query.lastError().text());
+                qWarning() << error;
+                emit databaseError(error);
+                ok = false;
+            }
+        }
+    }
+
+    return ok;
+}
+
+bool DatabaseWorker::rollupsNeedBackfill()
+{
+    QSqlQuery query(QSqlDatabase::database(CONNECTION_NAME));
+    if (query.exec(QString("SELECT EXISTS(SELECT 1 FROM readings) AND NOT EXISTS(SELECT 1 FROM %1)")
+                       .arg(ROLLUP_TIERS[0].table))
+        && query.next()) {
+        return query.value(0).toBool();
+    }
+    return false;
+}
+
+bool DatabaseWorker::backfillRollups()
+{
+    return backfillRollups(std::numeric_limits<qint64>::min(), std::numeric_limits<qint64>::max());
+}
+
+bool DatabaseWorker::backfillRollups(qint64 fromMs, qint64 toMs)
+{
+    // Make buffered readings part of the rebuild
+    flush();
+
+    QSqlDatabase db = QSqlDatabase::database(CONNECTION_NAME, false);
+    if (!db.isOpen()) {
+        emit databaseError("Database not open");
+        return false;
+    }
+
+    // A partial rebuild covers whole buckets of the coarsest tier, and with them
+    // whole buckets of every finer tier (each width divides the next)
+    const bool partial = fromMs != std::numeric_limits<qint64>::min()
+                         || toMs != std::numeric_limits<qint64>::max();
+    qint64 rangeStart = 0;
+    qint64 rangeEnd = 0;  // Exclusive
+    if (partial) {
+        const qint64 coarsestMs = ROLLUP_TIERS[ROLLUP_TIER_COUNT - 1].widthMs;
+        rangeStart = bucketStart(fromMs, coarsestMs);
+        rangeEnd = bucketStart(toMs, coarsestMs) + coarsestMs;
+    }
+
+    qDebug() << "Backfilling rollup tables..." << (partial ? "(partial)" : "");
+    db.transaction();
+
+    QSqlQuery query(db);
+    bool ok = true;
+    for (int tier = 0; tier < ROLLUP_TIER_COUNT && ok; ++tier) {
+        const RollupTier &rollup = ROLLUP_TIERS[tier];
+
+        // The finest tier comes from raw readings, every coarser one from the tier below it
+        QStringList columns;
+        QStringList aggregates;
+        for (const char *sensor : SENSOR_COLUMNS) {
+            columns << QString("%1_min, %1_max, %1_sum").arg(sensor);
+            if (tier == 0) {
+                aggregates << QString("MIN(%1), MAX(%1), SUM(%1)").arg(sensor);
+            } else {
+                aggregates << QString("MIN(%1_min), MAX(%1_max), SUM(%1_sum)").arg(sensor);
+            }
+        }
+        const QString source = tier == 0 ? QString("readings") : QString(ROLLUP_TIERS[tier - 1].table);
+        const QString timeColumn = tier == 0 ? QString("timestamp") : QString("bucket");
+        const QString countExpr = tier == 0 ? QString("COUNT(*)") : QString("SUM(count)");
+
+        auto inRange = [&](const QString &column) {
+            return partial ? QString(" WHERE %1 >= %2 AND %1 < %3").arg(column).arg(rangeStart).arg(rangeEnd)
+                           : QString();
+        };
+
+        ok = query.exec(QString("DELETE FROM %1").arg(rollup.table) + inRange("bucket"))
+            && query.exec(QString("INSERT INTO %1 (device_id, bucket, count, %2) "
+                                  "SELECT device_id, (%3 / %4) * %4 AS b, %5, %6 FROM %7")
+                              .arg(rollup.table, columns.join(", "), timeColumn)
+                              .arg(rollup.widthMs)
+                              .arg(countExpr, aggregates.join(", "), source)
+                          + inRange(timeColumn) + " GROUP BY device_id, b");
+    }
+
+    if (!ok) {
+        QString error = QString("Failed to backfill rollups: %1").arg(query.lastError().text());
+        qWarning() << error;
+        emit databaseError(error);
+        db.rollback();
+        return false;
+    }
+
+    if (!db.commit()) {
+        QString error = QString("Failed to commit rollup backfill: %1").arg(db.lastError().text());
+        qWarning() << error;
+        emit databaseError(error);
+        db.rollback();
+        return false;
+    }
+
+    qDebug() << "Rollup tables backfilled";
+    return true;
+}
+
+bool DatabaseWorker::updateDaySummary(const QList<SensorReading> &readings)
+{
+    QSqlDatabase db = QSqlDatabase::database(CONNECTION_NAME, false);
+
+    struct Day {
+        qint64 count = 0;
+        qint64 first = 0;
+        qint64 last = 0;
+        SensorValues min;
+        SensorValues max;
+    };
+
+    // Keyed by local "yyyy-MM-dd", matching date(..., 'localtime') in the backfill.
+    // A batch rarely spans midnight, so the local day is looked up only when a
+    // reading leaves the day of the previous one.
+    std::map<QString, Day> days;
+    Day *current = nullptr;
+    qint64 dayStartMs = 0;
+    qint64 dayEndMs = 0;  // Exclusive
+    for (const SensorReading &reading : readings) {
+        const qint64 timestampMs = reading.timestampMs;
+        const SensorValues values = sensorValues(reading);
+        if (!current || timestampMs < dayStartMs || timestampMs >= dayEndMs) {
+            const QDate date = QDateTime::fromMSecsSinceEpoch(timestampMs).date();
+            dayStartMs = date.startOfDay().toMSecsSinceEpoch();
+            dayEndMs = date.addDays(1).startOfDay().toMSecsSinceEpoch();
+            current = &days[date.toString(Qt::ISODate)];
+        }
+        if (current->count == 0) {
+            current->first = timestampMs;
+            current->last = timestampMs;
+            current->min = values;
+            current->max = values;
+        } else {
+            current->first = qMin(current->first, timestampMs);
+            current->last = qMax(current->last, timestampMs);
+            for (int sensor = 0; sensor < ReadingColumns::SensorCount; ++sensor) {
+                current->min[sensor] = qMin(current->min[sensor], values[sensor]);
+                current->max[sensor] = qMax(current->max[sensor], values[sensor]);
+            }
+        }
+        ++current->count;
+    }
+
+    if (!m_daySummaryQuery) {
+        QStringList columns;
+        QStringList placeholders;
+        QStringList updates;
+        for (const char *sensor : SENSOR_COLUMNS) {
+            columns << QString("%1_min, %1_max").arg(sensor);
+            placeholders << "?, ?";
+            updates << QString("%1_min = MIN(%1_min, excluded.%1_min), "
+                               "%1_max = MAX(%1_max, excluded.%1_max)").arg(sensor);
+        }
+
+        m_daySummaryQuery = std::make_unique<QSqlQuery>(db);
+        if (!m_daySummaryQuery->prepare(QString(
+                "INSERT INTO day_summary (day, count, first_timestamp, last_timestamp, %1) "
+                "VALUES (?, ?, ?, ?, %2) "
+                "ON CONFLICT(day) DO UPDATE SET count = count + excluded.count, "
+                "first_timestamp = MIN(first_timestamp, excluded.first_timestamp), "
+                "last_timestamp = MAX(last_timestamp, excluded.last_timestamp), %3")
+                .arg(columns.join(", "), placeholders.join(", "), updates.join(", ")))) {
+            QString error = QString("Failed to prepare day_summary upsert: %1").arg(m_daySummaryQuery->lastError().text());
+            qWarning() << error;
+            emit databaseError(error);
+            m_daySummaryQuery.reset();
+            return false;
+        }
+    }
+
+    bool ok = true;
+    QSqlQuery &query = *m_daySummaryQuery;
+    for (const auto &[date, day] : days) {
+        query.bindValue(0, date);
+        query.bindValue(1, day.count);
+        query.bindValue(2, day.first);
+        query.bindValue(3, day.last);
+        for (int sensor = 0; sensor < ReadingColumns::SensorCount; ++sensor) {
+            query.bindValue(4 + sensor * 2, day.min[sensor]);
+            query.bindValue(5 + sensor * 2, day.max[sensor]);
+        }
+
+        if (!query.exec()) {
+            QString error = QString("Failed to update day_summary: %1").arg(query.lastError().text());
+            qWarning() << error;
+            emit databaseError(error);
+            ok = false;
+        }
+    }
+
+    return ok;
+}
+
+bool DatabaseWorker::daySummaryNeedsBackfill()
+{
+    QSqlQuery query(QSqlDatabase::database(CONNECTION_NAME));
+    if (query.exec("SELECT EXISTS(SELECT 1 FROM readings) AND NOT EXISTS(SELECT 1 FROM day_summary)")
+        && query.next()) {
+        return query.value(0).toBool();
+    }
+    return false;
+}
+
+bool DatabaseWorker::backfillDaySummary()
+{
+    return backfillDaySummary(std::numeric_limits<qint64>::min(), std::numeric_limits<qint64>::max());
+}
+
+bool DatabaseWorker::backfillDaySummary(qint64 fromMs, qint64 toMs)
+{
+    // Make buffered readings part of the rebuild
+    flush();
+
+    QSqlDatabase db = QSqlDatabase::database(CONNECTION_NAME, false);
+    if (!db.isOpen()) {
+        emit databaseError("Database not open");
+        return false;
+    }
+
+    // A partial rebuild covers whole local days
+    const bool partial = fromMs != std::numeric_limits<qint64>::min()
+                         || toMs != std::numeric_limits<qint64>::max();
+    const QDate firstDay = QDateTime::fromMSecsSinceEpoch(fromMs).date();
+    const QDate lastDay = QDateTime::fromMSecsSinceEpoch(toMs).date();
+
+    QStringList columns;
+    QStringList aggregates;
+    for (const char *sensor : SENSOR_COLUMNS) {
+        columns << QString("%1_min, %1_max").arg(sensor);
+        aggregates << QString("MIN(%1), MAX(%1)").arg(sensor);
+    }
+
+    qDebug() << "Backfilling day summary..." << (partial ? "(partial)" : "");
+    db.transaction();
+
+    QSqlQuery deleteQuery(db);
+    QSqlQuery insertQuery(db);
+    if (partial) {
+        deleteQuery.prepare("DELETE FROM day_summary WHERE day >= ? AND day <= ?");
+        deleteQuery.addBindValue(firstDay.toString(Qt::ISODate));
+        deleteQuery.addBindValue(lastDay.toString(Qt::ISODate));
+    } else {
+        deleteQuery.prepare("DELETE FROM day_summary");
+    }
+
+    insertQuery.prepare(QString(
+        "INSERT INTO day_summary (day, count, first_timestamp, last_timestamp, %1) "
+        "SELECT date(timestamp / 1000, 'unixepoch', 'localtime') AS d, COUNT(*), "
+        "MIN(timestamp), MAX(timestamp), %2 FROM readings%3 GROUP BY d")
+        .arg(columns.join(", "), aggregates.join(", "),
+             partial ? QString(" WHERE timestamp >= ? AND timestamp < ?") : QString()));
+    if (partial) {
+        insertQuery.addBindValue(firstDay.startOfDay().toMSecsSinceEpoch());
+        insertQuery.addBindValue(lastDay.addDays(1).startOfDay().toMSecsSinceEpoch());
+    }
+
+    if (!deleteQuery.exec() || !insertQuery.exec()) {
+        const QString message = deleteQuery.lastError().isValid() ? deleteQuery.lastError().text()
+                                                                  : insertQuery.lastError().text();
+        QString error = QString("Failed to backfill day summary: %1").arg(message);
+        qWarning() << error;
+        emit databaseError(error);
+        db.rollback();
+        return false;
+    }
+
+    if (!db.commit()) {
+        QString error = QString("Failed to commit day summary backfill: %1").arg(db.lastError().text());
+        qWarning() << error;
+        emit databaseError(error);
+        db.rollback();
+        return false;
+    }
+
+    qDebug() << "Day summary backfilled";
+    return true;
+}
+
+QVariantMap DatabaseWorker::readingById(int id)
+{
+    QVariantMap result;
+
+    // Make buffered readings visible to the query
+    flush();
+
+    QSqlDatabase db = QSqlDatabase::database(CONNECTION_NAME);
+    if (!db.isOpen()) {
+        qWarning() << "Database not open";
+        return result;
+    }
+
+    QSqlQuery query(db);
+    query.prepare(R"(
+        SELECT id, timestamp, partectorNumber, partectorDiam, partectorMass,
+               grimmValue, temperature, humidity, pressure,
+               altitude, latitude, longitude, co2, device_id
+        FROM readings
+        WHERE id = ?
+    )");
+
+    query.addBindValue(id);
+
+    if (!query.exec()) {
+        qWarning() << "Failed to get reading by ID:" << query.lastError().text();
+        return result;
+    }
+
+    if (query.next()) {
+        result["id"] = query.value(0).toInt();
+        result["timestamp"] = QDateTime::fromMSecsSinceEpoch(query.value(1).toLongLong());
+        result["partectorNumber"] = query.value(2).toInt();
+        result["partectorDiam"] = query.value(3).toInt();
+        result["partectorMass"] = query.value(4).toDouble();
+        result["grimmValue"] = query.value(5).toDouble();
+        result["temperature"] = query.value(6).toDouble();
+        result["humidity"] = query.value(7).toDouble();
+        result["pressure"] = query.value(8).toDouble();
+        result["altitude"] = query.value(9).toDouble();
+        result["latitude"] = query.value(10).toDouble();
+        result["longitude"] = query.value(11).toDouble();
+        result["co2"] = query.value(12).toInt();
+        result["deviceId"] = query.value(13).toInt();
+    }
+
+    return result;
+}
+
+bool DatabaseWorker::exportTo(const QString &destPath, const ProgressCallback &started)
+{
+    // Make buffered readings part of the copy
+    flush();
+
+    QSqlDatabase db = QSqlDatabase::database(CONNECTION_NAME);
+    if (!db.isOpen()) {
+        emit databaseError("Database not open");
+        return false;
+    }
+
+    // Expected size of the compacted copy: the used (non-free) pages
+    QSqlQuery query(db);
+    qint64 pageSize = 0;
+    qint64 usedPages = 0;
+    if (query.exec("PRAGMA page_size") && query.next())
+        pageSize = query.value(0).toLongLong();
+    if (query.exec("PRAGMA page_count") && query.next())
+        usedPages = query.value(0).toLongLong();
+    if (query.exec("PRAGMA freelist_count") && query.next())
+        usedPages -= query.value(0).toLongLong();
+    if (started)
+        started(0, pageSize * usedPages);
+
+    // VACUUM INTO refuses to overwrite a non-empty file
+    if (QFile::exists(destPath) && !QFile::remove(destPath)) {
+        QString error = QString("Failed to replace existing file: %1").arg(destPath);
+        qWarning() << error;
+        emit databaseError(error);
+        return false;
+    }
+
+    // Online, compacted copy inside a read transaction: the connection stays
+    // open, and readings arriving meanwhile are queued for the next flush
+    query.prepare("VACUUM INTO ?");
+    query.addBindValue(destPath);
+    if (!query.exec()) {
+        QString error = QString("Failed to export database to %1: %2").arg(destPath, query.lastError().text());
+        qWarning() << error;
+        emit databaseError(error);
+        QFile::remove(destPath);
+        return false;
+    }
+
+    qDebug() << "Database exported to" << destPath;
+    return true;
+}
+
+qint64 DatabaseWorker::exportRangeToCsv(qint64 startMs, qint64 endMs, const QString &destPath,
+                                        const ProgressCallback &progress, const CancelCheck &isCanceled)
+{
+    // Rows are written in chunks of about this size; with the forward-only cursor
+    // this bounds memory regardless of the range length
+    static constexpr qsizetype EXPORT_CHUNK_BYTES = 1024 * 1024;
+
+    // Make buffered readings part of the export
+    flush();
+
+    QSqlDatabase db = QSqlDatabase::database(CONNECTION_NAME);
+    if (!db.isOpen()) {
+        emit databaseError("Database not open");
+        return -1;
+    }
+
+    QFile file(destPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        QString error = QString("Failed to open export file: %1").arg(file.errorString());
+        qWarning() << error;
+        emit databaseError(error);
+        return -1;
+    }
+
+    const qint64 total = countReadings(startMs, endMs);
+
+    QSqlQuery query(db);
+    query.setForwardOnly(true);  // Rows are stepped through, never cached
+    query.prepare(R"(
+        SELECT timestamp, partectorNumber, partectorDiam, partectorMass,
+               grimmValue, temperature, humidity, pressure,
+               altitude, latitude, longitude, co2, device_id
+        FROM readings
+        WHERE timestamp BETWEEN ? AND ?
+        ORDER BY timestamp ASC
+    )");
+    query.addBindValue(startMs);
+    query.addBindValue(endMs);
+
+    if (!query.exec()) {
+        QString error = QString("Failed to query readings for export: %1").arg(query.lastError().text());
+        qWarning() << error;
+        emit databaseError(error);
+        file.remove();
+        return -1;
+    }
+
+    QByteArray buffer;
+    buffer.reserve(EXPORT_CHUNK_BYTES + 1024);
+    appendCsvHeader(buffer);
+
+    auto writeBuffer = [&file, &buffer]() {
+        const bool ok = file.write(buffer) == buffer.size();
+        buffer.resize(0);
+        return ok;
+    };
+
+    qint64 rows = 0;
+    SensorReading reading;
+    while (query.next()) {
+        reading.timestampMs = query.value(0).toLongLong();
+        reading.partectorNumber = query.value(1).toInt();
+        reading.partectorDiam = query.value(2).toInt();
+        reading.partectorMass = query.value(3).toFloat();
+        reading.grimmValue = query.value(4).toFloat();
+        reading.temperature = query.value(5).toFloat();
+        reading.humidity = query.value(6).toFloat();
+        reading.pressure = query.value(7).toFloat();
+        reading.altitude = query.value(8).toFloat();
+        reading.latitude = query.value(9).toFloat();
+        reading.longitude = query.value(10).toFloat();
+        reading.co2 = query.value(11).toInt();
+        reading.deviceId = query.value(12).toInt();
+        appendCsvRow(buffer, reading);
+        ++rows;
+
+        if (buffer.size() >= EXPORT_CHUNK_BYTES && !writeBuffer()) {
+            break;
+        }
+
+        if ((rows & 16383) == 0) {
+            if (isCanceled && isCanceled()) {
+                qDebug() << "Range export canceled after" << rows << "rows";
+                file.remove();
+                return -1;
+            }
+            if (progress)
+                progress(rows, total);
+        }
+    }
+
+    if (file.error() != QFileDevice::NoError || !writeBuffer()) {
+        QString error = QString("Failed to write export file: %1").arg(file.errorString());
+        qWarning() << error;
+        emit databaseError(error);
+        file.remove();
+        return -1;
+    }
+
+    file.close();
+    if (progress)
+        progress(rows, rows);
+    qDebug() << "Exported" << rows << "readings to" << destPath;
+    return rows;
+}
+
+bool DatabaseWorker::importFrom(const QString &sourcePath)
+{
+    // Write out buffered readings and close the connection before importing
+    flush();
+    closeConnection();
+
+    // Backup current database
+    QString backupPath = m_databasePath + ".backup";
+    bool hadExisting = QFile::exists(m_databasePath);
+    if (hadExisting) {
+        QFile::remove(backupPath);  // Remove old backup if exists
+        if (!QFile::rename(m_databasePath, backupPath)) {
+            emit databaseError("Failed to backup current database");
+            // Try to reopen original
+            openConnection();
+            return false;
+        }
+    }
+
+    // Copy import file to database location
+    bool success = QFile::copy(sourcePath, m_databasePath);
+
+    if (success) {
+        // Remove backup on success
+        if (hadExisting) {
+            QFile::remove(backupPath);
+        }
+    } else {
+        // Restore backup on failure
+        if (hadExisting) {
+            QFile::rename(backupPath, m_databasePath);
+        }
+        emit databaseError("Failed to import database");
+    }
+
+    // Reopen the connection
+    if (!openConnection()) {
+        qWarning() << "Failed to reopen database after import";
+        emit databaseError("Failed to reopen database after import");
+        success = false;
+    } else {
+        // Imported files may predate the current schema
+        createTables();
+        if (rollupsNeedBackfill()) {
+            backfillRollups();
+        }
+        if (daySummaryNeedsBackfill()) {
+            backfillDaySummary();
+        }
+    }
+
+    return success;
+}
+
+qint64 DatabaseWorker::mergeFrom(const QString &sourcePath, const ProgressCallback &progress,
+                                 const CancelCheck &isCanceled)
+{
+    // Source rows per transaction: large enough to amortize the commit, small
+    // enough to keep each write transaction (and its journal) short
+    static constexpr qint64 MERGE_CHUNK_ROWS = 50000;
+
+    flush();
+
+    QSqlDatabase db = QSqlDatabase::database(CONNECTION_NAME);
+    if (!db.isOpen()) {
+        emit databaseError("Database not open");
+        return -1;
+    }
+
+    QSqlQuery query(db);
+    query.prepare("ATTACH DATABASE ? AS merge_src");
+    query.addBindValue(sourcePath);
+    if (!query.exec()) {
+        QString error = QString("Failed to attach %1: %2").arg(sourcePath, query.lastError().text());
+        qWarning() << error;
+        emit databaseError(error);
+        return -1;
+    }
+
+    auto detach = [&db]() {
+        QSqlQuery detachQuery(db);
+        if (!detachQuery.exec("DETACH DATABASE merge_src")) {
+            qWarning() << "Failed to detach merge source:" << detachQuery.lastError().text();
+        }
+    };
+
+    // Walk the source in id ranges; each range is one indexed rowid scan
+    qint64 firstId = 0;
+    qint64 lastId = -1;
+    qint64 minTimestamp = 0;
+    qint64 maxTimestamp = 0;
+    if (!query.exec("SELECT MIN(id), MAX(id), MIN(timestamp), MAX(timestamp) FROM merge_src.readings")
+        || !query.next()) {
+        QString error = QString("Not a ZephyrSense database: %1").arg(query.lastError().text());
+        qWarning() << error;
+        emit databaseError(error);
+        query.finish();
+        detach();
+        return -1;
+    }
+    if (!query.value(0).isNull()) {
+        firstId = query.value(0).toLongLong();
+        lastId = query.value(1).toLongLong();
+        minTimestamp = query.value(2).toLongLong();
+        maxTimestamp = query.value(3).toLongLong();
+    }
+    query.finish();
+
+    // Sources from before multi-device ingestion hold device 0 only
+    const QString sourceDevice = hasColumn(db, "merge_src", "readings", "device_id")
+        ? QString("s.device_id") : QString("0");
+
+    // Duplicates are rows with a (timestamp, device) the target already has, or
+    // an earlier row of the same chunk with that pair (GROUP BY keeps one)
+    query.prepare(QString(R"(
+        INSERT INTO readings (timestamp, partectorNumber, partectorDiam, partectorMass,
+                              grimmValue, temperature, humidity, pressure,
+                              altitude, latitude, longitude, co2, device_id)
+        SELECT s.timestamp, s.partectorNumber, s.partectorDiam, s.partectorMass,
+               s.grimmValue, s.temperature, s.humidity, s.pressure,
+               s.altitude, s.latitude, s.longitude, s.co2, %1 AS d
+        FROM merge_src.readings s
+        WHERE s.id >= ? AND s.id < ?
+          AND NOT EXISTS (SELECT 1 FROM main.readings r
+                          WHERE r.timestamp = s.timestamp AND r.device_id = %1)
+        GROUP BY s.timestamp, d
+    )").arg(sourceDevice));
+
+    const qint64 total = lastId - firstId + 1;
+    qint64 inserted = 0;
+    bool ok = true;
+    bool canceled = false;
+
+    for (qint64 chunkStart = firstId; chunkStart <= lastId; chunkStart += MERGE_CHUNK_ROWS) {
+        if (isCanceled && isCanceled()) {
+            canceled = true;
+            break;
+        }
+
+        db.transaction();
+        query.addBindValue(chunkStart);
+        query.addBindValue(chunkStart + MERGE_CHUNK_ROWS);
+        if (!query.exec() || !db.commit()) {
+            QString error = QString("Failed to merge readings: %1").arg(query.lastError().text());
+            qWarning() << error;
+            emit databaseError(error);
+            db.rollback();
+            ok = false;
+            break;
+        }
+        inserted += query.numRowsAffected();
+
+        if (progress)
+            progress(qMin(total, chunkStart + MERGE_CHUNK_ROWS - firstId), total);
+    }
+    query.finish();
+    detach();
+
+    // Rollups and day summaries only change where rows were added
+    if (inserted > 0) {
+        backfillRollups(minTimestamp, maxTimestamp);
+        backfillDaySummary(minTimestamp, maxTimestamp);
+    }
+
+    qDebug() << "Merged" << inserted << "readings from" << sourcePath << (canceled ? "(canceled)" : "");
+    return ok && !canceled ? inserted : -1;
+}
+
+QVariantList DatabaseWorker::availableDates()
+{
+    QVariantList dates;
+
+    // Make buffered readings visible to the query
+    flush();
+
+    QSqlDatabase db = QSqlDatabase::database(CONNECTION_NAME);
+    if (!db.isOpen()) {
+        qWarning() << "Database not open for getAvailableDates";
+        return dates;
+    }
+
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+
+    // One primary key scan of day_summary, independent of the number of readings
+    if (!query.exec("SELECT day FROM day_summary ORDER BY day DESC")) {
+        qWarning() << "Failed to query available dates:" << query.lastError().text();
+        return dates;
+    }
+
+    while (query.next()) {
+        dates.append(query.value(0).toString());  // Format: "2026-01-25"
+    }
+
+    return dates;
+}
+
+QVariantList DatabaseWorker::daySummaries()
+{
+    QVariantList summaries;
+
+    // Make buffered readings visible to the query
+    flush();
+
+    QSqlDatabase db = QSqlDatabase::database(CONNECTION_NAME);
+    if (!db.isOpen()) {
+        qWarning() << "Database not open for daySummaries";
+        return summaries;
+    }
+
+    QStringList columns;
+    for (const char *sensor : SENSOR_COLUMNS) {
+        columns << QString("%1_min, %1_max").arg(sensor);
+    }
+
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    if (!query.exec(QString("SELECT day, count, first_timestamp, last_timestamp, %1 "
+                            "FROM day_summary ORDER BY day DESC").arg(columns.join(", ")))) {
+        qWarning() << "Failed to query day summaries:" << query.lastError().text();
+        return summaries;
+    }
+
+    while (query.next()) {
+        QVariantMap day;
+        day["date"] = query.value(0).toString();
+        day["count"] = query.value(1).toLongLong();
+        day["firstTimestamp"] = query.value(2).toLongLong();
+        day["lastTimestamp"] = query.value(3).toLongLong();
+        for (int sensor = 0; sensor < ReadingColumns::SensorCount; ++sensor) {
+            const QString name = QString::fromLatin1(SENSOR_COLUMNS[sensor]);
+            day[name + "Min"] = query.value(4 + sensor * 2).toDouble();
+            day[name + "Max"] = query.value(5 + sensor * 2).toDouble();
+        }
+        summaries.append(day);
+    }
+
+    return summaries;
+}
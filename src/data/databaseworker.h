@@ -0,0 +1,119 @@
+#ifndef DATABASEWORKER_H
+#define DATABASEWORKER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QVariantList>
+#include <QVariantMap>
+#include <functional>
+#include <memory>
+#include "sensorreading.h"
+#include "readingcolumns.h"
+
+class QSqlQuery;
+
+// Owns the SQLite connection and performs all database I/O on the thread it
+// lives on. DatabaseManager moves it to a dedicated thread and only ever calls
+// into it through queued invocations.
+class DatabaseWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Polled while long queries run; returning true abandons the query
+    using CancelCheck = std::function<bool()>;
+    // Reports rows done out of total during long-running exports
+    using ProgressCallback = std::function<void(qint64 done, qint64 total)>;
+
+    static constexpr const char* CONNECTION_NAME = "ZephyrSense";
+    // Device filter of the range and latest-reading queries that matches every device
+    static constexpr int ALL_DEVICES = -1;
+
+    explicit DatabaseWorker(const QString &databasePath, QObject *parent = nullptr);
+    ~DatabaseWorker();
+
+    // Everything below must be called on the worker thread
+    bool open();
+    void close();
+
+    void setBatchSize(int size);
+    void setFlushIntervalMs(int ms);
+    void setPragmas(bool walEnabled, bool synchronousNormal);
+
+    void insertReading(const SensorReading &reading);
+    void insertReadings(const QList<SensorReading> &readings);
+    void flush();
+
+    // Readings of deviceId (or ALL_DEVICES) in [startMs, endMs], oldest first
+    ReadingColumns readingColumnsInRange(qint64 startMs, qint64 endMs, int deviceId, const CancelCheck &isCanceled);
+    // Like readingColumnsInRange for a single device, but served from the coarsest
+    // rollup tier that still gives every one of pointBudget / 2 pixel columns its own bucket
+    ReadingColumns chartColumnsInRange(qint64 startMs, qint64 endMs, int pointBudget, int deviceId,
+                                       const CancelCheck &isCanceled);
+    QVariantMap readingById(int id);
+    // Newest reading of deviceId (or ALL_DEVICES) by timestamp, or no rows when there is none
+    ReadingColumns latestReading(int deviceId);
+    QVariantList availableDates();
+    // One map per day with data, newest first: date, count, firstTimestamp,
+    // lastTimestamp and <sensor>Min / <sensor>Max
+    QVariantList daySummaries();
+
+    // Compacted online copy (VACUUM INTO); started(0, expectedBytes) is called
+    // before the copy begins
+    bool exportTo(const QString &destPath, const ProgressCallback &started);
+    // Stream the readings in [startMs, endMs] to a CSV file through a forward-only
+    // cursor, in bounded memory. Returns the number of rows written, or -1 on
+    // failure or cancellation (the partial file is removed).
+    qint64 exportRangeToCsv(qint64 startMs, qint64 endMs, const QString &destPath,
+                            const ProgressCallback &progress, const CancelCheck &isCanceled);
+    bool importFrom(const QString &sourcePath);
+
+    // Rebuild all rollup tiers from the raw readings table
+    bool backfillRollups();
+    // Rebuild only the buckets overlapping [fromMs, toMs]
+    bool backfillRollups(qint64 fromMs, qint64 toMs);
+
+    // Rebuild the day_summary table from the raw readings table
+    bool backfillDaySummary();
+    // Rebuild only the local days overlapping [fromMs, toMs]
+    bool backfillDaySummary(qint64 fromMs, qint64 toMs);
+
+    // Merge the readings of another ZephyrSense database into this one, skipping
+    // rows whose (timestamp, device_id) pair is already present; sources without
+    // a device_id column count as device 0. Runs in chunked transactions over
+    // source id ranges, so sources of any size merge in bounded memory. Returns the number of rows added, or -1 on error.
+    // A canceled merge keeps the chunks committed so far.
+    qint64 mergeFrom(const QString &sourcePath, const ProgressCallback &progress, const CancelCheck &isCanceled);
+
+signals:
+    void databaseError(const QString &message);
+
+private:
+    bool openConnection();
+    void closeConnection();
+    void applyPragmas();
+    void createTables();
+
+    qint64 countReadings(qint64 startMs, qint64 endMs, int deviceId = ALL_DEVICES);
+    ReadingColumns rollupColumnsInRange(int tier, qint64 startMs, qint64 endMs, int deviceId,
+                                        const CancelCheck &isCanceled);
+    bool updateRollups(const QList<SensorReading> &readings);
+    bool rollupsNeedBackfill();
+    bool updateDaySummary(const QList<SensorReading> &readings);
+    bool daySummaryNeedsBackfill();
+
+    QString m_databasePath;
+
+    // Pending readings and the cached prepared INSERT statement
+    QList<SensorReading> m_pendingReadings;
+    std::unique_ptr<QSqlQuery> m_insertQuery;
+    std::unique_ptr<QSqlQuery> m_rollupQueries[3];  // Cached upserts, one per tier
+    std::unique_ptr<QSqlQuery> m_daySummaryQuery;
+    QTimer *m_flushTimer;
+    int m_batchSize = 200;
+    int m_flushIntervalMs = 1000;
+    bool m_walEnabled = true;
+    bool m_synchronousNormal = true;
+};
+
+#endif // DATABASEWORKER_H
@@ -0,0 +1,245 @@
+#include "latestreading.h"
+#include "databasemanager.h"
+
+#include <QDebug>
+
+// Keys of the statistics maps, in ReadingColumns::Sensor order
+static const char *const SENSOR_KEYS[ReadingColumns::SensorCount] = {
+    "partectorNumber", "partectorDiam", "partectorMass", "grimmValue",
+    "temperature", "humidity", "pressure", "altitude", "co2"
+};
+
+LatestReading::LatestReading(QObject *parent)
+    : QObject(parent)
+{
+    m_pollTimer.setInterval(m_updateIntervalMs);
+    connect(&m_pollTimer, &QTimer::timeout, this, &LatestReading::refresh);
+
+    // Trailing edge of the notification throttle
+    m_notifyTimer.setSingleShot(true);
+    connect(&m_notifyTimer, &QTimer::timeout, this, &LatestReading::emitReadingChanged);
+}
+
+void LatestReading::setActive(bool active)
+{
+    if (m_active == active)
+        return;
+
+    m_active = active;
+    if (m_active) {
+        m_pollTimer.start();
+        refresh();
+    } else {
+        m_pollTimer.stop();
+    }
+    emit activeChanged();
+}
+
+void LatestReading::setUpdateIntervalMs(int ms)
+{
+    ms = qMax(50, ms);
+    if (m_updateIntervalMs == ms)
+        return;
+
+    m_updateIntervalMs = ms;
+    m_pollTimer.setInterval(ms);
+    emit updateIntervalMsChanged();
+}
+
+void LatestReading::setWindowSeconds(int seconds)
+{
+    seconds = qMax(1, seconds);
+    if (m_windowSeconds == seconds)
+        return;
+
+    m_windowSeconds = seconds;
+    expireSamples();
+    resetWindows();
+    scheduleNotify();
+    emit windowSecondsChanged();
+}
+
+void LatestReading::setDeviceId(int deviceId)
+{
+    if (m_deviceId == deviceId)
+        return;
+
+    m_deviceId = deviceId;
+
+    // Nothing of the previous device carries over: not its reading, its window or its serial activity
+    m_query.cancel();
+    m_latest.clear();
+    m_live = false;
+    m_samples.clear();
+    resetWindows();
+    m_sinceSerial.invalidate();
+    scheduleNotify();
+    emit deviceIdChanged();
+
+    if (m_active) {
+        refresh();
+    }
+}
+
+QDateTime LatestReading::timestamp() const
+{
+    return m_latest.isEmpty() ? QDateTime() : QDateTime::fromMSecsSinceEpoch(m_latest.timestamps.constFirst());
+}
+
+void LatestReading::addReading(const SensorReading &reading)
+{
+    addReadings(ReadingBatch{ reading });
+}
+
+void LatestReading::addReadings(const ReadingBatch &readings)
+{
+    // Every reading of this device feeds the rolling window; only the last one is shown
+    ReadingColumns rows;
+    rows.reserve(readings.size());
+    for (const SensorReading &reading : readings) {
+        if (reading.deviceId == m_deviceId)
+            rows.append(-1, reading);  // Not stored yet, so no id
+    }
+    if (rows.isEmpty())
+        return;
+
+    m_sinceSerial.start();
+    for (qsizetype row = 0; row + 1 < rows.size(); ++row) {
+        pushSample(rows.timestamps.at(row), valuesAt(rows, row));
+    }
+
+    ReadingColumns last;
+    last.appendRow(rows, rows.size() - 1);
+    setLatest(last, true);
+}
+
+void LatestReading::refresh()
+{
+    // Serial readings are always newer than anything the database can return
+    if (!serialIsQuiet() || m_query.isRunning())
+        return;
+
+    QQmlEngine *engine = qmlEngine(this);
+    auto *dbManager = engine ? engine->singletonInstance<DatabaseManager*>("ZephyrSense", "DatabaseManager") : nullptr;
+    if (!dbManager) {
+        qWarning() << "LatestReading: DatabaseManager singleton not available";
+        return;
+    }
+
+    m_query = dbManager->queryLatestReading(m_deviceId);
+    m_query.then(this, [this](const ReadingColumns &row) {
+        if (row.isEmpty() || !serialIsQuiet() || row.deviceIds.constFirst() != m_deviceId)
+            return;
+        if (!m_latest.isEmpty() && row.timestamps.constFirst() <= m_latest.timestamps.constFirst())
+            return;
+        setLatest(row, false);
+    });
+}
+
+void LatestReading::setLatest(const ReadingColumns &row, bool live)
+{
+    m_latest = row;
+    m_live = live;
+    pushSample(row.timestamps.constFirst(), valuesAt(row, 0));
+    scheduleNotify();
+}
+
+LatestReading::SensorValues LatestReading::valuesAt(const ReadingColumns &columns, qsizetype row)
+{
+    SensorValues values;
+    for (int sensor = 0; sensor < ReadingColumns::SensorCount; ++sensor) {
+        values[sensor] = columns.sensorValue(sensor, row);
+    }
+    return values;
+}
+
+void LatestReading::pushSample(qint64 timestampMs, const SensorValues &values)
+{
+    // The window is ordered by timestamp; a late reading only updates the latest values
+    if (!m_samples.empty() && timestampMs < m_samples.back().timestampMs)
+        return;
+
+    const qint64 seq = m_nextSeq++;
+    m_samples.push_back({ seq, timestampMs, values });
+    for (int sensor = 0; sensor < ReadingColumns::SensorCount; ++sensor) {
+        m_windows[sensor].push(seq, values[sensor]);
+        m_sums[sensor] += values[sensor];
+    }
+    expireSamples();
+}
+
+void LatestReading::expireSamples()
+{
+    if (m_samples.empty())
+        return;
+
+    const qint64 cutoff = m_samples.back().timestampMs - qint64(m_windowSeconds) * 1000;
+    bool expired = false;
+    while (m_samples.front().timestampMs < cutoff) {
+        for (int sensor = 0; sensor < ReadingColumns::SensorCount; ++sensor) {
+            m_sums[sensor] -= m_samples.front().values[sensor];
+        }
+        m_samples.pop_front();
+        expired = true;
+    }
+
+    if (expired) {
+        for (auto &window : m_windows) {
+            window.expireBefore(m_samples.front().seq);
+        }
+    }
+}
+
+void LatestReading::resetWindows()
+{
+    // Exact sums again, without the rounding left behind by expired samples
+    m_sums.fill(0.0);
+    for (auto &window : m_windows) {
+        window.clear();
+    }
+    for (const Sample &sample : m_samples) {
+        for (int sensor = 0; sensor < ReadingColumns::SensorCount; ++sensor) {
+            m_windows[sensor].push(sample.seq, sample.values[sensor]);
+            m_sums[sensor] += sample.values[sensor];
+        }
+    }
+}
+
+void LatestReading::scheduleNotify()
+{
+    if (m_notifyTimer.isActive())
+        return;
+
+    const qint64 elapsed = m_sinceNotify.isValid() ? m_sinceNotify.elapsed() : m_updateIntervalMs;
+    if (elapsed >= m_updateIntervalMs) {
+        emitReadingChanged();
+    } else {
+        m_notifyTimer.start(int(m_updateIntervalMs - elapsed));
+    }
+}
+
+void LatestReading::emitReadingChanged()
+{
+    m_values = m_latest.isEmpty() ? QVariantMap() : m_latest.toVariantMap(0);
+
+    m_minimums.clear();
+    m_maximums.clear();
+    m_means.clear();
+    if (!m_samples.empty()) {
+        const double count = double(m_samples.size());
+        for (int sensor = 0; sensor < ReadingColumns::SensorCount; ++sensor) {
+            const QString key = QString::fromLatin1(SENSOR_KEYS[sensor]);
+            m_minimums[key] = m_windows[sensor].min();
+            m_maximums[key] = m_windows[sensor].max();
+            m_means[key] = m_sums[sensor] / count;
+        }
+    }
+
+    m_sinceNotify.start();
+    emit readingChanged();
+}
+
+bool LatestReading::serialIsQuiet() const
+{
+    return !m_sinceSerial.isValid() || m_sinceSerial.elapsed() > 2 * qint64(m_updateIntervalMs);
+}
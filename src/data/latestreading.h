@@ -0,0 +1,128 @@
+#ifndef LATESTREADING_H
+#define LATESTREADING_H
+
+#include <QObject>
+#include <QQmlEngine>
+#include <QDateTime>
+#include <QVariantMap>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QFuture>
+#include <array>
+#include <deque>
+#include "sensorreading.h"
+#include "readingcolumns.h"
+#include "slidingminmax.h"
+#include "readingbus.h"
+
+// The most recent reading of one device plus min/max/mean of every sensor over
+// the last windowSeconds. Fed by the ReadingBus; while active and no live reading has
+// arrived for two update intervals, it polls the database for its newest row
+// instead. Change notifications are throttled to one per updateIntervalMs.
+class LatestReading : public QObject
+{
+    Q_OBJECT
+    QML_ELEMENT
+    QML_SINGLETON
+
+    // Poll the database while the serial port is quiet
+    Q_PROPERTY(bool active READ isActive WRITE setActive NOTIFY activeChanged)
+    // Minimum time between readingChanged signals, and the database poll period
+    Q_PROPERTY(int updateIntervalMs READ updateIntervalMs WRITE setUpdateIntervalMs NOTIFY updateIntervalMsChanged)
+    // Span of the rolling statistics, by reading timestamp
+    Q_PROPERTY(int windowSeconds READ windowSeconds WRITE setWindowSeconds NOTIFY windowSecondsChanged)
+    // Readings of other devices are ignored; changing it starts over
+    Q_PROPERTY(int deviceId READ deviceId WRITE setDeviceId NOTIFY deviceIdChanged)
+
+    Q_PROPERTY(bool hasReading READ hasReading NOTIFY readingChanged)
+    // True when the current reading came from the serial port rather than the database
+    Q_PROPERTY(bool live READ isLive NOTIFY readingChanged)
+    Q_PROPERTY(QDateTime timestamp READ timestamp NOTIFY readingChanged)
+    // Same keys as DatabaseManager.getReadingById
+    Q_PROPERTY(QVariantMap values READ values NOTIFY readingChanged)
+    // Rolling statistics keyed by sensor name
+    Q_PROPERTY(QVariantMap minimums READ minimums NOTIFY readingChanged)
+    Q_PROPERTY(QVariantMap maximums READ maximums NOTIFY readingChanged)
+    Q_PROPERTY(QVariantMap means READ means NOTIFY readingChanged)
+    Q_PROPERTY(int sampleCount READ sampleCount NOTIFY readingChanged)
+
+public:
+    explicit LatestReading(QObject *parent = nullptr);
+
+    bool isActive() const { return m_active; }
+    void setActive(bool active);
+    int updateIntervalMs() const { return m_updateIntervalMs; }
+    void setUpdateIntervalMs(int ms);
+    int windowSeconds() const { return m_windowSeconds; }
+    void setWindowSeconds(int seconds);
+    int deviceId() const { return m_deviceId; }
+    void setDeviceId(int deviceId);
+
+    bool hasReading() const { return !m_latest.isEmpty(); }
+    bool isLive() const { return m_live; }
+    QDateTime timestamp() const;
+    QVariantMap values() const { return m_values; }
+    QVariantMap minimums() const { return m_minimums; }
+    QVariantMap maximums() const { return m_maximums; }
+    QVariantMap means() const { return m_means; }
+    int sampleCount() const { return int(m_samples.size()); }
+
+    // Fetch the newest stored reading now, unless serial data is flowing
+    Q_INVOKABLE void refresh();
+
+public slots:
+    void addReading(const SensorReading &reading);
+    void addReadings(const ReadingBatch &readings);
+
+signals:
+    void activeChanged();
+    void updateIntervalMsChanged();
+    void windowSecondsChanged();
+    void deviceIdChanged();
+    void readingChanged();
+
+private:
+    using SensorValues = std::array<double, ReadingColumns::SensorCount>;
+
+    struct Sample {
+        qint64 seq;
+        qint64 timestampMs;
+        SensorValues values;
+    };
+
+    static SensorValues valuesAt(const ReadingColumns &columns, qsizetype row);
+    void setLatest(const ReadingColumns &row, bool live);
+    void pushSample(qint64 timestampMs, const SensorValues &values);
+    void expireSamples();
+    void resetWindows();
+    void scheduleNotify();
+    void emitReadingChanged();
+    bool serialIsQuiet() const;
+
+    ReadingColumns m_latest;  // Zero or one row
+    bool m_live = false;
+
+    std::deque<Sample> m_samples;
+    std::array<SlidingMinMax<double>, ReadingColumns::SensorCount> m_windows;
+    SensorValues m_sums{};
+    qint64 m_nextSeq = 0;
+
+    // Published snapshots, rebuilt once per notification
+    QVariantMap m_values;
+    QVariantMap m_minimums;
+    QVariantMap m_maximums;
+    QVariantMap m_means;
+
+    QTimer m_pollTimer;
+    QTimer m_notifyTimer;
+    QElapsedTimer m_sinceNotify;
+    QElapsedTimer m_sinceSerial;
+    QFuture<ReadingColumns> m_query;
+
+    bool m_active = false;
+    int m_updateIntervalMs = 1000;
+    int m_windowSeconds = 60;
+    int m_deviceId = 0;
+};
+
+#endif // LATESTREADING_H
@@ -0,0 +1,547 @@
+#include "tracklayer.h"
+#include <QSGGeometryNode>
+#include <QSGTransformNode>
+#include <QSGFlatColorMaterial>
+#include <QSGVertexColorMaterial>
+#include <QMouseEvent>
+#include <cmath>
+#include <cstring>
+
+// Track vertices are pre-projected at this zoom. Float precision stays well
+// below a pixel for tracks up to a few hundred kilometres across.
+static constexpr double REFERENCE_ZOOM = 16.0;
+static constexpr double TILE_SIZE = 256.0;
+
+// Segments per line node: appending rewrites at most this many vertices
+static constexpr qint64 TrackChunkSize = 4096;
+
+// Same palette as SensorMarker: normal, warning, danger
+static const QColor HAZARD_COLORS[] = { QColor("#4CAF50"), QColor("#FFC107"), QColor("#F44336") };
+
+TrackLayer::TrackLayer(QQuickItem *parent)
+    : QQuickItem(parent)
+{
+    setFlag(ItemHasContents, true);
+    setAcceptedMouseButtons(Qt::LeftButton);
+}
+
+void TrackLayer::setSourceModel(SensorReadingModel *model)
+{
+    if (m_source == model)
+        return;
+
+    if (m_source) {
+        disconnect(m_source, nullptr, this, nullptr);
+    }
+
+    m_source = model;
+
+    if (m_source) {
+        connect(m_source, &QAbstractItemModel::modelReset, this, &TrackLayer::rebuildIndex);
+        connect(m_source, &QAbstractItemModel::rowsInserted, this, &TrackLayer::onRowsInserted);
+        connect(m_source, &QAbstractItemModel::rowsRemoved, this, &TrackLayer::onRowsRemoved);
+        connect(m_source, &QAbstractItemModel::rowsAboutToBeRemoved, this, &TrackLayer::onRowsAboutToBeRemoved);
+        // Only hazard levels change in place, and only the sprites show them
+        connect(m_source, &QAbstractItemModel::dataChanged, this, &TrackLayer::markPointsRebin);
+    }
+
+    rebuildIndex();
+    emit sourceModelChanged();
+}
+
+void TrackLayer::setCenterLatitude(double latitude)
+{
+    if (m_centerLatitude != latitude) {
+        m_centerLatitude = latitude;
+        emit viewChanged();
+        markPointsRebin();
+    }
+}
+
+void TrackLayer::setCenterLongitude(double longitude)
+{
+    if (m_centerLongitude != longitude) {
+        m_centerLongitude = longitude;
+        emit viewChanged();
+        markPointsRebin();
+    }
+}
+
+void TrackLayer::setZoomLevel(double zoom)
+{
+    if (m_zoomLevel != zoom) {
+        m_zoomLevel = zoom;
+        emit viewChanged();
+        markPointsRebin();
+    }
+}
+
+void TrackLayer::setLineColor(const QColor &color)
+{
+    if (m_lineColor != color) {
+        m_lineColor = color;
+        emit lineColorChanged();
+        m_lineColorDirty = true;
+        update();
+    }
+}
+
+void TrackLayer::setPointSize(int size)
+{
+    size = qMax(1, size);
+    if (m_pointSize != size) {
+        m_pointSize = size;
+        emit pointSizeChanged();
+        markPointsRebin();
+    }
+}
+
+void TrackLayer::setHitRadius(int radius)
+{
+    radius = qMax(1, radius);
+    if (m_hitRadius != radius) {
+        m_hitRadius = radius;
+        emit hitRadiusChanged();
+    }
+}
+
+void TrackLayer::rebuildIndex()
+{
+    m_index.clear();
+    m_removedRows = 0;
+    m_purgedBelow = 0;
+    if (m_source && m_source->count() > 0) {
+        indexRows(0, m_source->count() - 1);
+    }
+    markTrackReset();
+}
+
+void TrackLayer::indexRows(int first, int last)
+{
+    for (int row = first; row <= last; ++row) {
+        m_index.insert(m_removedRows + row, m_source->latitudeAt(row), m_source->longitudeAt(row));
+    }
+}
+
+void TrackLayer::onRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid())
+        return;
+
+    // The source only ever appends
+    if (first != m_source->count() - (last - first + 1)) {
+        rebuildIndex();
+        return;
+    }
+    indexRows(first, last);
+
+    // New vertices are written from m_trackDirtyFrom on the next frame
+    if (!m_pointsRebin) {
+        binRows(first, last, 1);
+    }
+    markPointsDirty();
+}
+
+void TrackLayer::onRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last)
+{
+    // The rows are still readable here; take them out of the sprite cells
+    if (!parent.isValid() && first == 0 && !m_pointsRebin) {
+        binRows(first, last, -1);
+    }
+}
+
+void TrackLayer::onRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid())
+        return;
+
+    // Pruning removes from the head: shifting the key base drops those rows at once
+    if (first != 0) {
+        rebuildIndex();
+        return;
+    }
+    m_removedRows += last - first + 1;
+
+    // Physically drop stale keys once they make up half of the index
+    if ((m_removedRows - m_purgedBelow) * 2 > m_index.size()) {
+        m_index.removeBelow(m_removedRows);
+        m_purgedBelow = m_removedRows;
+    }
+    m_trackHeadPruned = true;
+    markPointsDirty();
+}
+
+void TrackLayer::markTrackReset()
+{
+    m_trackRebuild = true;
+    markPointsRebin();
+}
+
+void TrackLayer::markPointsDirty()
+{
+    m_pointsDirty = true;
+    update();
+}
+
+void TrackLayer::markPointsRebin()
+{
+    m_pointsRebin = true;
+    markPointsDirty();
+}
+
+void TrackLayer::geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry)
+{
+    QQuickItem::geometryChange(newGeometry, oldGeometry);
+    if (newGeometry.size() != oldGeometry.size()) {
+        markPointsRebin();
+    }
+}
+
+double TrackLayer::worldSize() const
+{
+    return TILE_SIZE * std::pow(2.0, m_zoomLevel);
+}
+
+QPointF TrackLayer::toItem(double mercatorX, double mercatorY) const
+{
+    const double scale = worldSize();
+    return QPointF((mercatorX - GeoGridIndex::mercatorX(m_centerLongitude)) * scale + width() / 2.0,
+                   (mercatorY - GeoGridIndex::mercatorY(m_centerLatitude)) * scale + height() / 2.0);
+}
+
+qint64 TrackLayer::readingIdAt(qreal x, qreal y) const
+{
+    if (!m_source || m_source->count() == 0)
+        return -1;
+
+    // Search box of hitRadius pixels around the position
+    const double scale = worldSize();
+    const double mx = GeoGridIndex::mercatorX(m_centerLongitude) + (x - width() / 2.0) / scale;
+    const double my = GeoGridIndex::mercatorY(m_centerLatitude) + (y - height() / 2.0) / scale;
+    const double radius = m_hitRadius / scale;
+
+    const int rows = m_source->count();
+    double bestDistance = double(m_hitRadius) * m_hitRadius;
+    int bestRow = -1;
+
+    m_index.query(GeoGridIndex::latitudeFromY(my - radius), GeoGridIndex::longitudeFromX(mx - radius),
+                  GeoGridIndex::latitudeFromY(my + radius), GeoGridIndex::longitudeFromX(mx + radius),
+                  [&](qint64 key) {
+        const qint64 row = key - m_removedRows;
+        if (row < 0 || row >= rows)
+            return;
+
+        const QPointF p = toItem(GeoGridIndex::mercatorX(m_source->longitudeAt(int(row))),
+                                 GeoGridIndex::mercatorY(m_source->latitudeAt(int(row))));
+        const double dx = p.x() - x;
+        const double dy = p.y() - y;
+        const double distance = dx * dx + dy * dy;
+        // Ties go to the newest reading, which is drawn on top
+        if (distance <= bestDistance) {
+            bestDistance = distance;
+            bestRow = int(row);
+        }
+    });
+
+    return bestRow >= 0 ? m_source->readingIdAt(bestRow) : -1;
+}
+
+void TrackLayer::mousePressEvent(QMouseEvent *event)
+{
+    const qint64 id = readingIdAt(event->position().x(), event->position().y());
+    if (id < 0) {
+        // Let the map underneath pan
+        event->ignore();
+        return;
+    }
+    event->accept();
+    emit readingClicked(id);
+}
+
+QSGNode *TrackLayer::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *)
+{
+    // root -> transform -> line strip chunks (world coordinates)
+    //      -> point sprites (item coordinates)
+    QSGNode *root = oldNode;
+    QSGTransformNode *transformNode;
+    QSGGeometryNode *pointNode;
+
+    if (!root) {
+        root = new QSGNode;
+
+        transformNode = new QSGTransformNode;
+        root->appendChildNode(transformNode);
+
+        pointNode = new QSGGeometryNode;
+        auto *pointGeometry = new QSGGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), 0);
+        pointGeometry->setDrawingMode(QSGGeometry::DrawTriangles);
+        pointNode->setGeometry(pointGeometry);
+        pointNode->setMaterial(new QSGVertexColorMaterial);
+        pointNode->setFlags(QSGNode::OwnsGeometry | QSGNode::OwnsMaterial);
+        root->appendChildNode(pointNode);
+
+        m_trackRebuild = true;
+        m_pointsDirty = true;
+    } else {
+        transformNode = static_cast<QSGTransformNode *>(root->firstChild());
+        pointNode = static_cast<QSGGeometryNode *>(transformNode->nextSibling());
+    }
+
+    updateTrack(transformNode);
+    updateTransform(transformNode);
+
+    if (m_pointsDirty) {
+        if (m_pointsRebin) {
+            rebinPoints();
+        }
+        updatePointGeometry(pointNode);
+        m_pointsDirty = false;
+    }
+
+    return root;
+}
+
+static QSGGeometry *createLineGeometry(int vertexCount)
+{
+    auto *geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), vertexCount);
+    geometry->setDrawingMode(QSGGeometry::DrawLineStrip);
+    geometry->setLineWidth(2);
+    return geometry;
+}
+
+QSGGeometryNode *TrackLayer::createChunkNode() const
+{
+    auto *node = new QSGGeometryNode;
+    node->setGeometry(createLineGeometry(0));
+    auto *material = new QSGFlatColorMaterial;
+    material->setColor(m_lineColor);
+    node->setMaterial(material);
+    node->setFlags(QSGNode::OwnsGeometry | QSGNode::OwnsMaterial);
+    return node;
+}
+
+void TrackLayer::updateTrack(QSGTransformNode *node)
+{
+    const int rows = m_source ? m_source->count() : 0;
+    const qint64 firstKey = m_removedRows;
+    const qint64 endKey = m_removedRows + rows;
+
+    if (m_trackRebuild) {
+        while (QSGNode *child = node->firstChild()) {
+            node->removeChildNode(child);
+            delete child;
+        }
+        m_chunkBase = firstKey;
+        m_trackDirtyFrom = firstKey;
+        m_drawnFrom = firstKey;
+        if (rows > 0) {
+            m_anchorX = GeoGridIndex::mercatorX(m_source->longitudeAt(0));
+            m_anchorY = GeoGridIndex::mercatorY(m_source->latitudeAt(0));
+        }
+        m_trackRebuild = false;
+        m_trackHeadPruned = false;
+    }
+
+    // Chunks whose every segment was pruned go away; a partly pruned first
+    // chunk is rewritten from the new head
+    if (m_trackHeadPruned) {
+        while (node->firstChild() && m_chunkBase + TrackChunkSize <= firstKey) {
+            QSGNode *child = node->firstChild();
+            node->removeChildNode(child);
+            delete child;
+            m_chunkBase += TrackChunkSize;
+        }
+        if (!node->firstChild()) {
+            m_chunkBase = firstKey;
+            m_trackDirtyFrom = firstKey;
+        } else {
+            fillChunk(static_cast<QSGGeometryNode *>(node->firstChild()), m_chunkBase);
+        }
+        m_drawnFrom = firstKey;
+        m_trackHeadPruned = false;
+    }
+
+    if (m_lineColorDirty) {
+        for (QSGNode *child = node->firstChild(); child; child = child->nextSibling()) {
+            auto *chunk = static_cast<QSGGeometryNode *>(child);
+            static_cast<QSGFlatColorMaterial *>(chunk->material())->setColor(m_lineColor);
+            chunk->markDirty(QSGNode::DirtyMaterial);
+        }
+        m_lineColorDirty = false;
+    }
+
+    if (m_trackDirtyFrom >= endKey)
+        return;
+
+    // Chunks needed for keys m_chunkBase .. endKey - 1; a single vertex has no segment
+    const qint64 span = endKey - 1 - m_chunkBase;
+    const int chunks = span > 0 ? int((span + TrackChunkSize - 1) / TrackChunkSize) : 0;
+    while (node->childCount() < chunks) {
+        node->appendChildNode(createChunkNode());
+    }
+
+    // The first dirty vertex may also be the last vertex of the chunk before
+    const qint64 dirty = qMax<qint64>(0, m_trackDirtyFrom - m_chunkBase);
+    int chunk = dirty == 0 ? 0 : int((dirty - 1) / TrackChunkSize);
+    QSGNode *child = node->firstChild();
+    for (int i = 0; i < chunk && child; ++i) {
+        child = child->nextSibling();
+    }
+    for (; child; child = child->nextSibling(), ++chunk) {
+        fillChunk(static_cast<QSGGeometryNode *>(child), m_chunkBase + qint64(chunk) * TrackChunkSize);
+    }
+
+    m_trackDirtyFrom = endKey;
+    m_drawnFrom = firstKey;
+}
+
+void TrackLayer::fillChunk(QSGGeometryNode *node, qint64 chunkStart) const
+{
+    // Keys chunkStart .. chunkStart + TrackChunkSize, clipped to the live rows
+    const qint64 first = qMax(chunkStart, m_removedRows);
+    const qint64 last = qMin(chunkStart + TrackChunkSize, m_removedRows + m_source->count() - 1);
+    const int count = last > first ? int(last - first + 1) : 0;
+
+    // The current geometry starts at the first key drawn last time; the part
+    // still live is copied and only the rest is projected
+    const QSGGeometry *old = node->geometry();
+    const qint64 oldFirst = qMax(chunkStart, m_drawnFrom);
+    const qint64 keepFrom = qMax(first, oldFirst);
+    const qint64 keepTo = qMin(last + 1, oldFirst + old->vertexCount());
+
+    QSGGeometry *geometry = createLineGeometry(count);
+    QSGGeometry::Point2D *vertices = geometry->vertexDataAsPoint2D();
+    const double scale = TILE_SIZE * std::pow(2.0, REFERENCE_ZOOM);
+    auto project = [&](qint64 from, qint64 to) {
+        for (qint64 key = from; key < to; ++key) {
+            const int row = int(key - m_removedRows);
+            const double x = GeoGridIndex::mercatorX(m_source->longitudeAt(row));
+            const double y = GeoGridIndex::mercatorY(m_source->latitudeAt(row));
+            vertices[key - first].set(float((x - m_anchorX) * scale), float((y - m_anchorY) * scale));
+        }
+    };
+
+    if (count > 0 && keepTo > keepFrom) {
+        std::memcpy(vertices + (keepFrom - first), old->vertexDataAsPoint2D() + (keepFrom - oldFirst),
+                    size_t(keepTo - keepFrom) * sizeof(QSGGeometry::Point2D));
+        project(first, keepFrom);
+        project(keepTo, last + 1);
+    } else if (count > 0) {
+        project(first, last + 1);
+    }
+
+    node->setGeometry(geometry);
+    node->markDirty(QSGNode::DirtyGeometry);
+}
+
+void TrackLayer::updateTransform(QSGTransformNode *node) const
+{
+    // Reference-zoom world coordinates -> item coordinates at the current view
+    const QPointF anchor = toItem(m_anchorX, m_anchorY);
+    const double scale = std::pow(2.0, m_zoomLevel - REFERENCE_ZOOM);
+
+    QMatrix4x4 matrix;
+    matrix.translate(float(anchor.x()), float(anchor.y()));
+    matrix.scale(float(scale), float(scale));
+    if (node->matrix() != matrix) {
+        node->setMatrix(matrix);
+        node->markDirty(QSGNode::DirtyMatrix);
+    }
+}
+
+void TrackLayer::rebinPoints()
+{
+    m_pointsRebin = false;
+
+    // Sprites overlapping by more than half are indistinguishable, so visible
+    // readings are binned into half-sprite cells and drawn with the highest
+    // hazard present. This bounds the vertex count by the screen size rather
+    // than the data.
+    const int w = qMax(0, int(width()));
+    const int h = qMax(0, int(height()));
+    m_cellSize = qMax(1, m_pointSize / 2);
+    m_cellColumns = (w + m_cellSize - 1) / m_cellSize;
+    m_cellRows = (h + m_cellSize - 1) / m_cellSize;
+    m_cellCounts.fill(0, qsizetype(m_cellColumns) * m_cellRows * 3);
+
+    if (!m_source || m_source->count() == 0 || w <= 0 || h <= 0)
+        return;
+
+    const double scale = worldSize();
+    const double centerX = GeoGridIndex::mercatorX(m_centerLongitude);
+    const double centerY = GeoGridIndex::mercatorY(m_centerLatitude);
+    const double halfWidth = w / 2.0 / scale;
+    const double halfHeight = h / 2.0 / scale;
+    const int rows = m_source->count();
+
+    m_index.query(GeoGridIndex::latitudeFromY(qMax(0.0, centerY - halfHeight)),
+                  GeoGridIndex::longitudeFromX(qMax(0.0, centerX - halfWidth)),
+                  GeoGridIndex::latitudeFromY(qMin(1.0, centerY + halfHeight)),
+                  GeoGridIndex::longitudeFromX(qMin(1.0, centerX + halfWidth)),
+                  [&](qint64 key) {
+        const qint64 row = key - m_removedRows;
+        if (row >= 0 && row < rows)
+            binRows(int(row), int(row), 1);
+    });
+}
+
+void TrackLayer::binRows(int first, int last, int delta)
+{
+    const int w = m_cellColumns * m_cellSize;
+    const int h = m_cellRows * m_cellSize;
+
+    for (int row = first; row <= last; ++row) {
+        const QPointF p = toItem(GeoGridIndex::mercatorX(m_source->longitudeAt(row)),
+                                 GeoGridIndex::mercatorY(m_source->latitudeAt(row)));
+        if (p.x() < 0 || p.y() < 0 || p.x() >= w || p.y() >= h)
+            continue;
+
+        const qsizetype cell = qsizetype(int(p.y()) / m_cellSize) * m_cellColumns + int(p.x()) / m_cellSize;
+        quint32 &count = m_cellCounts[cell * 3 + qBound(0, m_source->hazardLevelAt(row), 2)];
+        if (delta > 0) {
+            ++count;
+        } else if (count > 0) {
+            --count;
+        }
+    }
+}
+
+void TrackLayer::updatePointGeometry(QSGGeometryNode *node)
+{
+    QSGGeometry *geometry = node->geometry();
+
+    int occupied = 0;
+    for (qsizetype i = 0; i < m_cellCounts.size(); i += 3) {
+        if (m_cellCounts.at(i) | m_cellCounts.at(i + 1) | m_cellCounts.at(i + 2))
+            ++occupied;
+    }
+
+    geometry->allocate(occupied * 6);
+    QSGGeometry::ColoredPoint2D *vertices = geometry->vertexDataAsColoredPoint2D();
+    const float half = m_pointSize / 2.0f;
+
+    for (qsizetype cell = 0; cell * 3 < m_cellCounts.size(); ++cell) {
+        const quint32 *counts = m_cellCounts.constData() + cell * 3;
+        const int level = counts[2] ? 2 : counts[1] ? 1 : counts[0] ? 0 : -1;
+        if (level < 0)
+            continue;
+
+        const float cx = (cell % m_cellColumns) * m_cellSize + m_cellSize / 2.0f;
+        const float cy = (cell / m_cellColumns) * m_cellSize + m_cellSize / 2.0f;
+        const QColor &color = HAZARD_COLORS[level];
+        const uchar r = uchar(color.red());
+        const uchar g = uchar(color.green());
+        const uchar b = uchar(color.blue());
+
+        // Two triangles per sprite
+        vertices[0].set(cx - half, cy - half, r, g, b, 255);
+        vertices[1].set(cx + half, cy - half, r, g, b, 255);
+        vertices[2].set(cx - half, cy + half, r, g, b, 255);
+        vertices[3].set(cx + half, cy - half, r, g, b, 255);
+        vertices[4].set(cx + half, cy + half, r, g, b, 255);
+        vertices[5].set(cx - half, cy + half, r, g, b, 255);
+        vertices += 6;
+    }
+
+    node->markDirty(QSGNode::DirtyGeometry);
+}
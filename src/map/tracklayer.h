@@ -0,0 +1,130 @@
+#ifndef TRACKLAYER_H
+#define TRACKLAYER_H
+
+#include <QQuickItem>
+#include <QQmlEngine>
+#include <QPointer>
+#include <QColor>
+#include "geogridindex.h"
+#include "sensorreadingmodel.h"
+
+class QSGGeometryNode;
+class QSGTransformNode;
+class QSGNode;
+
+// Draws every reading of a SensorReadingModel as one polyline plus
+// hazard-colored point sprites, using a few scene graph geometry nodes instead
+// of one QML item per reading. Overlay it on a Map and bind the map's center
+// and zoom level; panning and zooming only update a transform (line) and the
+// sprites of the visible area. Live batches and pruning only touch the
+// readings they add or remove. Clicks are resolved through a grid index.
+class TrackLayer : public QQuickItem
+{
+    Q_OBJECT
+    QML_ELEMENT
+
+    Q_PROPERTY(SensorReadingModel *sourceModel READ sourceModel WRITE setSourceModel NOTIFY sourceModelChanged)
+    Q_PROPERTY(double centerLatitude READ centerLatitude WRITE setCenterLatitude NOTIFY viewChanged)
+    Q_PROPERTY(double centerLongitude READ centerLongitude WRITE setCenterLongitude NOTIFY viewChanged)
+    Q_PROPERTY(double zoomLevel READ zoomLevel WRITE setZoomLevel NOTIFY viewChanged)
+    Q_PROPERTY(QColor lineColor READ lineColor WRITE setLineColor NOTIFY lineColorChanged)
+    Q_PROPERTY(int pointSize READ pointSize WRITE setPointSize NOTIFY pointSizeChanged)
+    // Maximum click distance in pixels for hit-testing
+    Q_PROPERTY(int hitRadius READ hitRadius WRITE setHitRadius NOTIFY hitRadiusChanged)
+
+public:
+    explicit TrackLayer(QQuickItem *parent = nullptr);
+
+    SensorReadingModel *sourceModel() const { return m_source; }
+    void setSourceModel(SensorReadingModel *model);
+    double centerLatitude() const { return m_centerLatitude; }
+    void setCenterLatitude(double latitude);
+    double centerLongitude() const { return m_centerLongitude; }
+    void setCenterLongitude(double longitude);
+    double zoomLevel() const { return m_zoomLevel; }
+    void setZoomLevel(double zoom);
+    QColor lineColor() const { return m_lineColor; }
+    void setLineColor(const QColor &color);
+    int pointSize() const { return m_pointSize; }
+    void setPointSize(int size);
+    int hitRadius() const { return m_hitRadius; }
+    void setHitRadius(int radius);
+
+    // Reading id nearest to an item position within hitRadius, or -1
+    Q_INVOKABLE qint64 readingIdAt(qreal x, qreal y) const;
+
+signals:
+    void sourceModelChanged();
+    void viewChanged();
+    void lineColorChanged();
+    void pointSizeChanged();
+    void hitRadiusChanged();
+    void readingClicked(qint64 readingId);
+
+protected:
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
+    void geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry) override;
+    void mousePressEvent(QMouseEvent *event) override;
+
+private:
+    void rebuildIndex();
+    void indexRows(int first, int last);
+    void onRowsInserted(const QModelIndex &parent, int first, int last);
+    void onRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+    void onRowsRemoved(const QModelIndex &parent, int first, int last);
+    void markTrackReset();
+    void markPointsDirty();
+    void markPointsRebin();
+
+    void updateTrack(QSGTransformNode *node);
+    void fillChunk(QSGGeometryNode *node, qint64 chunkStart) const;
+    QSGGeometryNode *createChunkNode() const;
+    void updateTransform(QSGTransformNode *node) const;
+
+    // Sprite cells count the visible readings per hazard level, so single
+    // readings can be added and removed without rebinning the viewport
+    void rebinPoints();
+    void binRows(int first, int last, int delta);
+    void updatePointGeometry(QSGGeometryNode *node);
+
+    // Normalized Mercator units -> item pixels at the current zoom
+    double worldSize() const;
+    QPointF toItem(double mercatorX, double mercatorY) const;
+
+    QPointer<SensorReadingModel> m_source;
+    GeoGridIndex m_index;
+    qint64 m_removedRows = 0;  // Index keys are m_removedRows + source row
+    qint64 m_purgedBelow = 0;
+
+    // Track vertices are stored relative to this anchor at a fixed reference zoom,
+    // so pan and zoom are a matrix change rather than a geometry rebuild
+    double m_anchorX = 0.0;
+    double m_anchorY = 0.0;
+
+    double m_centerLatitude = 0.0;
+    double m_centerLongitude = 0.0;
+    double m_zoomLevel = 0.0;
+    QColor m_lineColor = QColor("#3f589e");
+    int m_pointSize = 8;
+    int m_hitRadius = 10;
+
+    // The line is split into nodes of TrackChunkSize segments, chunk i covering
+    // keys m_chunkBase + i * TrackChunkSize up to and including the next
+    // chunk's first vertex. Appending rewrites only the last chunk, pruning
+    // only the first, and vertices already projected are copied over.
+    qint64 m_chunkBase = 0;
+    qint64 m_trackDirtyFrom = 0;  // Keys from here have no vertices yet
+    qint64 m_drawnFrom = 0;       // First key when the chunks were last written
+    bool m_trackRebuild = true;
+    bool m_trackHeadPruned = false;
+    bool m_lineColorDirty = true;
+
+    QList<quint32> m_cellCounts;  // Three levels per cell, row-major
+    int m_cellColumns = 0;
+    int m_cellRows = 0;
+    int m_cellSize = 1;
+    bool m_pointsRebin = true;
+    bool m_pointsDirty = true;
+};
+
+#endif // TRACKLAYER_H
@@ -0,0 +1,68 @@
+#ifndef DECIMATION_H
+#define DECIMATION_H
+
+#include <QList>
+#include <QtGlobal>
+#include <utility>
+
+// Reduce a time series to at most `budget` points by splitting the time span
+// into budget/2 equal buckets (roughly one per pixel column) and keeping the
+// minimum and maximum of each, in time order, plus the first and last point.
+// Unlike plain LTTB, every spike and dip is guaranteed to survive.
+//
+// timestamps must be ascending and the same length as values. Returns the
+// indices of the kept rows, ascending.
+template <typename Value>
+QList<qsizetype> decimateMinMax(const QList<qint64> &timestamps, const QList<Value> &values, qsizetype budget)
+{
+    const qsizetype count = timestamps.size();
+    QList<qsizetype> kept;
+
+    if (count <= budget || budget < 4) {
+        kept.reserve(count);
+        for (qsizetype i = 0; i < count; ++i)
+            kept.append(i);
+        return kept;
+    }
+
+    const qint64 first = timestamps.first();
+    const qint64 span = qMax<qint64>(1, timestamps.last() - first);
+    const qint64 buckets = (budget - 2) / 2;
+
+    kept.reserve(budget);
+    kept.append(0);
+
+    qint64 bucket = -1;
+    qsizetype minIndex = 0;
+    qsizetype maxIndex = 0;
+
+    auto flushBucket = [&]() {
+        if (bucket < 0)
+            return;
+        std::pair<qsizetype, qsizetype> pair = minIndex < maxIndex
+            ? std::pair(minIndex, maxIndex) : std::pair(maxIndex, minIndex);
+        if (pair.first != kept.last())
+            kept.append(pair.first);
+        if (pair.second != kept.last())
+            kept.append(pair.second);
+    };
+
+    for (qsizetype i = 1; i < count - 1; ++i) {
+        // Widen before multiplying: spans are epoch milliseconds
+        const qint64 b = qMin<qint64>(buckets - 1, (timestamps.at(i) - first) * buckets / span);
+        if (b != bucket) {
+            flushBucket();
+            bucket = b;
+            minIndex = maxIndex = i;
+        } else {
+            if (values.at(i) < values.at(minIndex)) minIndex = i;
+            if (values.at(i) > values.at(maxIndex)) maxIndex = i;
+        }
+    }
+    flushBucket();
+
+    kept.append(count - 1);
+    return kept;
+}
+
+#endif // DECIMATION_H
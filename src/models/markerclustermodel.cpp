@@ -0,0 +1,337 @@
+#include "markerclustermodel.h"
+#include <QHash>
+#include <algorithm>
+#include <cmath>
+
+MarkerClusterModel::MarkerClusterModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+    // Coalesce bursts of source changes and viewport moves into one pass
+    m_refreshTimer.setSingleShot(true);
+    m_refreshTimer.setInterval(50);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &MarkerClusterModel::refreshClusters);
+}
+
+int MarkerClusterModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_clusters.count();
+}
+
+QVariant MarkerClusterModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_clusters.count())
+        return QVariant();
+
+    const Cluster &cluster = m_clusters.at(index.row());
+    const int row = latestRow(cluster);
+
+    switch (role) {
+    case LatitudeRole:
+        return cluster.latitude;
+    case LongitudeRole:
+        return cluster.longitude;
+    case CountRole:
+        return cluster.count;
+    case HazardLevelRole:
+        return cluster.maxHazard;
+    case ReadingIdRole:
+        return row >= 0 ? m_source->readingIdAt(row) : -1;
+    case TooltipTextRole: {
+        if (!m_source)
+            return QString();
+        if (cluster.count == 1)
+            return row >= 0 ? m_source->data(m_source->index(row), SensorReadingModel::TooltipTextRole) : QVariant();
+
+        static const char *const levelNames[] = { "Normal", "Warning", "Danger" };
+        return QString("%1 readings\nHighest hazard: %2\n\nClick to zoom in")
+            .arg(cluster.count)
+            .arg(levelNames[qBound(0, cluster.maxHazard, 2)]);
+    }
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> MarkerClusterModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[LatitudeRole] = "latitude";
+    roles[LongitudeRole] = "longitude";
+    roles[CountRole] = "clusterCount";
+    roles[HazardLevelRole] = "hazardLevel";
+    roles[ReadingIdRole] = "readingId";
+    roles[TooltipTextRole] = "tooltipText";
+    return roles;
+}
+
+void MarkerClusterModel::setSourceModel(SensorReadingModel *model)
+{
+    if (m_source == model)
+        return;
+
+    if (m_source) {
+        disconnect(m_source, nullptr, this, nullptr);
+    }
+
+    m_source = model;
+
+    if (m_source) {
+        connect(m_source, &QAbstractItemModel::modelReset, this, &MarkerClusterModel::rebuildIndex);
+        connect(m_source, &QAbstractItemModel::rowsInserted, this, &MarkerClusterModel::onRowsInserted);
+        connect(m_source, &QAbstractItemModel::rowsRemoved, this, &MarkerClusterModel::onRowsRemoved);
+        connect(m_source, &QAbstractItemModel::dataChanged, this, &MarkerClusterModel::onDataChanged);
+    }
+
+    rebuildIndex();
+    emit sourceModelChanged();
+}
+
+void MarkerClusterModel::setClusterRadius(int radius)
+{
+    radius = qMax(1, radius);
+    if (m_clusterRadius != radius) {
+        m_clusterRadius = radius;
+        emit clusterRadiusChanged();
+        scheduleRefresh();
+    }
+}
+
+void MarkerClusterModel::setMaxClusterZoom(int zoom)
+{
+    if (m_maxClusterZoom != zoom) {
+        m_maxClusterZoom = zoom;
+        emit maxClusterZoomChanged();
+        scheduleRefresh();
+    }
+}
+
+void MarkerClusterModel::setViewport(double north, double west, double south, double east, double zoomLevel)
+{
+    m_north = north;
+    m_west = west;
+    m_south = south;
+    m_east = east;
+    m_zoomLevel = zoomLevel;
+    m_hasViewport = true;
+    scheduleRefresh();
+}
+
+void MarkerClusterModel::rebuildIndex()
+{
+    m_index.clear();
+    m_removedRows = 0;
+    m_purgedBelow = 0;
+    if (m_source && m_source->count() > 0) {
+        indexRows(0, m_source->count() - 1);
+    }
+    scheduleRefresh();
+}
+
+void MarkerClusterModel::indexRows(int first, int last)
+{
+    for (int row = first; row <= last; ++row) {
+        m_index.insert(m_removedRows + row, m_source->latitudeAt(row), m_source->longitudeAt(row));
+    }
+}
+
+void MarkerClusterModel::onRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid())
+        return;
+
+    // The source only ever appends
+    if (first != m_source->count() - (last - first + 1)) {
+        rebuildIndex();
+        return;
+    }
+    indexRows(first, last);
+    scheduleRefresh();
+}
+
+void MarkerClusterModel::onRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid())
+        return;
+
+    // Pruning removes from the head: shifting the key base drops those rows at once
+    if (first != 0) {
+        rebuildIndex();
+        return;
+    }
+    m_removedRows += last - first + 1;
+
+    // Physically drop stale keys once they make up half of the index
+    if ((m_removedRows - m_purgedBelow) * 2 > m_index.size()) {
+        m_index.removeBelow(m_removedRows);
+        m_purgedBelow = m_removedRows;
+    }
+    scheduleRefresh();
+}
+
+void MarkerClusterModel::onDataChanged(const QModelIndex &, const QModelIndex &, const QList<int> &roles)
+{
+    // Only hazard levels change in place; they feed the per-cluster maximum
+    if (roles.isEmpty() || roles.contains(SensorReadingModel::HazardLevelRole)) {
+        scheduleRefresh();
+    }
+}
+
+void MarkerClusterModel::scheduleRefresh()
+{
+    if (!m_refreshTimer.isActive()) {
+        m_refreshTimer.start();
+    }
+}
+
+void MarkerClusterModel::refreshClusters()
+{
+    QList<Cluster> clusters;
+    int visible = 0;
+
+    if (m_source && m_hasViewport) {
+        const int rows = m_source->count();
+        const bool clustering = m_zoomLevel < m_maxClusterZoom;
+
+        // Cluster cell edge in normalized Mercator units: clusterRadius pixels at this zoom
+        const double worldPixels = 256.0 * std::pow(2.0, m_zoomLevel);
+        const double cellSize = m_clusterRadius / worldPixels;
+        const bool wrapsAntimeridian = m_west > m_east;
+
+        QHash<quint64, int> clusterByCell;
+
+        m_index.query(m_north, m_west, m_south, m_east, [&](qint64 key) {
+            const qint64 row = key - m_removedRows;
+            if (row < 0 || row >= rows)
+                return;
+
+            const double lat = m_source->latitudeAt(int(row));
+            const double lon = m_source->longitudeAt(int(row));
+            if (lat > m_north || lat < m_south)
+                return;
+            if (!wrapsAntimeridian && (lon < m_west || lon > m_east))
+                return;
+
+            const double x = GeoGridIndex::mercatorX(lon);
+            const double y = GeoGridIndex::mercatorY(lat);
+            ++visible;
+
+            int slot;
+            if (clustering) {
+                const quint64 cell = (quint64(quint32(x / cellSize)) << 32) | quint32(y / cellSize);
+                auto it = clusterByCell.find(cell);
+                if (it == clusterByCell.end()) {
+                    it = clusterByCell.insert(cell, clusters.count());
+                    clusters.append(Cluster());
+                    clusters.last().key = cell;
+                }
+                slot = it.value();
+            } else {
+                slot = clusters.count();
+                clusters.append(Cluster());
+                clusters.last().key = quint64(key);
+            }
+
+            Cluster &cluster = clusters[slot];
+            ++cluster.count;
+            cluster.sumX += x;
+            cluster.sumY += y;
+            cluster.maxHazard = qMax(cluster.maxHazard, m_source->hazardLevelAt(int(row)));
+            if (key > cluster.latestKey) {
+                cluster.latestKey = key;
+                cluster.latitude = lat;
+                cluster.longitude = lon;
+            }
+        });
+
+        // Clusters sit at their centroid; single readings keep their exact position
+        for (Cluster &cluster : clusters) {
+            if (cluster.count > 1) {
+                cluster.latitude = GeoGridIndex::latitudeFromY(cluster.sumY / cluster.count);
+                cluster.longitude = GeoGridIndex::longitudeFromX(cluster.sumX / cluster.count);
+            }
+        }
+    }
+
+    const int previousCount = m_clusters.count();
+    const int previousVisible = m_visibleReadings;
+    applyClusters(clusters);
+    m_visibleReadings = visible;
+    if (m_clusters.count() != previousCount || m_visibleReadings != previousVisible) {
+        emit countChanged();
+    }
+}
+
+void MarkerClusterModel::applyClusters(const QList<Cluster> &clusters)
+{
+    // Diff by key instead of resetting, so a pan or a live batch only
+    // creates and destroys the delegates of clusters that appear or vanish
+    QHash<quint64, int> newByKey;
+    newByKey.reserve(clusters.count());
+    for (int i = 0; i < clusters.count(); ++i) {
+        newByKey.insert(clusters.at(i).key, i);
+    }
+
+    // Vanished clusters, last first, one signal per contiguous run
+    for (int last = m_clusters.count() - 1; last >= 0; --last) {
+        if (newByKey.contains(m_clusters.at(last).key))
+            continue;
+        int first = last;
+        while (first > 0 && !newByKey.contains(m_clusters.at(first - 1).key)) {
+            --first;
+        }
+        beginRemoveRows(QModelIndex(), first, last);
+        m_clusters.remove(first, last - first + 1);
+        endRemoveRows();
+        last = first;
+    }
+
+    // Surviving clusters are updated in place
+    QList<bool> placed(clusters.count(), false);
+    int changedFirst = -1;
+    auto flushChanged = [&](int end) {
+        if (changedFirst >= 0) {
+            emit dataChanged(index(changedFirst), index(end - 1));
+            changedFirst = -1;
+        }
+    };
+    for (int row = 0; row < m_clusters.count(); ++row) {
+        const int i = newByKey.value(m_clusters.at(row).key);
+        placed[i] = true;
+        if (sameCluster(m_clusters.at(row), clusters.at(i))) {
+            flushChanged(row);
+            continue;
+        }
+        m_clusters[row] = clusters.at(i);
+        if (changedFirst < 0)
+            changedFirst = row;
+    }
+    flushChanged(m_clusters.count());
+
+    // New clusters go to the end
+    const int added = int(std::count(placed.cbegin(), placed.cend(), false));
+    if (added > 0) {
+        beginInsertRows(QModelIndex(), m_clusters.count(), m_clusters.count() + added - 1);
+        for (int i = 0; i < clusters.count(); ++i) {
+            if (!placed.at(i))
+                m_clusters.append(clusters.at(i));
+        }
+        endInsertRows();
+    }
+}
+
+bool MarkerClusterModel::sameCluster(const Cluster &a, const Cluster &b)
+{
+    return a.count == b.count && a.maxHazard == b.maxHazard && a.latestKey == b.latestKey
+        && a.latitude == b.latitude && a.longitude == b.longitude;
+}
+
+int MarkerClusterModel::latestRow(const Cluster &cluster) const
+{
+    // Keys are m_removedRows + source row; the reading may have been pruned since
+    if (!m_source)
+        return -1;
+    const qint64 row = cluster.latestKey - m_removedRows;
+    return row >= 0 && row < m_source->count() ? int(row) : -1;
+}
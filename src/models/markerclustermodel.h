@@ -0,0 +1,109 @@
+#ifndef MARKERCLUSTERMODEL_H
+#define MARKERCLUSTERMODEL_H
+
+#include <QAbstractListModel>
+#include <QQmlEngine>
+#include <QPointer>
+#include <QTimer>
+#include "geogridindex.h"
+#include "sensorreadingmodel.h"
+
+// Viewport-culled, clustered view of a SensorReadingModel for the map.
+// Readings are kept in a grid index; only those inside the viewport are
+// visited, and they are merged into clusters of roughly clusterRadius
+// pixels at the current zoom level.
+class MarkerClusterModel : public QAbstractListModel
+{
+    Q_OBJECT
+    QML_ELEMENT
+
+    Q_PROPERTY(SensorReadingModel *sourceModel READ sourceModel WRITE setSourceModel NOTIFY sourceModelChanged)
+    Q_PROPERTY(int clusterRadius READ clusterRadius WRITE setClusterRadius NOTIFY clusterRadiusChanged)
+    // From this zoom level on every reading is its own marker
+    Q_PROPERTY(int maxClusterZoom READ maxClusterZoom WRITE setMaxClusterZoom NOTIFY maxClusterZoomChanged)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(int visibleReadings READ visibleReadings NOTIFY countChanged)
+
+public:
+    enum Roles {
+        LatitudeRole = Qt::UserRole + 1,
+        LongitudeRole,
+        CountRole,
+        HazardLevelRole,
+        ReadingIdRole,
+        TooltipTextRole
+    };
+
+    explicit MarkerClusterModel(QObject *parent = nullptr);
+
+    // QAbstractListModel interface
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    SensorReadingModel *sourceModel() const { return m_source; }
+    void setSourceModel(SensorReadingModel *model);
+    int clusterRadius() const { return m_clusterRadius; }
+    void setClusterRadius(int radius);
+    int maxClusterZoom() const { return m_maxClusterZoom; }
+    void setMaxClusterZoom(int zoom);
+    int count() const { return m_clusters.count(); }
+    int visibleReadings() const { return m_visibleReadings; }
+
+    // Called by the map whenever its visible region or zoom level changes
+    Q_INVOKABLE void setViewport(double north, double west, double south, double east, double zoomLevel);
+
+signals:
+    void sourceModelChanged();
+    void clusterRadiusChanged();
+    void maxClusterZoomChanged();
+    void countChanged();
+
+private:
+    struct Cluster {
+        // Grid cell when clustering, otherwise the reading's index key; a
+        // cluster keeps its row (and its map delegate) while its key survives
+        quint64 key = 0;
+        int count = 0;
+        double sumX = 0.0;
+        double sumY = 0.0;
+        int maxHazard = 0;
+        qint64 latestKey = -1;  // Index key of the newest reading, stable across pruning
+        double latitude = 0.0;
+        double longitude = 0.0;
+    };
+
+    static bool sameCluster(const Cluster &a, const Cluster &b);
+    int latestRow(const Cluster &cluster) const;
+    void applyClusters(const QList<Cluster> &clusters);
+
+    void rebuildIndex();
+    void indexRows(int first, int last);
+    void scheduleRefresh();
+    void refreshClusters();
+
+    void onRowsInserted(const QModelIndex &parent, int first, int last);
+    void onRowsRemoved(const QModelIndex &parent, int first, int last);
+    void onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QList<int> &roles);
+
+    QPointer<SensorReadingModel> m_source;
+    GeoGridIndex m_index;
+    // Index keys are m_removedRows + source row, so head removals are O(1)
+    qint64 m_removedRows = 0;
+    qint64 m_purgedBelow = 0;
+
+    QList<Cluster> m_clusters;
+    int m_visibleReadings = 0;
+    QTimer m_refreshTimer;
+
+    bool m_hasViewport = false;
+    double m_north = 0.0;
+    double m_west = 0.0;
+    double m_south = 0.0;
+    double m_east = 0.0;
+    double m_zoomLevel = 0.0;
+    int m_clusterRadius = 48;
+    int m_maxClusterZoom = 18;
+};
+
+#endif // MARKERCLUSTERMODEL_H
@@ -1,8 +1,9 @@
 #include "sensorreadingmodel.h"
 #include "databasemanager.h"
 #include "thresholdmanager.h"
-#include "serialhandler.h"
 #include <QDateTime>
+#include <algorithm>
+#include <limits>
 
 SensorReadingModel::SensorReadingModel(QObject *parent)
     : QAbstractListModel(parent)
@@ -13,58 +14,50 @@ int SensorReadingModel::rowCount(const QModelIndex &parent) const
 {
     if (parent.isValid())
         return 0;
-    return m_readings.count();
+    return count();
 }
 
 QVariant SensorReadingModel::data(const QModelIndex &index, int role) const
 {
-    if (!index.isValid() || index.row() < 0 || index.row() >= m_readings.count())
+    if (!index.isValid() || index.row() < 0 || index.row() >= count())
         return QVariant();
 
-    const ReadingEntry &entry = m_readings.at(index.row());
-    const SensorReading &reading = entry.reading;
+    const qsizetype row = m_head + index.row();
+    const ReadingColumns &c = m_columns;
 
     switch (role) {
     case IdRole:
-        return entry.id;
+        return c.ids.at(row);
     case LatitudeRole:
-        return reading.latitude;
+        return c.latitude.at(row);
     case LongitudeRole:
-        return reading.longitude;
+        return c.longitude.at(row);
     case PartectorNumberRole:
-        return reading.partectorNumber;
+        return c.partectorNumber.at(row);
     case PartectorDiamRole:
-        return reading.partectorDiam;
+        return c.partectorDiam.at(row);
     case PartectorMassRole:
-        return reading.partectorMass;
+        return c.partectorMass.at(row);
     case GrimmValueRole:
-        return reading.grimmValue;
+        return c.grimmValue.at(row);
     case TemperatureRole:
-        return reading.temperature;
+        return c.temperature.at(row);
     case HumidityRole:
-        return reading.humidity;
+        return c.humidity.at(row);
     case PressureRole:
-        return reading.pressure;
+        return c.pressure.at(row);
     case AltitudeRole:
-        return reading.altitude;
+        return c.altitude.at(row);
     case Co2Role:
-        return reading.co2;
+        return c.co2.at(row);
     case TimestampRole:
-        return reading.timestamp;
+        return QDateTime::fromMSecsSinceEpoch(c.timestamps.at(row));
     case TooltipTextRole:
-        return formatTooltip(reading);
-    case HazardLevelRole: {
-        ThresholdManager *tm = ThresholdManager::instance();
-        if (tm) {
-            return tm->computeHazardLevel(
-                reading.partectorNumber, reading.partectorDiam,
-                reading.partectorMass, reading.grimmValue,
-                reading.temperature, reading.humidity,
-                reading.pressure, reading.altitude, reading.co2
-            );
-        }
-        return 0;  // Green default if manager not yet available
-    }
+        return formatTooltip(c.reading(row));
+    case HazardLevelRole:
+        return int(m_hazardLevels.at(row));
+    case DeviceIdRole:
+        return c.deviceIds.at(row);
     default:
         return QVariant();
     }
@@ -88,9 +81,15 @@ QHash<int, QByteArray> SensorReadingModel::roleNames() const
     roles[TimestampRole] = "timestamp";
     roles[TooltipTextRole] = "tooltipText";
     roles[HazardLevelRole] = "hazardLevel";
+    roles[DeviceIdRole] = "deviceId";
     return roles;
 }
 
+SensorReadingModel::~SensorReadingModel()
+{
+    m_pendingLoad.cancel();
+}
+
 void SensorReadingModel::loadFromDatabase(const QDateTime &start, const QDateTime &end)
 {
     // Get singleton instance - created by QML engine
@@ -103,62 +102,129 @@ void SensorReadingModel::loadFromDatabase(const QDateTime &start, const QDateTim
         return;
     }
 
+    // A newer range supersedes whatever is still loading
+    m_pendingLoad.cancel();
+    m_liveDuringLoad.clear();
+
+    m_pendingLoad = dbManager->queryReadingsInRange(start, end, m_deviceId);
+    m_pendingLoad.then(this, [this](const ReadingColumns &results) {
+        applyLoadedReadings(results);
+    });
+
+    if (!m_loading) {
+        m_loading = true;
+        emit loadingChanged();
+    }
+}
+
+void SensorReadingModel::applyLoadedReadings(const ReadingColumns &results)
+{
     beginResetModel();
-    m_readings.clear();
-
-    QVariantList results = dbManager->getReadingsInRange(start, end);
-    for (const QVariant &var : results) {
-        QVariantMap map = var.toMap();
-        SensorReading reading;
-        reading.partectorNumber = map["partectorNumber"].toInt();
-        reading.partectorDiam = map["partectorDiam"].toInt();
-        reading.partectorMass = map["partectorMass"].toFloat();
-        reading.grimmValue = map["grimmValue"].toFloat();
-        reading.temperature = map["temperature"].toFloat();
-        reading.humidity = map["humidity"].toFloat();
-        reading.pressure = map["pressure"].toFloat();
-        reading.altitude = map["altitude"].toFloat();
-        reading.latitude = map["latitude"].toFloat();
-        reading.longitude = map["longitude"].toFloat();
-        reading.co2 = map["co2"].toInt();
-        reading.timestamp = map["timestamp"].toDateTime();
-
-        // Only add readings with valid GPS coordinates
-        if (isValidCoordinate(reading.latitude, reading.longitude)) {
-            ReadingEntry entry;
-            entry.id = map["id"].toInt();
-            entry.reading = reading;
-            m_readings.append(entry);
+    m_head = 0;
+
+    // Only keep readings with valid GPS coordinates; share the columns when all are valid
+    qsizetype firstInvalid = 0;
+    while (firstInvalid < results.size()
+           && isValidCoordinate(results.latitude.at(firstInvalid), results.longitude.at(firstInvalid))) {
+        ++firstInvalid;
+    }
+    if (firstInvalid == results.size()) {
+        m_columns = results;
+    } else {
+        m_columns.clear();
+        m_columns.reserve(results.size());
+        for (qsizetype row = 0; row < results.size(); ++row) {
+            if (isValidCoordinate(results.latitude.at(row), results.longitude.at(row))) {
+                m_columns.appendRow(results, row);
+            }
         }
     }
 
-    // Connect to ThresholdManager for live updates (instance available after QML loads)
-    connectToThresholdManager();
+    // Live readings that arrived while the query ran and are newer than its result
+    const qint64 lastLoaded = m_columns.isEmpty() ? std::numeric_limits<qint64>::min() : m_columns.timestamps.last();
+    for (const SensorReading &reading : std::as_const(m_liveDuringLoad)) {
+        if (reading.timestampMs > lastLoaded) {
+            m_columns.append(m_nextId++, reading);
+        }
+    }
+    m_liveDuringLoad.clear();
+
+    m_hazardLevels.resize(m_columns.size());
+    computeHazardLevels(0, m_columns.size(), m_hazardLevels.data());
 
     endResetModel();
     emit countChanged();
+
+    // Connect to ThresholdManager for live updates (instance available after QML loads)
+    connectToThresholdManager();
+
+    m_loading = false;
+    emit loadingChanged();
+    emit loadFinished();
 }
 
 void SensorReadingModel::clear()
 {
+    m_pendingLoad.cancel();
+    m_liveDuringLoad.clear();
+    if (m_loading) {
+        m_loading = false;
+        emit loadingChanged();
+    }
+
     beginResetModel();
-    m_readings.clear();
+    m_columns.clear();
+    m_hazardLevels.clear();
+    m_head = 0;
     endResetModel();
     emit countChanged();
 }
 
 void SensorReadingModel::addReading(const SensorReading &reading)
 {
-    // Only add readings with valid GPS coordinates
-    if (!isValidCoordinate(reading.latitude, reading.longitude)) {
+    addReadings(ReadingBatch{ reading });
+}
+
+void SensorReadingModel::setDeviceId(int deviceId)
+{
+    if (m_deviceId == deviceId)
+        return;
+
+    // Rows of the previous device would join the new one's track
+    clear();
+    m_deviceId = deviceId;
+    emit deviceIdChanged();
+}
+
+void SensorReadingModel::addReadings(const ReadingBatch &readings)
+{
+    // Only add this device's readings with valid GPS coordinates
+    qsizetype valid = 0;
+    for (const SensorReading &reading : readings) {
+        if (accepts(reading))
+            ++valid;
+    }
+    if (valid == 0)
+        return;
+
+    // Held back until the pending load resets the model
+    if (m_loading) {
+        for (const SensorReading &reading : readings) {
+            if (accepts(reading))
+                m_liveDuringLoad.append(reading);
+        }
         return;
     }
 
-    beginInsertRows(QModelIndex(), m_readings.count(), m_readings.count());
-    ReadingEntry entry;
-    entry.id = m_nextId++;
-    entry.reading = reading;
-    m_readings.append(entry);
+    // One row insertion for the whole batch
+    const qsizetype firstColumn = m_columns.size();
+    beginInsertRows(QModelIndex(), count(), count() + int(valid) - 1);
+    for (const SensorReading &reading : readings) {
+        if (accepts(reading))
+            m_columns.append(m_nextId++, reading);
+    }
+    m_hazardLevels.resize(m_columns.size());
+    computeHazardLevels(firstColumn, valid, m_hazardLevels.data() + firstColumn);
     endInsertRows();
     emit countChanged();
 }
@@ -166,11 +232,11 @@ void SensorReadingModel::addReading(const SensorReading &reading)
 QVariantMap SensorReadingModel::getReading(int index) const
 {
     QVariantMap result;
-    if (index < 0 || index >= m_readings.count())
+    if (index < 0 || index >= count())
         return result;
 
-    const SensorReading &reading = m_readings.at(index).reading;
-    result["readingId"] = m_readings.at(index).id;
+    const SensorReading reading = m_columns.reading(m_head + index);
+    result["readingId"] = m_columns.ids.at(m_head + index);
     result["latitude"] = reading.latitude;
     result["longitude"] = reading.longitude;
     result["partectorNumber"] = reading.partectorNumber;
@@ -182,7 +248,8 @@ QVariantMap SensorReadingModel::getReading(int index) const
     result["pressure"] = reading.pressure;
     result["altitude"] = reading.altitude;
     result["co2"] = reading.co2;
-    result["timestamp"] = reading.timestamp;
+    result["timestamp"] = reading.timestamp();
+    result["deviceId"] = reading.deviceId;
     return result;
 }
 
@@ -201,8 +268,9 @@ QString SensorReadingModel::formatTooltip(const SensorReading &reading) const
         "Temperature: %9 C\n"
         "Humidity: %10 %\n"
         "Pressure: %11 hPa\n"
-        "CO2: %12 ppm"
-    ).arg(reading.timestamp.toString("yyyy-MM-dd hh:mm:ss"))
+        "CO2: %12 ppm\n"
+        "Device: %13"
+    ).arg(reading.timestamp().toString("yyyy-MM-dd hh:mm:ss"))
      .arg(reading.latitude, 0, 'f', 6)
      .arg(reading.longitude, 0, 'f', 6)
      .arg(reading.altitude, 0, 'f', 1)
@@ -213,7 +281,8 @@ QString SensorReadingModel::formatTooltip(const SensorReading &reading) const
      .arg(reading.temperature, 0, 'f', 1)
      .arg(reading.humidity, 0, 'f', 1)
      .arg(reading.pressure, 0, 'f', 1)
-     .arg(reading.co2);
+     .arg(reading.co2)
+     .arg(reading.deviceId);
 }
 
 bool SensorReadingModel::isValidCoordinate(float lat, float lon) const
@@ -229,6 +298,11 @@ bool SensorReadingModel::isValidCoordinate(float lat, float lon) const
     return true;
 }
 
+bool SensorReadingModel::accepts(const SensorReading &reading) const
+{
+    return reading.deviceId == m_deviceId && isValidCoordinate(reading.latitude, reading.longitude);
+}
+
 void SensorReadingModel::connectToThresholdManager()
 {
     if (m_thresholdManagerConnected)
@@ -239,13 +313,45 @@ void SensorReadingModel::connectToThresholdManager()
         connect(tm, &ThresholdManager::thresholdsChanged,
                 this, &SensorReadingModel::onThresholdsChanged);
         m_thresholdManagerConnected = true;
+
+        // Levels cached before the manager existed are all Green
+        onThresholdsChanged();
+    }
+}
+
+void SensorReadingModel::computeHazardLevels(qsizetype from, qsizetype length, quint8 *levels) const
+{
+    ThresholdManager *tm = ThresholdManager::instance();
+    if (tm) {
+        tm->computeHazardLevels(m_columns, from, length, levels);
+    } else {
+        std::fill(levels, levels + length, quint8(0));  // Green default if manager not yet available
     }
 }
 
 void SensorReadingModel::onThresholdsChanged()
 {
-    if (!m_readings.isEmpty()) {
-        emit dataChanged(index(0), index(m_readings.count() - 1), {HazardLevelRole});
+    const int rows = count();
+    if (rows == 0)
+        return;
+
+    // Recompute every level in one pass, then notify only the runs that changed
+    QList<quint8> levels(rows);
+    computeHazardLevels(m_head, rows, levels.data());
+
+    quint8 *cached = m_hazardLevels.data() + m_head;
+    int row = 0;
+    while (row < rows) {
+        if (levels.at(row) == cached[row]) {
+            ++row;
+            continue;
+        }
+        const int first = row;
+        while (row < rows && levels.at(row) != cached[row]) {
+            cached[row] = levels.at(row);
+            ++row;
+        }
+        emit dataChanged(index(first), index(row - 1), {HazardLevelRole});
     }
 }
 
@@ -254,13 +360,12 @@ void SensorReadingModel::startLiveUpdates()
     if (m_liveUpdatesConnected)
         return;
 
-    SerialHandler *serial = qobject_cast<SerialHandler*>(
-        qmlEngine(this)->singletonInstance<SerialHandler*>("ZephyrSense", "SerialHandler")
-    );
+    m_readingBus = qmlEngine(this)->singletonInstance<ReadingBus*>("ZephyrSense", "ReadingBus");
 
-    if (serial) {
-        connect(serial, &SerialHandler::newReading,
-                this, &SensorReadingModel::addReading);
+    if (m_readingBus) {
+        // Once per frame at most: one row insertion per batch instead of per reading
+        m_busSubscription = m_readingBus->subscribe(this, ReadingBus::EveryFrame,
+                                                    [this](const ReadingBatch &batch) { addReadings(batch); });
         m_liveUpdatesConnected = true;
     }
 
@@ -273,40 +378,34 @@ void SensorReadingModel::stopLiveUpdates()
     if (!m_liveUpdatesConnected)
         return;
 
-    SerialHandler *serial = qobject_cast<SerialHandler*>(
-        qmlEngine(this)->singletonInstance<SerialHandler*>("ZephyrSense", "SerialHandler")
-    );
-
-    if (serial) {
-        disconnect(serial, &SerialHandler::newReading,
-                   this, &SensorReadingModel::addReading);
-        m_liveUpdatesConnected = false;
+    if (m_readingBus) {
+        m_readingBus->unsubscribe(m_busSubscription);
     }
+    m_busSubscription = 0;
+    m_liveUpdatesConnected = false;
 }
 
 void SensorReadingModel::pruneOldReadings(int windowMinutes)
 {
-    if (m_readings.isEmpty())
+    if (count() == 0)
         return;
 
-    QDateTime cutoff = QDateTime::currentDateTime().addSecs(-windowMinutes * 60);
+    const qint64 cutoff = QDateTime::currentMSecsSinceEpoch() - qint64(windowMinutes) * 60 * 1000;
 
-    // Find index of first reading to keep
-    int firstToKeep = 0;
-    for (int i = 0; i < m_readings.count(); ++i) {
-        if (m_readings.at(i).reading.timestamp >= cutoff) {
-            firstToKeep = i;
-            break;
-        }
-        if (i == m_readings.count() - 1) {
-            // All readings are old
-            firstToKeep = m_readings.count();
-        }
-    }
+    // Rows are time-ordered, so the expired ones form a prefix
+    const auto begin = m_columns.timestamps.cbegin() + m_head;
+    const qsizetype expired = std::lower_bound(begin, m_columns.timestamps.cend(), cutoff) - begin;
+
+    if (expired > 0) {
+        beginRemoveRows(QModelIndex(), 0, int(expired) - 1);
+        m_head += expired;
 
-    if (firstToKeep > 0) {
-        beginRemoveRows(QModelIndex(), 0, firstToKeep - 1);
-        m_readings.remove(0, firstToKeep);
+        // Compact once the dead prefix outweighs the live rows (amortized O(1) per reading)
+        if (m_head > 1024 && m_head * 2 > m_columns.size()) {
+            m_columns.removeFirst(m_head);
+            m_hazardLevels.remove(0, m_head);
+            m_head = 0;
+        }
         endRemoveRows();
         emit countChanged();
     }
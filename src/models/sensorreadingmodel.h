@@ -4,7 +4,11 @@
 #include <QAbstractListModel>
 #include <QQmlEngine>
 #include <QDateTime>
+#include <QFuture>
+#include <QPointer>
 #include "sensorreading.h"
+#include "readingcolumns.h"
+#include "readingbus.h"
 #include "thresholdmanager.h"
 
 class SensorReadingModel : public QAbstractListModel
@@ -13,6 +17,9 @@ class SensorReadingModel : public QAbstractListModel
     QML_ELEMENT
 
     Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(bool loading READ isLoading NOTIFY loadingChanged)
+    // Only readings of this device are loaded and appended; changing it clears the rows
+    Q_PROPERTY(int deviceId READ deviceId WRITE setDeviceId NOTIFY deviceIdChanged)
 
 public:
     enum Roles {
@@ -30,45 +37,73 @@ public:
         Co2Role,
         TimestampRole,
         TooltipTextRole,
-        HazardLevelRole
+        HazardLevelRole,
+        DeviceIdRole
     };
 
     explicit SensorReadingModel(QObject *parent = nullptr);
+    ~SensorReadingModel();
 
     // QAbstractListModel interface
     int rowCount(const QModelIndex &parent = QModelIndex()) const override;
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
     QHash<int, QByteArray> roleNames() const override;
 
-    int count() const { return m_readings.count(); }
+    int count() const { return int(m_columns.size() - m_head); }
+    bool isLoading() const { return m_loading; }
+    int deviceId() const { return m_deviceId; }
+    void setDeviceId(int deviceId);
 
+    // Direct row access for C++ consumers such as MarkerClusterModel
+    float latitudeAt(int row) const { return m_columns.latitude.at(m_head + row); }
+    float longitudeAt(int row) const { return m_columns.longitude.at(m_head + row); }
+    int hazardLevelAt(int row) const { return m_hazardLevels.at(m_head + row); }
+    qint64 readingIdAt(int row) const { return m_columns.ids.at(m_head + row); }
+
+    // Loads asynchronously; loadFinished() is emitted once the rows are in place
     Q_INVOKABLE void loadFromDatabase(const QDateTime &start, const QDateTime &end);
     Q_INVOKABLE void clear();
     Q_INVOKABLE QVariantMap getReading(int index) const;
     Q_INVOKABLE void startLiveUpdates();
     Q_INVOKABLE void stopLiveUpdates();
+    // Drops readings older than the window; binary search plus a head advance
     Q_INVOKABLE void pruneOldReadings(int windowMinutes);
 
 public slots:
     void addReading(const SensorReading &reading);
+    void addReadings(const ReadingBatch &readings);
 
 signals:
     void countChanged();
+    void loadingChanged();
+    void loadFinished();
+    void deviceIdChanged();
 
 private:
-    struct ReadingEntry {
-        qint64 id;
-        SensorReading reading;
-    };
-
     QString formatTooltip(const SensorReading &reading) const;
     bool isValidCoordinate(float lat, float lon) const;
+    bool accepts(const SensorReading &reading) const;
     void connectToThresholdManager();
+    void applyLoadedReadings(const ReadingColumns &results);
+    void computeHazardLevels(qsizetype from, qsizetype length, quint8 *levels) const;
 
-    QList<ReadingEntry> m_readings;
+    // Time-ordered columns; model row i lives at column index m_head + i.
+    // Pruning only advances m_head, the dead prefix is compacted away lazily.
+    ReadingColumns m_columns;
+    qsizetype m_head = 0;
+    // Cached hazard level per column index, kept in step with m_columns
+    QList<quint8> m_hazardLevels;
     qint64 m_nextId = 1;
+    int m_deviceId = 0;
     bool m_thresholdManagerConnected = false;
     bool m_liveUpdatesConnected = false;
+    QPointer<ReadingBus> m_readingBus;
+    int m_busSubscription = 0;
+
+    // In-flight range query and live readings received while it runs
+    QFuture<ReadingColumns> m_pendingLoad;
+    ReadingBatch m_liveDuringLoad;
+    bool m_loading = false;
 
 private slots:
     void onThresholdsChanged();
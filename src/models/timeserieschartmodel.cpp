@@ -1,7 +1,9 @@
 #include "timeserieschartmodel.h"
 #include "databasemanager.h"
+#include "decimation.h"
+#include <algorithm>
 #include <QDebug>
-#include <QVariantMap>
+#include <iterator>
 #include <limits>
 
 TimeSeriesChartModel::TimeSeriesChartModel(QObject *parent)
@@ -9,11 +11,16 @@ TimeSeriesChartModel::TimeSeriesChartModel(QObject *parent)
 {
 }
 
+TimeSeriesChartModel::~TimeSeriesChartModel()
+{
+    m_pendingLoad.cancel();
+}
+
 int TimeSeriesChartModel::rowCount(const QModelIndex &parent) const
 {
     if (parent.isValid())
         return 0;
-    return m_data.count();
+    return displayCount();
 }
 
 int TimeSeriesChartModel::columnCount(const QModelIndex &parent) const
@@ -25,20 +32,20 @@ int TimeSeriesChartModel::columnCount(const QModelIndex &parent) const
 
 QVariant TimeSeriesChartModel::data(const QModelIndex &index, int role) const
 {
-    if (!index.isValid() || index.row() >= m_data.count() || role != Qt::DisplayRole)
+    if (!index.isValid() || index.row() >= displayCount() || role != Qt::DisplayRole)
         return QVariant();
 
-    const DataPoint &point = m_data.at(index.row());
+    const qsizetype row = rawRow(index.row());
 
     // Column 0 is timestamp
     if (index.column() == TimestampColumn) {
-        return point.timestamp;
+        return m_data.timestamps.at(row);
     }
 
     // Columns 1-9 are sensor values
     int sensorIndex = index.column() - 1;
-    if (sensorIndex >= 0 && sensorIndex < 9) {
-        return point.values[sensorIndex];
+    if (sensorIndex >= 0 && sensorIndex < ReadingColumns::SensorCount) {
+        return qreal(m_data.sensorValue(sensorIndex, row));
     }
 
     return QVariant();
@@ -59,50 +66,75 @@ void TimeSeriesChartModel::loadData(const QDateTime &start, const QDateTime &end
         return;
     }
 
-    beginResetModel();
+    // A newer range supersedes whatever is still loading
+    m_pendingLoad.cancel();
+    m_liveDuringLoad.clear();
 
-    // Clear existing data
-    m_data.clear();
+    // Long ranges come from a rollup tier sized to the point budget
+    m_pendingLoad = dbManager->queryChartRange(start, end, m_pointBudget, m_deviceId);
+    m_pendingLoad.then(this, [this, start, end](const ReadingColumns &readings) {
+        qDebug() << "TimeSeriesChartModel: Loaded" << readings.size() << "readings from" << start << "to" << end;
+        applyLoadedReadings(readings);
+    });
 
-    // Get readings from database
-    QVariantList readings = dbManager->getReadingsInRange(start, end);
-    qDebug() << "TimeSeriesChartModel: Loaded" << readings.count() << "readings from" << start << "to" << end;
+    if (!m_loading) {
+        m_loading = true;
+        emit loadingChanged();
+    }
+}
 
-    // Convert to DataPoint structs
-    for (const QVariant &v : readings) {
-        QVariantMap map = v.toMap();
+void TimeSeriesChartModel::applyLoadedReadings(const ReadingColumns &readings)
+{
+    beginResetModel();
 
-        DataPoint point;
-        point.timestamp = map["timestamp"].toDateTime().toMSecsSinceEpoch();
+    // Columns are shared with the query result, no per-row conversion
+    m_data = readings;
+    m_firstSeq = 0;
 
-        // Map sensor fields to values array (9 sensors, excluding lat/lon)
-        point.values[0] = map["partectorNumber"].toReal();
-        point.values[1] = map["partectorDiam"].toReal();
-        point.values[2] = map["partectorMass"].toReal();
-        point.values[3] = map["grimmValue"].toReal();
-        point.values[4] = map["temperature"].toReal();
-        point.values[5] = map["humidity"].toReal();
-        point.values[6] = map["pressure"].toReal();
-        point.values[7] = map["altitude"].toReal();
-        point.values[8] = map["co2"].toReal();
+    // Live readings that arrived while the query ran and are newer than its result
+    const qint64 lastLoaded = m_data.isEmpty() ? std::numeric_limits<qint64>::min() : m_data.timestamps.last();
+    for (const SensorReading &reading : std::as_const(m_liveDuringLoad)) {
+        if (reading.timestampMs > lastLoaded) {
+            m_data.append(0, reading);  // Not stored yet, the chart never uses ids
+        }
+    }
+    m_liveDuringLoad.clear();
 
-        m_data.append(point);
+    if (m_liveUpdatesConnected) {
+        rebuildSensorWindows();
     }
 
     // Calculate bounds
     calculateBounds();
+    decimate();
 
     endResetModel();
 
     emit boundsChanged();
     emit dataCountChanged();
+
+    m_loading = false;
+    emit loadingChanged();
 }
 
 void TimeSeriesChartModel::clear()
 {
+    m_pendingLoad.cancel();
+    m_liveDuringLoad.clear();
+    if (m_loading) {
+        m_loading = false;
+        emit loadingChanged();
+    }
+
     beginResetModel();
 
     m_data.clear();
+    m_firstSeq = 0;
+    m_displaySeqs.clear();
+    m_decimated = false;
+    for (auto &window : m_sensorWindows) {
+        window.clear();
+    }
     m_xMin = 0;
     m_xMax = 0;
     m_yMin = 0;
@@ -121,9 +153,65 @@ void TimeSeriesChartModel::updateYBoundsForColumn(int column)
         return;
     }
 
+    const bool columnChanged = (m_activeColumn != column);
     m_activeColumn = column;
     calculateYBoundsForColumn(column);
     emit boundsChanged();
+
+    // Buckets keep the extremes of the active sensor only
+    if (columnChanged && m_decimated) {
+        redecimate();
+    }
+}
+
+void TimeSeriesChartModel::setPointBudget(int budget)
+{
+    budget = qMax(0, budget);
+    if (m_pointBudget == budget)
+        return;
+
+    m_pointBudget = budget;
+    emit pointBudgetChanged();
+    redecimate();
+}
+
+void TimeSeriesChartModel::setDeviceId(int deviceId)
+{
+    if (m_deviceId == deviceId)
+        return;
+
+    // One series per device: the previous device's rows must not join the new ones
+    clear();
+    m_deviceId = deviceId;
+    emit deviceIdChanged();
+}
+
+void TimeSeriesChartModel::decimate()
+{
+    m_displaySeqs.clear();
+    m_decimated = m_pointBudget > 0 && m_data.size() > m_pointBudget;
+    if (!m_decimated)
+        return;
+
+    m_data.visitSensor(m_activeColumn - 1, [this](const auto &column) {
+        const QList<qsizetype> kept = decimateMinMax(m_data.timestamps, column, qsizetype(m_pointBudget));
+        m_displaySeqs.reserve(kept.size());
+        for (const qsizetype row : kept) {
+            m_displaySeqs.append(m_firstSeq + row);
+        }
+    });
+}
+
+void TimeSeriesChartModel::redecimate()
+{
+    const bool wasDecimated = m_decimated;
+    if (!wasDecimated && (m_pointBudget == 0 || m_data.size() <= m_pointBudget))
+        return;
+
+    beginResetModel();
+    decimate();
+    endResetModel();
+    emit dataCountChanged();
 }
 
 void TimeSeriesChartModel::calculateBounds()
@@ -137,8 +225,8 @@ void TimeSeriesChartModel::calculateBounds()
     }
 
     // X bounds from first and last timestamp
-    m_xMin = m_data.first().timestamp;
-    m_xMax = m_data.last().timestamp;
+    m_xMin = m_data.timestamps.first();
+    m_xMax = m_data.timestamps.last();
 
     // Y bounds for active column (default: temperature)
     calculateYBoundsForColumn(m_activeColumn);
@@ -153,20 +241,34 @@ void TimeSeriesChartModel::calculateYBoundsForColumn(int column)
     }
 
     int sensorIndex = column - 1;  // Column 0 is timestamp, sensors start at 1
-    if (sensorIndex < 0 || sensorIndex >= 9) {
+    if (sensorIndex < 0 || sensorIndex >= ReadingColumns::SensorCount) {
         qWarning() << "TimeSeriesChartModel: Invalid sensor index:" << sensorIndex;
         return;
     }
 
+    // Live mode keeps the bounds of every sensor current, no scan needed
+    const SlidingMinMax<double> &window = m_sensorWindows[sensorIndex];
+    if (m_liveUpdatesConnected && !window.isEmpty()) {
+        setYBounds(window.min(), window.max());
+        return;
+    }
+
     qreal minVal = std::numeric_limits<qreal>::max();
     qreal maxVal = std::numeric_limits<qreal>::lowest();
 
-    for (const DataPoint &point : m_data) {
-        qreal value = point.values[sensorIndex];
-        if (value < minVal) minVal = value;
-        if (value > maxVal) maxVal = value;
-    }
+    // Single pass over one contiguous column
+    m_data.visitSensor(sensorIndex, [&](const auto &column) {
+        for (const auto value : column) {
+            if (value < minVal) minVal = value;
+            if (value > maxVal) maxVal = value;
+        }
+    });
 
+    setYBounds(minVal, maxVal);
+}
+
+void TimeSeriesChartModel::setYBounds(qreal minVal, qreal maxVal)
+{
     // Add 10% padding to Y axis for better visualization
     qreal padding = (maxVal - minVal) * 0.1;
     m_yMin = minVal - padding;
@@ -178,3 +280,171 @@ void TimeSeriesChartModel::calculateYBoundsForColumn(int column)
         m_yMax += 1;
     }
 }
+
+void TimeSeriesChartModel::startLiveUpdates(int windowMinutes)
+{
+    m_liveWindowMs = qint64(qMax(1, windowMinutes)) * 60 * 1000;
+
+    if (!m_liveUpdatesConnected) {
+        QQmlEngine *engine = qmlEngine(this);
+        if (!engine) {
+            qWarning() << "TimeSeriesChartModel: QML engine not available, cannot start live updates";
+            return;
+        }
+
+        m_readingBus = engine->singletonInstance<ReadingBus*>("ZephyrSense", "ReadingBus");
+        if (!m_readingBus) {
+            qWarning() << "TimeSeriesChartModel: ReadingBus singleton not available";
+            return;
+        }
+
+        // Once per frame at most: one row insertion per batch instead of per reading
+        m_busSubscription = m_readingBus->subscribe(this, ReadingBus::EveryFrame,
+                                                    [this](const ReadingBatch &batch) { addReadings(batch); });
+        m_liveUpdatesConnected = true;
+        emit liveUpdatesChanged();
+
+        // One pass over what is already loaded; everything after is incremental
+        rebuildSensorWindows();
+    }
+
+    trimToWindow();
+    updateLiveBounds();
+}
+
+void TimeSeriesChartModel::stopLiveUpdates()
+{
+    if (!m_liveUpdatesConnected)
+        return;
+
+    if (m_readingBus) {
+        m_readingBus->unsubscribe(m_busSubscription);
+    }
+    m_busSubscription = 0;
+
+    m_liveUpdatesConnected = false;
+    m_liveDuringLoad.clear();
+    for (auto &window : m_sensorWindows) {
+        window.clear();
+    }
+    emit liveUpdatesChanged();
+}
+
+void TimeSeriesChartModel::trimToWindow()
+{
+    if (!m_liveUpdatesConnected || m_loading)
+        return;
+
+    const int countBefore = m_data.size();
+    trimBefore(QDateTime::currentMSecsSinceEpoch() - m_liveWindowMs);
+    if (m_data.size() != countBefore) {
+        updateLiveBounds();
+    }
+}
+
+void TimeSeriesChartModel::addReading(const SensorReading &reading)
+{
+    addReadings(ReadingBatch{ reading });
+}
+
+void TimeSeriesChartModel::addReadings(const ReadingBatch &batch)
+{
+    // Other devices' readings interleave in time; keep only this series' device
+    const auto otherDevice = [this](const SensorReading &reading) { return reading.deviceId != m_deviceId; };
+    const bool mixed = std::any_of(batch.cbegin(), batch.cend(), otherDevice);
+    ReadingBatch own;
+    if (mixed) {
+        std::remove_copy_if(batch.cbegin(), batch.cend(), std::back_inserter(own), otherDevice);
+    }
+    const ReadingBatch &readings = mixed ? own : batch;
+    if (readings.isEmpty())
+        return;
+
+    // Held back until the pending load resets the model
+    if (m_loading) {
+        m_liveDuringLoad.append(readings);
+        return;
+    }
+
+    // One row insertion and one bounds update for the whole batch
+    const int firstRow = m_data.size();
+    const qint64 firstSeq = m_firstSeq + firstRow;
+    const int displayRow = displayCount();
+    beginInsertRows(QModelIndex(), displayRow, displayRow + int(readings.size()) - 1);
+    for (const SensorReading &reading : readings) {
+        m_data.append(0, reading);  // Not stored yet, the chart never uses ids
+    }
+    if (m_decimated) {
+        for (qint64 seq = firstSeq; seq < firstSeq + readings.size(); ++seq) {
+            m_displaySeqs.append(seq);
+        }
+    }
+    endInsertRows();
+
+    for (int sensor = 0; sensor < ReadingColumns::SensorCount; ++sensor) {
+        for (int row = firstRow; row < m_data.size(); ++row) {
+            m_sensorWindows[sensor].push(m_firstSeq + row, m_data.sensorValue(sensor, row));
+        }
+    }
+
+    trimBefore(QDateTime::currentMSecsSinceEpoch() - m_liveWindowMs);
+
+    // New rows are shown undecimated; fold them in once they eat half the budget again
+    if (m_pointBudget > 0 && displayCount() > m_pointBudget + m_pointBudget / 2) {
+        redecimate();
+    }
+
+    updateLiveBounds();
+}
+
+void TimeSeriesChartModel::trimBefore(qint64 cutoffMs)
+{
+    // Timestamps are ascending, so expired rows form a prefix
+    const auto firstKept = std::lower_bound(m_data.timestamps.cbegin(), m_data.timestamps.cend(), cutoffMs);
+    const int expired = int(firstKept - m_data.timestamps.cbegin());
+    if (expired == 0)
+        return;
+
+    // With decimation only the display rows below the new first sequence go away
+    const qint64 newFirstSeq = m_firstSeq + expired;
+    const int removedRows = m_decimated
+        ? int(std::lower_bound(m_displaySeqs.cbegin(), m_displaySeqs.cend(), newFirstSeq) - m_displaySeqs.cbegin())
+        : expired;
+
+    if (removedRows > 0) {
+        beginRemoveRows(QModelIndex(), 0, removedRows - 1);
+    }
+    m_data.removeFirst(expired);
+    m_firstSeq = newFirstSeq;
+    if (m_decimated) {
+        m_displaySeqs.remove(0, removedRows);
+    }
+    if (removedRows > 0) {
+        endRemoveRows();
+    }
+
+    for (auto &window : m_sensorWindows) {
+        window.expireBefore(m_firstSeq);
+    }
+}
+
+void TimeSeriesChartModel::rebuildSensorWindows()
+{
+    for (int sensor = 0; sensor < ReadingColumns::SensorCount; ++sensor) {
+        SlidingMinMax<double> &window = m_sensorWindows[sensor];
+        window.clear();
+        m_data.visitSensor(sensor, [this, &window](const auto &column) {
+            for (qsizetype row = 0; row < column.size(); ++row) {
+                window.push(m_firstSeq + row, column.at(row));
+            }
+        });
+    }
+}
+
+void TimeSeriesChartModel::updateLiveBounds()
+{
+    // O(1): ends of the timestamp column plus the active sensor's window
+    calculateBounds();
+    emit boundsChanged();
+    emit dataCountChanged();
+}
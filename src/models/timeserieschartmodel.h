@@ -4,7 +4,13 @@
 #include <QAbstractTableModel>
 #include <QQmlEngine>
 #include <QDateTime>
+#include <QFuture>
+#include <QPointer>
 #include "sensorreading.h"
+#include "readingcolumns.h"
+#include "readingbus.h"
+#include "slidingminmax.h"
+#include <array>
 
 class TimeSeriesChartModel : public QAbstractTableModel
 {
@@ -17,6 +23,14 @@ class TimeSeriesChartModel : public QAbstractTableModel
     Q_PROPERTY(qreal yMin READ yMin NOTIFY boundsChanged)
     Q_PROPERTY(qreal yMax READ yMax NOTIFY boundsChanged)
     Q_PROPERTY(int dataCount READ dataCount NOTIFY dataCountChanged)
+    // Rows actually handed to the series after decimation
+    Q_PROPERTY(int displayCount READ displayCount NOTIFY dataCountChanged)
+    // Maximum number of rows exposed to the chart; 0 disables decimation
+    Q_PROPERTY(int pointBudget READ pointBudget WRITE setPointBudget NOTIFY pointBudgetChanged)
+    Q_PROPERTY(bool loading READ isLoading NOTIFY loadingChanged)
+    Q_PROPERTY(bool liveUpdates READ liveUpdates NOTIFY liveUpdatesChanged)
+    // The one device whose readings form the series; changing it clears the data
+    Q_PROPERTY(int deviceId READ deviceId WRITE setDeviceId NOTIFY deviceIdChanged)
 
 public:
     // Column indices - timestamp first, then 9 sensors (excluding lat/lon)
@@ -36,6 +50,7 @@ public:
     Q_ENUM(Columns)
 
     explicit TimeSeriesChartModel(QObject *parent = nullptr);
+    ~TimeSeriesChartModel();
 
     // QAbstractTableModel interface
     int rowCount(const QModelIndex &parent = QModelIndex()) const override;
@@ -47,32 +62,80 @@ public:
     qreal xMax() const { return m_xMax; }
     qreal yMin() const { return m_yMin; }
     qreal yMax() const { return m_yMax; }
-    int dataCount() const { return m_data.count(); }
+    int dataCount() const { return m_data.size(); }
+    int displayCount() const { return m_decimated ? m_displaySeqs.size() : m_data.size(); }
+    int pointBudget() const { return m_pointBudget; }
+    void setPointBudget(int budget);
+    bool isLoading() const { return m_loading; }
+    bool liveUpdates() const { return m_liveUpdatesConnected; }
+    int deviceId() const { return m_deviceId; }
+    void setDeviceId(int deviceId);
 
-    // QML-invokable methods
+    // QML-invokable methods (loadData is asynchronous)
     Q_INVOKABLE void loadData(const QDateTime &start, const QDateTime &end);
     Q_INVOKABLE void clear();
     Q_INVOKABLE void updateYBoundsForColumn(int column);
 
+    // Live mode: append readings from the ReadingBus and keep only the last windowMinutes
+    Q_INVOKABLE void startLiveUpdates(int windowMinutes);
+    Q_INVOKABLE void stopLiveUpdates();
+    // Drop rows that fell out of the live window while no readings arrived
+    Q_INVOKABLE void trimToWindow();
+
+public slots:
+    void addReading(const SensorReading &reading);
+    void addReadings(const ReadingBatch &readings);
+
 signals:
     void boundsChanged();
     void dataCountChanged();
+    void loadingChanged();
+    void liveUpdatesChanged();
+    void pointBudgetChanged();
+    void deviceIdChanged();
 
 private:
-    struct DataPoint {
-        qint64 timestamp;  // msecs since epoch
-        qreal values[9];   // 9 sensor values
-    };
-
+    void applyLoadedReadings(const ReadingColumns &readings);
     void calculateBounds();
     void calculateYBoundsForColumn(int column);
+    void setYBounds(qreal minVal, qreal maxVal);
+
+    // Decimation of m_data into the rows exposed to the chart
+    qsizetype rawRow(int row) const { return m_decimated ? m_displaySeqs.at(row) - m_firstSeq : row; }
+    void decimate();
+    void redecimate();
 
-    QList<DataPoint> m_data;
+    // Live window maintenance
+    void trimBefore(qint64 cutoffMs);
+    void rebuildSensorWindows();
+    void updateLiveBounds();
+
+    // Columnar storage as delivered by the database worker
+    ReadingColumns m_data;
     qreal m_xMin = 0;
     qreal m_xMax = 0;
     qreal m_yMin = 0;
     qreal m_yMax = 0;
     int m_activeColumn = TemperatureColumn;  // Default to temperature
+    int m_deviceId = 0;
+
+    QFuture<ReadingColumns> m_pendingLoad;
+    ReadingBatch m_liveDuringLoad;
+    bool m_loading = false;
+
+    // Live mode: per-sensor window bounds keyed by absolute row sequence,
+    // where row i of m_data has sequence m_firstSeq + i
+    bool m_liveUpdatesConnected = false;
+    QPointer<ReadingBus> m_readingBus;
+    int m_busSubscription = 0;
+    qint64 m_liveWindowMs = 0;
+    qint64 m_firstSeq = 0;
+    std::array<SlidingMinMax<double>, ReadingColumns::SensorCount> m_sensorWindows;
+
+    // Sequences of the rows kept by decimation, ascending; only used when m_decimated
+    int m_pointBudget = 2000;
+    bool m_decimated = false;
+    QList<qint64> m_displaySeqs;
 };
 
 #endif // TIMESERIESCHARTMODEL_H
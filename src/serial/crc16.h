@@ -0,0 +1,37 @@
+#ifndef CRC16_H
+#define CRC16_H
+
+#include <QtGlobal>
+#include <array>
+#include <cstddef>
+
+// CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF, no reflection, no final XOR),
+// one table lookup per byte. Check value: Crc16::ccitt over the 9 bytes "123456789" is 0x29B1.
+namespace Crc16 {
+
+constexpr std::array<quint16, 256> makeTable()
+{
+    std::array<quint16, 256> table{};
+    for (int byte = 0; byte < 256; ++byte) {
+        quint16 crc = quint16(byte << 8);
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 0x8000) ? quint16((crc << 1) ^ 0x1021) : quint16(crc << 1);
+        }
+        table[byte] = crc;
+    }
+    return table;
+}
+
+inline constexpr std::array<quint16, 256> Table = makeTable();
+
+inline quint16 ccitt(const uchar *data, std::size_t length, quint16 crc = 0xFFFF)
+{
+    for (std::size_t i = 0; i < length; ++i) {
+        crc = quint16((crc << 8) ^ Table[((crc >> 8) ^ data[i]) & 0xFF]);
+    }
+    return crc;
+}
+
+} // namespace Crc16
+
+#endif // CRC16_H
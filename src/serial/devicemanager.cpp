@@ -0,0 +1,264 @@
+#include "devicemanager.h"
+#include "serialhandler.h"
+
+#include <QDebug>
+#include <utility>
+
+DeviceManager::DeviceManager(QObject *parent)
+    : QObject(parent)
+{
+    // The display timer moves to the ingest thread with its parent
+    m_ingestContext = new QObject;
+    m_ingest.displayTimer = new QTimer(m_ingestContext);
+    m_ingest.displayTimer->setSingleShot(true);
+    m_ingest.displayTimer->setInterval(ReadingBus::EveryFrame);
+    connect(m_ingest.displayTimer, &QTimer::timeout, m_ingestContext, [this]() {
+        forwardDisplayBatch();
+    });
+
+    m_ingestContext->moveToThread(&m_ingestThread);
+    connect(&m_ingestThread, &QThread::finished, m_ingestContext, &QObject::deleteLater);
+    m_ingestThread.setObjectName("DeviceIngest");
+    m_ingestThread.start();
+}
+
+DeviceManager::~DeviceManager()
+{
+    for (const auto &device : m_devices) {
+        stopDevice(*device);
+    }
+    m_ingestThread.quit();
+    m_ingestThread.wait();
+}
+
+QVariantList DeviceManager::devices() const
+{
+    QVariantList list;
+    list.reserve(qsizetype(m_devices.size()));
+    for (const auto &device : m_devices) {
+        QVariantMap map;
+        map["deviceId"] = device->id;
+        map["portName"] = device->portName;
+        map["connected"] = device->connected;
+        map["errorString"] = device->errorString;
+        const SerialWorker *worker = device->reader->worker();
+        map["protocolVersion"] = int(worker->protocol());
+        map["droppedFrameCount"] = qint64(worker->droppedFrameCount());
+        map["overflowCount"] = qint64(worker->overflowCount());
+        map["lostFrameCount"] = qint64(worker->lostFrameCount());
+        map["reorderedFrameCount"] = qint64(worker->reorderedFrameCount());
+        list.append(map);
+    }
+    return list;
+}
+
+void DeviceManager::setBaudRate(int baudRate)
+{
+    if (m_baudRate == baudRate) {
+        return;
+    }
+
+    m_baudRate = baudRate;
+    for (const auto &device : m_devices) {
+        device->reader->setBaudRate(baudRate);
+    }
+    emit baudRateChanged();
+}
+
+void DeviceManager::setReadingSink(ReadingSink sink)
+{
+    QMetaObject::invokeMethod(m_ingestContext, [this, sink = std::move(sink)]() {
+        m_ingest.sink = sink;
+    }, Qt::BlockingQueuedConnection);
+}
+
+bool DeviceManager::isPortOpen(const QString &portName) const
+{
+    const QString actualPortName = portName.split(" - ").first().trimmed();
+    for (const auto &device : m_devices) {
+        if (device->portName == actualPortName)
+            return true;
+    }
+    return false;
+}
+
+int DeviceManager::openDevice(const QString &portName, int deviceId)
+{
+    // Same "name - description" entries as SerialHandler.availablePorts
+    const QString actualPortName = portName.split(" - ").first().trimmed();
+
+    if (isPortOpen(actualPortName)) {
+        qWarning() << "DeviceManager:" << actualPortName << "is already open";
+        return -1;
+    }
+
+    QQmlEngine *engine = qmlEngine(this);
+    auto *serialHandler = engine ? engine->singletonInstance<SerialHandler*>("ZephyrSense", "SerialHandler") : nullptr;
+    if (serialHandler && serialHandler->isConnected() && serialHandler->currentPort() == actualPortName) {
+        qWarning() << "DeviceManager:" << actualPortName << "is open in SerialHandler";
+        return -1;
+    }
+
+    if (deviceId < 0) {
+        deviceId = nextFreeId();
+    } else if (deviceId < FirstDeviceId || findDevice(deviceId)) {
+        qWarning() << "DeviceManager: device id" << deviceId << "is not available";
+        return -1;
+    }
+
+    auto device = std::make_unique<Device>();
+    device->id = deviceId;
+    device->portName = actualPortName;
+    device->reader = std::make_unique<ReaderThread>(deviceId, QString("SerialReader-%1").arg(deviceId));
+
+    // Registered with the ingest thread before the port is opened, so the first
+    // wakeup finds it. Both sides look the device up again on delivery; it may be
+    // closed by then.
+    ReaderThread *reader = device->reader.get();
+    const SerialWorker *worker = reader->worker();
+    QMetaObject::invokeMethod(m_ingestContext, [this, deviceId, reader]() {
+        m_ingest.readers.insert(deviceId, reader);
+        m_ingest.counters.insert(deviceId, IngestState::Counters());
+    }, Qt::QueuedConnection);
+    connect(worker, &SerialWorker::readingsAvailable, m_ingestContext, [this, deviceId]() {
+        drainDevice(deviceId);
+    });
+    connect(worker, &SerialWorker::portOpened, this, [this, deviceId]() {
+        handleOpened(deviceId);
+    });
+    connect(worker, &SerialWorker::portClosed, this, [this, deviceId]() {
+        handleClosed(deviceId);
+    });
+    connect(worker, &SerialWorker::errorOccurred, this, [this, deviceId](const QString &message) {
+        handleError(deviceId, message);
+    });
+
+    reader->open(actualPortName, m_baudRate);
+
+    m_devices.push_back(std::move(device));
+    emit devicesChanged();
+    return deviceId;
+}
+
+void DeviceManager::closeDevice(int deviceId)
+{
+    for (auto it = m_devices.begin(); it != m_devices.end(); ++it) {
+        if ((*it)->id != deviceId)
+            continue;
+
+        stopDevice(**it);
+        m_devices.erase(it);
+        emit devicesChanged();
+        return;
+    }
+}
+
+void DeviceManager::closeAll()
+{
+    if (m_devices.empty()) {
+        return;
+    }
+
+    for (const auto &device : m_devices) {
+        stopDevice(*device);
+    }
+    m_devices.clear();
+    emit devicesChanged();
+}
+
+DeviceManager::Device *DeviceManager::findDevice(int deviceId) const
+{
+    for (const auto &device : m_devices) {
+        if (device->id == deviceId)
+            return device.get();
+    }
+    return nullptr;
+}
+
+int DeviceManager::nextFreeId() const
+{
+    int id = FirstDeviceId;
+    while (findDevice(id)) {
+        ++id;
+    }
+    return id;
+}
+
+void DeviceManager::drainDevice(int deviceId)
+{
+    ReaderThread *reader = m_ingest.readers.value(deviceId);
+    if (!reader) {
+        return;
+    }
+
+    // Storage gets the batch right away; display batches are merged across devices
+    const ReadingBatch batch = reader->drain();
+    if (!batch.isEmpty()) {
+        if (m_ingest.sink) {
+            m_ingest.sink(batch);
+        }
+        m_ingest.display.append(batch);
+        if (!m_ingest.displayTimer->isActive()) {
+            m_ingest.displayTimer->start();
+        }
+    }
+
+    // Counters only ever grow, so their sum changes whenever one of them does
+    const SerialWorker *worker = reader->worker();
+    const quint64 total = worker->droppedFrameCount() + worker->overflowCount()
+                          + worker->lostFrameCount() + worker->reorderedFrameCount();
+    IngestState::Counters &counters = m_ingest.counters[deviceId];
+    if (total != counters.total || worker->protocol() != counters.protocol) {
+        counters.total = total;
+        counters.protocol = worker->protocol();
+        QMetaObject::invokeMethod(this, &DeviceManager::devicesChanged, Qt::QueuedConnection);
+    }
+}
+
+void DeviceManager::forwardDisplayBatch()
+{
+    // Emitted on the ingest thread, delivered queued on the receivers' threads
+    emit readingsReceived(std::exchange(m_ingest.display, ReadingBatch()));
+}
+
+void DeviceManager::handleOpened(int deviceId)
+{
+    if (Device *device = findDevice(deviceId)) {
+        device->connected = true;
+        device->errorString.clear();
+        emit devicesChanged();
+    }
+}
+
+void DeviceManager::handleClosed(int deviceId)
+{
+    // Unplugged or failed to open; the entry stays until closeDevice()
+    Device *device = findDevice(deviceId);
+    if (device && device->connected) {
+        device->connected = false;
+        emit devicesChanged();
+    }
+}
+
+void DeviceManager::handleError(int deviceId, const QString &message)
+{
+    if (Device *device = findDevice(deviceId)) {
+        device->errorString = message;
+        emit errorOccurred(deviceId, message);
+        emit devicesChanged();
+    }
+}
+
+void DeviceManager::stopDevice(Device &device)
+{
+    // On the ingest thread, the queue's only consumer: store what is still queued
+    // and forget the device, so wakeups already on their way find nothing
+    QMetaObject::invokeMethod(m_ingestContext, [this, &device]() {
+        device.reader->close();
+        drainDevice(device.id);
+        m_ingest.readers.remove(device.id);
+        m_ingest.counters.remove(device.id);
+    }, Qt::BlockingQueuedConnection);
+
+    device.reader.reset();
+}
@@ -0,0 +1,114 @@
+#ifndef DEVICEMANAGER_H
+#define DEVICEMANAGER_H
+
+#include <QObject>
+#include <QQmlEngine>
+#include <QHash>
+#include <QThread>
+#include <QTimer>
+#include <QVariantList>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "readingbus.h"
+#include "readerthread.h"
+
+// Additional sensor boxes read concurrently next to SerialHandler's port.
+// Every device has its own ReaderThread and tags its readings with its device
+// id. All device queues are drained on one ingest thread, which hands every
+// batch straight to the reading sink (storage) and forwards them for display
+// at most once per frame. So the GUI thread receives at most one batch per
+// frame and does no storage work, however many ports are open.
+class DeviceManager : public QObject
+{
+    Q_OBJECT
+    QML_ELEMENT
+    QML_SINGLETON
+
+    // One map per device: deviceId, portName, connected, errorString,
+    // protocolVersion, droppedFrameCount, overflowCount, lostFrameCount,
+    // reorderedFrameCount
+    Q_PROPERTY(QVariantList devices READ devices NOTIFY devicesChanged)
+    Q_PROPERTY(int deviceCount READ deviceCount NOTIFY devicesChanged)
+    // Applies to devices opened afterwards and to the open ones
+    Q_PROPERTY(int baudRate READ baudRate WRITE setBaudRate NOTIFY baudRateChanged)
+
+public:
+    // Device 0 is SerialHandler's port
+    static constexpr int FirstDeviceId = 1;
+
+    // Called on the ingest thread with every drained batch
+    using ReadingSink = std::function<void(const ReadingBatch &)>;
+
+    explicit DeviceManager(QObject *parent = nullptr);
+    ~DeviceManager();
+
+    QVariantList devices() const;
+    int deviceCount() const { return int(m_devices.size()); }
+    int baudRate() const { return m_baudRate; }
+    void setBaudRate(int baudRate);
+
+    // Set before opening devices. The sink must be safe to call from another
+    // thread and must outlive every open device.
+    void setReadingSink(ReadingSink sink);
+
+    // Whether a device holds the port, given as a name or a "name - description" entry
+    bool isPortOpen(const QString &portName) const;
+
+    // Open a port on a new reader thread. deviceId -1 picks the lowest free
+    // id; returns the device id, or -1 if the port or id is already in use.
+    Q_INVOKABLE int openDevice(const QString &portName, int deviceId = -1);
+    Q_INVOKABLE void closeDevice(int deviceId);
+    Q_INVOKABLE void closeAll();
+
+signals:
+    // For display: every device's readings since the last emission, at most once per frame
+    void readingsReceived(const ReadingBatch &readings);
+    void devicesChanged();
+    void baudRateChanged();
+    void errorOccurred(int deviceId, const QString &message);
+
+private:
+    struct Device {
+        int id;
+        QString portName;
+        std::unique_ptr<ReaderThread> reader;
+        bool connected = false;
+        QString errorString;
+    };
+
+    // Owned by the ingest thread; only touched from there
+    struct IngestState {
+        struct Counters {
+            quint64 total = 0;
+            FrameDecoder::Protocol protocol = FrameDecoder::UnknownProtocol;
+        };
+
+        ReadingSink sink;
+        QHash<int, ReaderThread *> readers;
+        QHash<int, Counters> counters;
+        ReadingBatch display;
+        QTimer *displayTimer = nullptr;
+    };
+
+    Device *findDevice(int deviceId) const;
+    int nextFreeId() const;
+    void handleOpened(int deviceId);
+    void handleClosed(int deviceId);
+    void handleError(int deviceId, const QString &message);
+    void stopDevice(Device &device);
+
+    // Ingest thread
+    void drainDevice(int deviceId);
+    void forwardDisplayBatch();
+
+    std::vector<std::unique_ptr<Device>> m_devices;
+    int m_baudRate = 115200;
+
+    QThread m_ingestThread;
+    QObject *m_ingestContext = nullptr;
+    IngestState m_ingest;
+};
+
+#endif // DEVICEMANAGER_H
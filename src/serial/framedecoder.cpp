@@ -0,0 +1,166 @@
+#include "framedecoder.h"
+#include "crc16.h"
+
+#include <algorithm>
+
+FrameDecoder::FrameDecoder()
+    : m_data(new char[Capacity])
+{
+}
+
+qsizetype FrameDecoder::writableSize() const
+{
+    // Free space, limited to the stretch before the physical end of the buffer
+    const qsizetype free = Capacity - size();
+    const qsizetype untilWrap = Capacity - static_cast<qsizetype>(m_tail & Mask);
+    return std::min(free, untilWrap);
+}
+
+void FrameDecoder::commit(qsizetype bytes)
+{
+    Q_ASSERT(bytes >= 0 && bytes <= writableSize());
+    m_tail += bytes;
+}
+
+void FrameDecoder::clear()
+{
+    m_head = 0;
+    m_tail = 0;
+    m_protocol = UnknownProtocol;
+    m_hasSequence = false;
+}
+
+FrameDecoder::Result FrameDecoder::next(SensorDataRaw &raw)
+{
+    while (size() > 0) {
+        const qsizetype start = frameStart();
+        if (start == -1) {
+            // Nothing can start a frame, discard all data
+            discard(size());
+            break;
+        }
+        discard(start);
+
+        const Result result = static_cast<uchar>(at(0)) == SyncByte1 ? nextV2(raw) : nextLegacy(raw);
+        if (result != InvalidFrame) {
+            return result;
+        }
+
+        // Skip this start byte only, so a real frame starting inside it is not lost
+        ++m_invalidFrames;
+        discard(1);
+    }
+
+    return NeedMoreData;
+}
+
+FrameDecoder::Result FrameDecoder::nextLegacy(SensorDataRaw &raw)
+{
+    if (size() < FrameSize) {
+        return NeedMoreData;
+    }
+
+    // The end delimiter sits at a fixed offset; anything else is corruption
+    if (at(FrameSize - 1) != '>') {
+        return InvalidFrame;
+    }
+
+    copyOut(1, &raw, DataSize);
+    discard(FrameSize);
+    m_protocol = LegacyProtocol;
+    return FrameDecoded;
+}
+
+FrameDecoder::Result FrameDecoder::nextV2(SensorDataRaw &raw)
+{
+    if (size() < V2HeaderSize) {
+        // Reject a wrong second sync byte without waiting for the full header
+        return size() >= 2 && static_cast<uchar>(at(1)) != SyncByte2 ? InvalidFrame : NeedMoreData;
+    }
+
+    const uchar version = static_cast<uchar>(at(2));
+    const qsizetype length = static_cast<uchar>(at(3));
+    if (static_cast<uchar>(at(1)) != SyncByte2 || version != Version2
+        || length < DataSize || length > V2MaxPayloadSize) {
+        return InvalidFrame;
+    }
+
+    const qsizetype total = V2HeaderSize + length + V2CrcSize;
+    if (size() < total) {
+        return NeedMoreData;
+    }
+
+    uchar frame[V2MaxFrameSize];
+    copyOut(0, frame, total);
+    const quint16 crc = quint16(frame[total - 2] | (frame[total - 1] << 8));
+    if (Crc16::ccitt(frame + 2, std::size_t(total - 2 - V2CrcSize)) != crc) {
+        return InvalidFrame;
+    }
+
+    std::memcpy(&raw, frame + V2HeaderSize, DataSize);
+    discard(total);
+    m_protocol = V2Protocol;
+    trackSequence(quint16(frame[4] | (frame[5] << 8)));
+    return FrameDecoded;
+}
+
+void FrameDecoder::trackSequence(quint16 seq)
+{
+    if (!m_hasSequence) {
+        m_hasSequence = true;
+        m_lastSequence = seq;
+        return;
+    }
+
+    // Forward distance modulo 2^16; the upper half counts as going backwards
+    const quint16 delta = quint16(seq - m_lastSequence);
+    if (delta == 0 || delta >= 0x8000) {
+        ++m_reorderedFrames;
+        return;
+    }
+
+    m_lostFrames += delta - 1;
+    m_lastSequence = seq;
+}
+
+qsizetype FrameDecoder::indexOf(char c, qsizetype limit) const
+{
+    // Buffered bytes occupy at most two contiguous segments
+    const qsizetype begin = static_cast<qsizetype>(m_head & Mask);
+    const qsizetype total = limit < 0 ? size() : std::min(limit, size());
+    const qsizetype first = std::min(total, Capacity - begin);
+
+    if (const void *hit = std::memchr(m_data.get() + begin, c, first)) {
+        return static_cast<const char *>(hit) - (m_data.get() + begin);
+    }
+    if (first < total) {
+        if (const void *hit = std::memchr(m_data.get(), c, total - first)) {
+            return first + (static_cast<const char *>(hit) - m_data.get());
+        }
+    }
+    return -1;
+}
+
+qsizetype FrameDecoder::frameStart() const
+{
+    // Once v2 is detected, '<' is just payload
+    if (m_protocol == V2Protocol) {
+        return indexOf(static_cast<char>(SyncByte1));
+    }
+
+    // Earliest of either start byte; the second scan stops where the first hit
+    const qsizetype legacyStart = indexOf('<');
+    const qsizetype v2Start = indexOf(static_cast<char>(SyncByte1), legacyStart);
+    return v2Start != -1 ? v2Start : legacyStart;
+}
+
+void FrameDecoder::copyOut(qsizetype offset, void *dest, qsizetype length) const
+{
+    const qsizetype begin = static_cast<qsizetype>((m_head + offset) & Mask);
+    const qsizetype first = std::min(length, Capacity - begin);
+
+    std::memcpy(dest, m_data.get() + begin, first);
+    if (first < length) {
+        std::memcpy(static_cast<char *>(dest) + first, m_data.get(), length - first);
+    }
+}
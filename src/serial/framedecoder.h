@@ -0,0 +1,120 @@
+#ifndef FRAMEDECODER_H
+#define FRAMEDECODER_H
+
+#include <QtGlobal>
+#include <cstring>
+#include <memory>
+
+#include "sensorreading.h"
+
+// Fixed-capacity ring buffer that decodes sensor frames in place.
+// The serial port reads straight into the free region returned by writePointer(),
+// so there is no per-read or per-frame heap allocation and no buffer shifting.
+//
+// Two wire formats are recognized:
+//   legacy: '<' + SensorDataRaw + '>'
+//   v2:     0xA5 0x5A, version (2), payload length, sequence (u16 LE),
+//           payload, CRC-16/CCITT-FALSE (u16 LE) over version..payload
+// The payload starts with SensorDataRaw; a longer payload from newer firmware
+// is accepted and its extra bytes ignored. Both formats are tried until the
+// first v2 frame passes its CRC. From then on only v2 is accepted, since the
+// legacy delimiters can occur inside any payload.
+class FrameDecoder
+{
+public:
+    static constexpr qsizetype Capacity = 64 * 1024;        // Must be a power of two
+    static constexpr qsizetype DataSize = sizeof(SensorDataRaw);  // 42 bytes
+    static constexpr qsizetype FrameSize = DataSize + 2;          // 44 bytes with delimiters
+
+    static constexpr uchar SyncByte1 = 0xA5;
+    static constexpr uchar SyncByte2 = 0x5A;
+    static constexpr uchar Version2 = 2;
+    static constexpr qsizetype V2HeaderSize = 6;
+    static constexpr qsizetype V2CrcSize = 2;
+    static constexpr qsizetype V2MaxPayloadSize = 128;
+    static constexpr qsizetype V2MaxFrameSize = V2HeaderSize + V2MaxPayloadSize + V2CrcSize;
+
+    enum Protocol {
+        UnknownProtocol = 0,
+        LegacyProtocol = 1,
+        V2Protocol = 2
+    };
+
+    FrameDecoder();
+
+    // Contiguous free region at the write position
+    char *writePointer() { return m_data.get() + (m_tail & Mask); }
+    qsizetype writableSize() const;
+    void commit(qsizetype bytes);
+
+    qsizetype size() const { return static_cast<qsizetype>(m_tail - m_head); }
+    // Drop buffered bytes and start protocol detection and sequence tracking over
+    void clear();
+
+    // Format of the last decoded frame
+    Protocol protocol() const { return m_protocol; }
+
+    // Frames rejected for a misplaced end delimiter, a bad v2 header or a CRC mismatch
+    quint64 invalidFrames() const { return m_invalidFrames; }
+    // v2 only: frames missing from sequence gaps, and frames whose sequence did
+    // not advance (late or duplicated)
+    quint64 lostFrames() const { return m_lostFrames; }
+    quint64 reorderedFrames() const { return m_reorderedFrames; }
+
+    // Decode all complete frames, calling sink(const SensorDataRaw &) for each.
+    // Bytes that cannot start a frame are dropped; a partial frame stays buffered.
+    template <typename Sink>
+    int decode(Sink &&sink);
+
+private:
+    static constexpr qsizetype Mask = Capacity - 1;
+    static_assert((Capacity & Mask) == 0, "Capacity must be a power of two");
+    static_assert(Capacity > V2MaxFrameSize, "Capacity must hold at least one frame");
+    static_assert(V2MaxPayloadSize <= 255, "v2 payload length is one byte");
+
+    enum Result {
+        NeedMoreData,
+        InvalidFrame,
+        FrameDecoded
+    };
+
+    // Next frame into raw, skipping over corruption
+    Result next(SensorDataRaw &raw);
+    Result nextLegacy(SensorDataRaw &raw);
+    Result nextV2(SensorDataRaw &raw);
+    void trackSequence(quint16 seq);
+
+    char at(qsizetype offset) const { return m_data[(m_head + offset) & Mask]; }
+    // First occurrence of c within the first limit buffered bytes (all when negative)
+    qsizetype indexOf(char c, qsizetype limit = -1) const;
+    qsizetype frameStart() const;
+    void copyOut(qsizetype offset, void *dest, qsizetype length) const;
+    void discard(qsizetype bytes) { m_head += bytes; }
+
+    std::unique_ptr<char[]> m_data;
+    quint64 m_head = 0;  // Monotonic read position
+    quint64 m_tail = 0;  // Monotonic write position
+    quint64 m_invalidFrames = 0;
+
+    Protocol m_protocol = UnknownProtocol;
+    bool m_hasSequence = false;
+    quint16 m_lastSequence = 0;
+    quint64 m_lostFrames = 0;
+    quint64 m_reorderedFrames = 0;
+};
+
+template <typename Sink>
+int FrameDecoder::decode(Sink &&sink)
+{
+    int frames = 0;
+
+    SensorDataRaw raw;
+    while (next(raw) == FrameDecoded) {
+        sink(raw);
+        ++frames;
+    }
+
+    return frames;
+}
+
+#endif // FRAMEDECODER_H
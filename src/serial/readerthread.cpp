@@ -0,0 +1,53 @@
+#include "readerthread.h"
+
+#include <QThread>
+
+ReaderThread::ReaderThread(int deviceId, const QString &threadName)
+    : m_queue(std::make_unique<SerialWorker::ReadingQueue>())
+    , m_thread(new QThread)
+    , m_worker(new SerialWorker(m_queue.get(), deviceId))
+{
+    m_thread->setObjectName(threadName);
+    m_worker->moveToThread(m_thread);
+    QObject::connect(m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+    m_thread->start();
+}
+
+ReaderThread::~ReaderThread()
+{
+    m_thread->quit();
+    m_thread->wait();
+    delete m_thread;  // The worker was deleted on its own thread via QThread::finished
+}
+
+void ReaderThread::open(const QString &portName, int baudRate)
+{
+    QMetaObject::invokeMethod(m_worker, [worker = m_worker, portName, baudRate]() {
+        worker->openPort(portName, baudRate);
+    }, Qt::QueuedConnection);
+}
+
+void ReaderThread::setBaudRate(int baudRate)
+{
+    QMetaObject::invokeMethod(m_worker, [worker = m_worker, baudRate]() {
+        worker->setBaudRate(baudRate);
+    }, Qt::QueuedConnection);
+}
+
+void ReaderThread::close()
+{
+    QMetaObject::invokeMethod(m_worker, &SerialWorker::closePort, Qt::BlockingQueuedConnection);
+}
+
+ReadingBatch ReaderThread::drain()
+{
+    // Re-arm the notification first so readings pushed while draining are not missed
+    m_worker->acknowledgeReadings();
+
+    ReadingBatch batch;
+    SensorReading reading;
+    while (m_queue->pop(reading)) {
+        batch.append(reading);
+    }
+    return batch;
+}
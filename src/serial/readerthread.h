@@ -0,0 +1,44 @@
+#ifndef READERTHREAD_H
+#define READERTHREAD_H
+
+#include <QString>
+#include <memory>
+
+#include "readingbus.h"
+#include "serialworker.h"
+
+class QThread;
+
+// One serial port on its own thread: a SerialWorker, the SPSC queue it fills
+// and the QThread it runs on. Used by SerialHandler's threaded mode and by
+// every DeviceManager device. The queue has a single consumer, so drain() must
+// always be called from the same thread.
+class ReaderThread
+{
+public:
+    ReaderThread(int deviceId, const QString &threadName);
+    // Stops the thread; close() and drain() first to keep what is still queued
+    ~ReaderThread();
+
+    ReaderThread(const ReaderThread &) = delete;
+    ReaderThread &operator=(const ReaderThread &) = delete;
+
+    // Lives on the reader thread; connect to its signals before open()
+    SerialWorker *worker() const { return m_worker; }
+
+    // Queued to the reader thread
+    void open(const QString &portName, int baudRate);
+    void setBaudRate(int baudRate);
+    // Blocks until the port is closed; nothing is pushed afterwards
+    void close();
+
+    // Everything queued so far, oldest first
+    ReadingBatch drain();
+
+private:
+    std::unique_ptr<SerialWorker::ReadingQueue> m_queue;
+    QThread *m_thread;
+    SerialWorker *m_worker;
+};
+
+#endif // READERTHREAD_H
@@ -1,7 +1,7 @@
 #include "serialhandler.h"
+#include "devicemanager.h"
 
 #include <QDebug>
-#include <cstring>
 
 SerialHandler::SerialHandler(QObject *parent)
     : QObject(parent)
@@ -17,6 +17,7 @@ SerialHandler::SerialHandler(QObject *parent)
 
 SerialHandler::~SerialHandler()
 {
+    stopWorker();
     if (m_serial->isOpen()) {
         m_serial->close();
     }
@@ -29,7 +30,7 @@ QStringList SerialHandler::availablePorts() const
 
 bool SerialHandler::isConnected() const
 {
-    return m_serial->isOpen();
+    return m_threaded ? m_workerConnected : m_serial->isOpen();
 }
 
 QString SerialHandler::errorString() const
@@ -39,7 +40,7 @@ QString SerialHandler::errorString() const
 
 QString SerialHandler::currentPort() const
 {
-    return m_serial->portName();
+    return m_threaded ? m_workerPortName : m_serial->portName();
 }
 
 int SerialHandler::baudRate() const
@@ -55,10 +56,37 @@ void SerialHandler::setBaudRate(int baudRate)
         if (m_serial->isOpen()) {
             m_serial->setBaudRate(m_baudRate);
         }
+        if (m_reader) {
+            m_reader->setBaudRate(baudRate);
+        }
         emit baudRateChanged();
     }
 }
 
+void SerialHandler::setThreaded(bool threaded)
+{
+    if (m_threaded == threaded) {
+        return;
+    }
+
+    // Reopen the current port on the other path if connected
+    const bool wasConnected = isConnected();
+    const QString portName = currentPort();
+    if (wasConnected) {
+        closePort();
+    }
+
+    m_threaded = threaded;
+    if (!m_threaded) {
+        stopWorker();
+    }
+    emit threadedChanged();
+
+    if (wasConnected) {
+        openPort(portName);
+    }
+}
+
 void SerialHandler::refreshPorts()
 {
     m_ports.clear();
@@ -75,13 +103,29 @@ void SerialHandler::refreshPorts()
 
 void SerialHandler::openPort(const QString &portName)
 {
+    // Parse port name (take first word before " - ")
+    QString actualPortName = portName.split(" - ").first().trimmed();
+
+    // An additional device may already be reading it; keep the current port then
+    QQmlEngine *engine = qmlEngine(this);
+    auto *deviceManager = engine ? engine->singletonInstance<DeviceManager*>("ZephyrSense", "DeviceManager") : nullptr;
+    if (deviceManager && deviceManager->isPortOpen(actualPortName)) {
+        m_errorString = QString("%1 is already open as an additional device").arg(actualPortName);
+        qWarning() << "SerialHandler:" << m_errorString;
+        emit errorOccurred(m_errorString);
+        return;
+    }
+
     // Close if already open
     if (m_serial->isOpen()) {
         m_serial->close();
     }
 
-    // Parse port name (take first word before " - ")
-    QString actualPortName = portName.split(" - ").first().trimmed();
+    if (m_threaded) {
+        startWorker();
+        m_reader->open(actualPortName, m_baudRate);
+        return;
+    }
 
     m_serial->setPortName(actualPortName);
     m_serial->setBaudRate(m_baudRate);
@@ -91,8 +135,9 @@ void SerialHandler::openPort(const QString &portName)
     m_serial->setFlowControl(QSerialPort::NoFlowControl);
 
     if (m_serial->open(QIODevice::ReadOnly)) {
-        m_buffer.clear();
+        m_decoder.clear();
         m_errorString.clear();
+        updateCounters();
         qDebug() << "Serial port opened:" << actualPortName << "at" << m_baudRate << "baud";
         emit connectionStateChanged(true);
     } else {
@@ -104,9 +149,18 @@ void SerialHandler::openPort(const QString &portName)
 
 void SerialHandler::closePort()
 {
+    if (m_threaded) {
+        if (m_reader) {
+            // Blocking so a following openPort() sees the port closed
+            m_reader->close();
+        }
+        return;
+    }
+
     if (m_serial->isOpen()) {
         m_serial->close();
-        m_buffer.clear();
+        m_decoder.clear();
+        updateCounters();
         qDebug() << "Serial port closed";
         emit connectionStateChanged(false);
     }
@@ -114,54 +168,33 @@ void SerialHandler::closePort()
 
 void SerialHandler::handleReadyRead()
 {
-    // Append incoming data to buffer
-    m_buffer.append(m_serial->readAll());
-
-    // Frame detection state machine
-    // Protocol: '<' + 42 bytes data + '>' = 44 bytes total
-    constexpr int DATA_SIZE = sizeof(SensorDataRaw);  // 42 bytes
-    constexpr int FRAME_SIZE = DATA_SIZE + 2;         // 44 bytes with delimiters
-
-    while (true) {
-        // Find start delimiter '<'
-        int startIdx = m_buffer.indexOf('<');
-        if (startIdx == -1) {
-            // No start delimiter found, discard all data
-            m_buffer.clear();
-            return;
-        }
-
-        // Discard bytes before start delimiter
-        if (startIdx > 0) {
-            m_buffer.remove(0, startIdx);
-        }
-
-        // Check if we have enough data for a complete frame
-        if (m_buffer.size() < FRAME_SIZE) {
-            return;  // Wait for more data
-        }
-
-        // Find end delimiter '>' (search after position 1)
-        int endIdx = m_buffer.indexOf('>', 1);
-        if (endIdx == -1) {
-            // No end delimiter yet, wait for more data
-            return;
-        }
-
-        // Check if we found a valid frame (exactly DATA_SIZE bytes between delimiters)
-        int frameSize = endIdx - 1;  // Bytes between '<' and '>'
-        if (frameSize == DATA_SIZE) {
-            // Extract frame (excluding delimiters)
-            QByteArray frame = m_buffer.mid(1, DATA_SIZE);
-            parseFrame(frame);
-        } else {
-            // Invalid frame size - likely corruption
-            qWarning() << "Invalid frame size:" << frameSize << "bytes, expected" << DATA_SIZE;
+    // Read straight into the decoder's ring buffer and decode complete frames in place.
+    // Either frame format is accepted; see FrameDecoder
+    const quint64 invalidBefore = m_decoder.invalidFrames();
+
+    ReadingBatch readings;
+    while (m_serial->bytesAvailable() > 0) {
+        const qint64 bytesRead = m_serial->read(m_decoder.writePointer(), m_decoder.writableSize());
+        if (bytesRead <= 0) {
+            break;
         }
+        m_decoder.commit(bytesRead);
+        // Frames completed by the same read arrived together
+        const qint64 receivedMs = QDateTime::currentMSecsSinceEpoch();
+        m_decoder.decode([&readings, receivedMs](const SensorDataRaw &raw) {
+            readings.append(SensorReading(raw, receivedMs));
+        });
+    }
+    if (!readings.isEmpty()) {
+        emit readingsReceived(readings);
+    }
 
-        // Remove processed data from buffer (including delimiters)
-        m_buffer.remove(0, endIdx + 1);
+    const quint64 invalidFrames = m_decoder.invalidFrames() - invalidBefore;
+    if (invalidFrames > 0) {
+        // Bad delimiter, header or CRC - likely corruption
+        qWarning() << "Discarded" << invalidFrames << "invalid frame(s)";
     }
+    updateCounters();
 }
 
 void SerialHandler::handleError(QSerialPort::SerialPortError error)
@@ -195,24 +228,104 @@ void SerialHandler::handleError(QSerialPort::SerialPortError error)
     emit errorOccurred(m_errorString);
 }
 
-void SerialHandler::parseFrame(const QByteArray &frame)
+void SerialHandler::startWorker()
 {
-    if (frame.size() != sizeof(SensorDataRaw)) {
-        qWarning() << "Invalid frame size:" << frame.size() << "expected:" << sizeof(SensorDataRaw);
+    if (m_reader) {
         return;
     }
 
-    // Copy binary data to packed struct
-    SensorDataRaw raw;
-    std::memcpy(&raw, frame.constData(), sizeof(SensorDataRaw));
+    m_reader = std::make_unique<ReaderThread>(0, "SerialReader");
+    const SerialWorker *worker = m_reader->worker();
+    connect(worker, &SerialWorker::readingsAvailable, this, &SerialHandler::drainReadings);
+    connect(worker, &SerialWorker::portOpened, this, &SerialHandler::handleWorkerOpened);
+    connect(worker, &SerialWorker::portClosed, this, &SerialHandler::handleWorkerClosed);
+    connect(worker, &SerialWorker::errorOccurred, this, &SerialHandler::handleWorkerError);
+}
 
-    // Create high-level reading with timestamp
-    SensorReading reading(raw);
+void SerialHandler::stopWorker()
+{
+    if (!m_reader) {
+        return;
+    }
 
-    qDebug() << "Parsed sensor reading - Temp:" << reading.temperature
-             << "Humidity:" << reading.humidity
-             << "Lat:" << reading.latitude
-             << "Lon:" << reading.longitude;
+    m_reader->close();
+    drainReadings();
+    const SerialWorker *worker = m_reader->worker();
+    m_workerOverflowBase += worker->overflowCount();
+    m_workerDroppedBase += worker->droppedFrameCount();
+    m_workerLostBase += worker->lostFrameCount();
+    m_workerReorderedBase += worker->reorderedFrameCount();
+
+    m_reader.reset();
+    // The worker's queued portClosed died with it; report the disconnect here
+    handleWorkerClosed();
+}
+
+void SerialHandler::drainReadings()
+{
+    if (!m_reader) {
+        return;
+    }
+
+    const ReadingBatch readings = m_reader->drain();
+    if (!readings.isEmpty()) {
+        emit readingsReceived(readings);
+    }
+
+    updateCounters();
+}
 
-    emit newReading(reading);
+void SerialHandler::handleWorkerOpened(const QString &portName)
+{
+    m_workerConnected = true;
+    m_workerPortName = portName;
+    m_errorString.clear();
+    updateCounters();
+    emit connectionStateChanged(true);
+}
+
+void SerialHandler::handleWorkerClosed()
+{
+    if (m_workerConnected) {
+        m_workerConnected = false;
+        updateCounters();
+        emit connectionStateChanged(false);
+    }
+}
+
+void SerialHandler::handleWorkerError(const QString &message)
+{
+    m_errorString = message;
+    emit errorOccurred(m_errorString);
+}
+
+void SerialHandler::updateCounters()
+{
+    // Cumulative across reader thread restarts
+    quint64 overflows = m_workerOverflowBase;
+    quint64 dropped = m_workerDroppedBase + m_decoder.invalidFrames();
+    quint64 lost = m_workerLostBase + m_decoder.lostFrames();
+    quint64 reordered = m_workerReorderedBase + m_decoder.reorderedFrames();
+    int protocol = m_decoder.protocol();
+    if (m_reader) {
+        const SerialWorker *worker = m_reader->worker();
+        overflows += worker->overflowCount();
+        dropped += worker->droppedFrameCount();
+        lost += worker->lostFrameCount();
+        reordered += worker->reorderedFrameCount();
+        protocol = worker->protocol();
+    }
+
+    if (static_cast<qint64>(overflows) != m_overflowCount
+        || static_cast<qint64>(dropped) != m_droppedFrameCount
+        || static_cast<qint64>(lost) != m_lostFrameCount
+        || static_cast<qint64>(reordered) != m_reorderedFrameCount
+        || protocol != m_protocolVersion) {
+        m_overflowCount = static_cast<qint64>(overflows);
+        m_droppedFrameCount = static_cast<qint64>(dropped);
+        m_lostFrameCount = static_cast<qint64>(lost);
+        m_reorderedFrameCount = static_cast<qint64>(reordered);
+        m_protocolVersion = protocol;
+        emit countersChanged();
+    }
 }
@@ -4,10 +4,12 @@
 #include <QObject>
 #include <QSerialPort>
 #include <QSerialPortInfo>
-#include <QByteArray>
 #include <QQmlEngine>
+#include <memory>
 
 #include "sensorreading.h"
+#include "framedecoder.h"
+#include "readerthread.h"
 
 class SerialHandler : public QObject
 {
@@ -21,6 +23,18 @@ class SerialHandler : public QObject
     Q_PROPERTY(QString currentPort READ currentPort NOTIFY connectionStateChanged)
     Q_PROPERTY(int baudRate READ baudRate WRITE setBaudRate NOTIFY baudRateChanged)
 
+    // Opt-in: run port I/O and frame decoding on a dedicated reader thread
+    Q_PROPERTY(bool threaded READ isThreaded WRITE setThreaded NOTIFY threadedChanged)
+    // Readings dropped because the reader -> GUI queue was full
+    Q_PROPERTY(qint64 overflowCount READ overflowCount NOTIFY countersChanged)
+    // Frames discarded by the decoder as corrupt
+    Q_PROPERTY(qint64 droppedFrameCount READ droppedFrameCount NOTIFY countersChanged)
+    // Frame format detected on the current port: FrameDecoder::Protocol (0 = not yet known)
+    Q_PROPERTY(int protocolVersion READ protocolVersion NOTIFY countersChanged)
+    // v2 frames missing from the sequence, and frames that arrived out of order or twice
+    Q_PROPERTY(qint64 lostFrameCount READ lostFrameCount NOTIFY countersChanged)
+    Q_PROPERTY(qint64 reorderedFrameCount READ reorderedFrameCount NOTIFY countersChanged)
+
 public:
     explicit SerialHandler(QObject *parent = nullptr);
     ~SerialHandler();
@@ -31,9 +45,16 @@ public:
     QString errorString() const;
     QString currentPort() const;
     int baudRate() const;
+    bool isThreaded() const { return m_threaded; }
+    qint64 overflowCount() const { return m_overflowCount; }
+    qint64 droppedFrameCount() const { return m_droppedFrameCount; }
+    int protocolVersion() const { return m_protocolVersion; }
+    qint64 lostFrameCount() const { return m_lostFrameCount; }
+    qint64 reorderedFrameCount() const { return m_reorderedFrameCount; }
 
-    // Property setter
+    // Property setters
     void setBaudRate(int baudRate);
+    void setThreaded(bool threaded);
 
     // QML invokable methods
     Q_INVOKABLE void openPort(const QString &portName);
@@ -41,24 +62,51 @@ public:
     Q_INVOKABLE void refreshPorts();
 
 signals:
-    void newReading(const SensorReading &reading);
+    // Once per serial read, or per queue drain in threaded mode
+    void readingsReceived(const ReadingBatch &readings);
     void connectionStateChanged(bool connected);
     void errorOccurred(const QString &message);
     void portsChanged();
     void baudRateChanged();
+    void threadedChanged();
+    void countersChanged();
 
 private slots:
     void handleReadyRead();
     void handleError(QSerialPort::SerialPortError error);
 
+    // Threaded mode: worker notifications (queued to this thread)
+    void drainReadings();
+    void handleWorkerOpened(const QString &portName);
+    void handleWorkerClosed();
+    void handleWorkerError(const QString &message);
+
 private:
-    void parseFrame(const QByteArray &frame);
+    void startWorker();
+    void stopWorker();
+    void updateCounters();
 
     QSerialPort *m_serial;
-    QByteArray m_buffer;
+    FrameDecoder m_decoder;
     QStringList m_ports;
     QString m_errorString;
     int m_baudRate = 115200;
+
+    // Threaded mode state
+    bool m_threaded = false;
+    std::unique_ptr<ReaderThread> m_reader;
+    bool m_workerConnected = false;
+    QString m_workerPortName;
+    quint64 m_workerOverflowBase = 0;
+    quint64 m_workerDroppedBase = 0;
+    quint64 m_workerLostBase = 0;
+    quint64 m_workerReorderedBase = 0;
+
+    qint64 m_overflowCount = 0;
+    qint64 m_droppedFrameCount = 0;
+    int m_protocolVersion = FrameDecoder::UnknownProtocol;
+    qint64 m_lostFrameCount = 0;
+    qint64 m_reorderedFrameCount = 0;
 };
 
 #endif // SERIALHANDLER_H
@@ -0,0 +1,144 @@
+#include "serialworker.h"
+
+#include <QDebug>
+
+SerialWorker::SerialWorker(ReadingQueue *queue, int deviceId, QObject *parent)
+    : QObject(parent)
+    , m_queue(queue)
+    , m_deviceId(deviceId)
+{
+}
+
+SerialWorker::~SerialWorker()
+{
+    if (m_serial && m_serial->isOpen()) {
+        m_serial->close();
+    }
+}
+
+void SerialWorker::openPort(const QString &portName, int baudRate)
+{
+    if (!m_serial) {
+        // Create the port here so it lives on the worker thread
+        m_serial = new QSerialPort(this);
+        connect(m_serial, &QSerialPort::readyRead, this, &SerialWorker::handleReadyRead);
+        connect(m_serial, &QSerialPort::errorOccurred, this, &SerialWorker::handleError);
+    }
+
+    // Close if already open
+    if (m_serial->isOpen()) {
+        m_serial->close();
+    }
+
+    m_serial->setPortName(portName);
+    m_serial->setBaudRate(baudRate);
+    m_serial->setDataBits(QSerialPort::Data8);
+    m_serial->setParity(QSerialPort::NoParity);
+    m_serial->setStopBits(QSerialPort::OneStop);
+    m_serial->setFlowControl(QSerialPort::NoFlowControl);
+
+    if (m_serial->open(QIODevice::ReadOnly)) {
+        m_decoder.clear();
+        qDebug() << "SerialWorker: port opened:" << portName << "at" << baudRate << "baud";
+        emit portOpened(portName);
+    } else {
+        QString error = m_serial->errorString();
+        qWarning() << "SerialWorker: failed to open serial port:" << error;
+        emit errorOccurred(error);
+    }
+}
+
+void SerialWorker::closePort()
+{
+    if (m_serial && m_serial->isOpen()) {
+        m_serial->close();
+        m_decoder.clear();
+        qDebug() << "SerialWorker: port closed";
+        emit portClosed();
+    }
+}
+
+void SerialWorker::setBaudRate(int baudRate)
+{
+    if (m_serial && m_serial->isOpen()) {
+        m_serial->setBaudRate(baudRate);
+    }
+}
+
+void SerialWorker::handleReadyRead()
+{
+    const quint64 invalidBefore = m_decoder.invalidFrames();
+    const quint64 lostBefore = m_decoder.lostFrames();
+    const quint64 reorderedBefore = m_decoder.reorderedFrames();
+
+    while (m_serial->bytesAvailable() > 0) {
+        const qint64 bytesRead = m_serial->read(m_decoder.writePointer(), m_decoder.writableSize());
+        if (bytesRead <= 0) {
+            break;
+        }
+        m_decoder.commit(bytesRead);
+        // Frames completed by the same read arrived together
+        const qint64 receivedMs = QDateTime::currentMSecsSinceEpoch();
+        m_decoder.decode([this, receivedMs](const SensorDataRaw &raw) {
+            enqueue(SensorReading(raw, receivedMs, m_deviceId));
+        });
+    }
+
+    const quint64 invalidFrames = m_decoder.invalidFrames() - invalidBefore;
+    if (invalidFrames > 0) {
+        m_droppedFrameCount.fetch_add(invalidFrames, std::memory_order_relaxed);
+    }
+    const quint64 lostFrames = m_decoder.lostFrames() - lostBefore;
+    if (lostFrames > 0) {
+        m_lostFrameCount.fetch_add(lostFrames, std::memory_order_relaxed);
+    }
+    const quint64 reorderedFrames = m_decoder.reorderedFrames() - reorderedBefore;
+    if (reorderedFrames > 0) {
+        m_reorderedFrameCount.fetch_add(reorderedFrames, std::memory_order_relaxed);
+    }
+    m_protocol.store(m_decoder.protocol(), std::memory_order_relaxed);
+}
+
+void SerialWorker::handleError(QSerialPort::SerialPortError error)
+{
+    if (error == QSerialPort::NoError) {
+        return;
+    }
+
+    QString message = m_serial->errorString();
+    qWarning() << "SerialWorker: serial port error:" << error << "-" << message;
+
+    // Handle critical errors that require closing the port
+    switch (error) {
+    case QSerialPort::ResourceError:
+        // Device disconnected
+        closePort();
+        break;
+    case QSerialPort::DeviceNotFoundError:
+    case QSerialPort::PermissionError:
+    case QSerialPort::OpenError:
+        // Port cannot be used
+        if (m_serial->isOpen()) {
+            m_serial->close();
+        }
+        emit portClosed();
+        break;
+    default:
+        break;
+    }
+
+    emit errorOccurred(message);
+}
+
+void SerialWorker::enqueue(const SensorReading &reading)
+{
+    if (!m_queue->push(reading)) {
+        // Consumer is not keeping up - drop the reading rather than block the port
+        m_overflowCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    if (!m_notifyPending.exchange(true, std::memory_order_acq_rel)) {
+        emit readingsAvailable();
+    }
+}
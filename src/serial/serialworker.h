@@ -0,0 +1,66 @@
+#ifndef SERIALWORKER_H
+#define SERIALWORKER_H
+
+#include <QObject>
+#include <QSerialPort>
+#include <atomic>
+
+#include "sensorreading.h"
+#include "framedecoder.h"
+#include "spscqueue.h"
+
+// Owns a serial port on a worker thread. Decoded readings are pushed into a
+// lock-free SPSC queue; readingsAvailable() is emitted once per empty -> non-empty
+// transition so the consumer thread is woken without one event per reading.
+class SerialWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    using ReadingQueue = SpscQueue<SensorReading, 4096>;
+
+    // Readings are tagged with deviceId
+    explicit SerialWorker(ReadingQueue *queue, int deviceId = 0, QObject *parent = nullptr);
+    ~SerialWorker();
+
+    // Thread-safe counters
+    quint64 overflowCount() const { return m_overflowCount.load(std::memory_order_relaxed); }
+    quint64 droppedFrameCount() const { return m_droppedFrameCount.load(std::memory_order_relaxed); }
+    quint64 lostFrameCount() const { return m_lostFrameCount.load(std::memory_order_relaxed); }
+    quint64 reorderedFrameCount() const { return m_reorderedFrameCount.load(std::memory_order_relaxed); }
+    FrameDecoder::Protocol protocol() const { return m_protocol.load(std::memory_order_relaxed); }
+
+    // Called by the consumer before it drains the queue
+    void acknowledgeReadings() { m_notifyPending.store(false, std::memory_order_release); }
+
+public slots:
+    void openPort(const QString &portName, int baudRate);
+    void closePort();
+    void setBaudRate(int baudRate);
+
+signals:
+    void readingsAvailable();
+    void portOpened(const QString &portName);
+    void portClosed();
+    void errorOccurred(const QString &message);
+
+private slots:
+    void handleReadyRead();
+    void handleError(QSerialPort::SerialPortError error);
+
+private:
+    void enqueue(const SensorReading &reading);
+
+    ReadingQueue *m_queue;
+    const int m_deviceId;
+    QSerialPort *m_serial = nullptr;  // Created lazily on the worker thread
+    FrameDecoder m_decoder;
+    std::atomic<bool> m_notifyPending{false};
+    std::atomic<quint64> m_overflowCount{0};
+    std::atomic<quint64> m_droppedFrameCount{0};
+    std::atomic<quint64> m_lostFrameCount{0};
+    std::atomic<quint64> m_reorderedFrameCount{0};
+    std::atomic<FrameDecoder::Protocol> m_protocol{FrameDecoder::UnknownProtocol};
+};
+
+#endif // SERIALWORKER_H